@@ -0,0 +1,174 @@
+#pragma once
+
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 基准测试的结果输出
+// - 默认输出可读的文本，每个结果一行：名称、参数、指标
+// - 命令行带 --json 时在标准输出打印 JSON，--json=<path> 写到文件，便于不同版本的结果比较：
+//   {"benchmark": "...", "unix_time": ..., "host": {"cpus": N, "kernel": "..."},
+//    "results": [{"name": "...", "params": {...}, "metrics": {...}}, ...]}
+// - 指标名带单位后缀（_ns、_us、_per_sec），数值越大越好还是越小越好由名称决定
+
+namespace bench
+{
+
+class Reporter
+{
+public:
+    class Row
+    {
+    public:
+        explicit Row(std::string name) : m_name(std::move(name)) {}
+
+        Row& param(const char* key, const std::string& value)
+        {
+            m_params.emplace_back(key, quote(value));
+            return *this;
+        }
+        Row& param(const char* key, const char* value) { return param(key, std::string(value)); }
+        Row& param(const char* key, long long value)
+        {
+            m_params.emplace_back(key, std::to_string(value));
+            return *this;
+        }
+        Row& param(const char* key, int value) { return param(key, static_cast<long long>(value)); }
+
+        Row& metric(const char* key, double value)
+        {
+            char buf[64];
+            if (!std::isfinite(value))
+                std::snprintf(buf, sizeof buf, "null");
+            else
+                std::snprintf(buf, sizeof buf, "%.6g", value);
+            m_metrics.emplace_back(key, buf);
+            return *this;
+        }
+
+    private:
+        friend class Reporter;
+        using Fields = std::vector<std::pair<std::string, std::string>>;
+
+        static std::string quote(const std::string& s)
+        {
+            std::string out = "\"";
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\') out += '\\';
+                if (static_cast<unsigned char>(c) >= 0x20) out += c;
+            }
+            return out + "\"";
+        }
+
+        std::string m_name;
+        Fields m_params;
+        Fields m_metrics;
+    };
+
+    Reporter(const char* benchmark, int argc, char** argv) : m_benchmark(benchmark), m_json(false)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--json") == 0)
+            {
+                m_json = true;
+            }
+            else if (std::strncmp(argv[i], "--json=", 7) == 0)
+            {
+                m_json = true;
+                m_path = argv[i] + 7;
+            }
+        }
+    }
+
+    ~Reporter() { finish(); }
+
+    Reporter(const Reporter&) = delete;
+    Reporter& operator=(const Reporter&) = delete;
+
+    bool json() const { return m_json; }
+
+    // 新增一行结果；文本模式下上一行此时输出，长时间运行的基准也能看到进度
+    Row& add(const std::string& name)
+    {
+        flushText();
+        m_rows.emplace_back(name);
+        return m_rows.back();
+    }
+
+    void finish()
+    {
+        if (m_finished) return;
+        m_finished = true;
+        if (!m_json)
+        {
+            flushText();
+            return;
+        }
+
+        FILE* out = m_path.empty() ? stdout : std::fopen(m_path.c_str(), "w");
+        if (out == nullptr)
+        {
+            std::perror(m_path.c_str());
+            return;
+        }
+        struct utsname uts;
+        ::uname(&uts);
+        std::fprintf(out, "{\n  \"benchmark\": %s,\n  \"unix_time\": %lld,\n", Row::quote(m_benchmark).c_str(),
+                     static_cast<long long>(std::time(nullptr)));
+        std::fprintf(out, "  \"host\": {\"cpus\": %ld, \"kernel\": %s},\n  \"results\": [",
+                     ::sysconf(_SC_NPROCESSORS_ONLN), Row::quote(uts.release).c_str());
+        for (size_t i = 0; i < m_rows.size(); ++i)
+        {
+            const Row& row = m_rows[i];
+            std::fprintf(out, "%s\n    {\"name\": %s, \"params\": {%s}, \"metrics\": {%s}}", i ? "," : "",
+                         Row::quote(row.m_name).c_str(), join(row.m_params, true).c_str(),
+                         join(row.m_metrics, true).c_str());
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+        if (out != stdout) std::fclose(out);
+    }
+
+private:
+    static std::string join(const Row::Fields& fields, bool json)
+    {
+        std::string out;
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (json)
+                out += (i ? ", " : "") + Row::quote(fields[i].first) + ": " + fields[i].second;
+            else
+                out += " " + fields[i].first + "=" + fields[i].second;
+        }
+        return out;
+    }
+
+    void flushText()
+    {
+        if (m_json) return;
+        for (; m_printed < m_rows.size(); ++m_printed)
+        {
+            const Row& row = m_rows[m_printed];
+            std::printf("%-20s%s |%s\n", row.m_name.c_str(), join(row.m_params, false).c_str(),
+                        join(row.m_metrics, false).c_str());
+            std::fflush(stdout);
+        }
+    }
+
+    std::string m_benchmark;
+    bool m_json;
+    bool m_finished = false;
+    std::string m_path;
+    std::deque<Row> m_rows; // add() 返回的引用在之后的 add() 中保持有效
+    size_t m_printed = 0;
+};
+
+}// namespace bench
@@ -0,0 +1,93 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthreadpool.h"
+#include "reactor/poller.h"
+#include "benchutil.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 控制线程把 K 条控制消息扇出到 L 个工作 Loop，比较：
+// - per-item    每条消息对每个 Loop 调用一次 runInLoop
+// - batch       broadcastBatch()：每个 Loop 一次 queueInLoopBatch
+// 每轮等所有 Loop 处理完（屏障）后再发下一轮，输出每轮耗时和每轮 Loop 被唤醒（poll 返回）的次数
+
+namespace
+{
+
+constexpr int kLoops = 4;
+constexpr int kRounds = 2000;
+
+uint64_t totalPolls(const std::vector<EventLoop*>& loops)
+{
+    // Poller 计数只在 Loop 线程写，在 Loop 线程中读取
+    std::atomic<uint64_t> sum(0);
+    std::atomic<int> remaining(static_cast<int>(loops.size()));
+    for (EventLoop* loop : loops)
+    {
+        loop->runInLoop([&sum, &remaining, loop] {
+            sum += loop->poller()->syscalls();
+            --remaining;
+        });
+    }
+    while (remaining.load() > 0) std::this_thread::yield();
+    return sum.load();
+}
+
+void runMode(bench::Reporter& report, const char* name, int items, bool batch)
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(kLoops);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    std::atomic<uint64_t> applied(0);
+    std::vector<SharedFunctor> tasks(static_cast<size_t>(items), [&applied] { applied.fetch_add(1, std::memory_order_relaxed); });
+
+    uint64_t pollsBefore = totalPolls(loops);
+    Clock::time_point begin = Clock::now();
+    for (int round = 0; round < kRounds; ++round)
+    {
+        if (batch)
+        {
+            pool.broadcastBatch(tasks);
+        }
+        else
+        {
+            for (const SharedFunctor& task : tasks)
+            {
+                for (EventLoop* loop : loops) loop->runInLoop(task);
+            }
+        }
+        pool.broadcastWithBarrier([] {})->wait();
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+    uint64_t polls = totalPolls(loops) - pollsBefore;
+
+    report.add(name)
+        .param("loops", kLoops)
+        .param("items", items)
+        .metric("round_us", us / kRounds)
+        .metric("loop_polls_per_round", static_cast<double>(polls) / kRounds)
+        .metric("applied", static_cast<double>(applied.load()));
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("broadcast", argc, argv);
+    const int itemCounts[] = {1, 16, 256};
+    for (int items : itemCounts)
+    {
+        runMode(report, "per_item", items, false);
+        runMode(report, "batch", items, true);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthread.h"
+#include "reactor/channel.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 两个线程各运行一个 EventLoop，通过 socketpair 来回传递1字节（ping-pong），
+// 客户端记录每个来回的延迟，比较：
+// - blocking       两端都阻塞在 epoll_wait
+// - spin server    只有服务端 Loop 忙轮询（EventLoopThreadPool 中只对部分 Loop 开启时的情形）
+// - spin both      两端都忙轮询
+// 输出 p50/p99/p99.9/max 往返延迟（微秒）
+// 注意：忙轮询的收益依赖每个 Loop 独占一个 CPU；CPU 少于2个时空转线程会互相抢占
+
+namespace
+{
+
+constexpr int kRoundTrips = 20000;
+constexpr int kWarmup = 1000;
+constexpr int64_t kBusyPollUs = 200;
+
+EventLoopOptions optionsFor(bool spin)
+{
+    EventLoopOptions options;
+    options.busyPollMicroseconds = spin ? kBusyPollUs : 0;
+    return options;
+}
+
+void runSync(EventLoop* loop, const std::function<void()>& fn)
+{
+    std::atomic<bool> done(false);
+    loop->runInLoop([&] { fn(); done.store(true); });
+    while (!done.load()) std::this_thread::yield();
+}
+
+void runMode(bench::Reporter& report, const char* name, bool spinServer, bool spinClient)
+{
+    int fds[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds);
+
+    // 服务端：收到什么写回什么
+    EventLoopThread serverThread(optionsFor(spinServer));
+    EventLoop* serverLoop = serverThread.startLoop();
+    std::unique_ptr<Channel> serverChannel;
+    runSync(serverLoop, [&] {
+        serverChannel = std::make_unique<Channel>(serverLoop, fds[1]);
+        serverChannel->setReadCallback([fd = fds[1]] {
+            char buf[64];
+            ssize_t n = ::read(fd, buf, sizeof buf);
+            if (n > 0) n = ::write(fd, buf, static_cast<size_t>(n));
+        });
+        serverChannel->enableReading();
+    });
+
+    // 客户端：在当前线程的 Loop 中发起下一个来回
+    EventLoop clientLoop(optionsFor(spinClient));
+    std::vector<int64_t> latencies;
+    latencies.reserve(kRoundTrips);
+    int round = 0;
+    Clock::time_point sentAt;
+    auto send = [&] {
+        sentAt = Clock::now();
+        ssize_t n = ::write(fds[0], "x", 1);
+        (void)n;
+    };
+    Channel clientChannel(&clientLoop, fds[0]);
+    clientChannel.setReadCallback([&] {
+        char buf[64];
+        if (::read(fds[0], buf, sizeof buf) <= 0) return;
+        if (round++ >= kWarmup)
+        {
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sentAt).count());
+        }
+        if (static_cast<int>(latencies.size()) == kRoundTrips)
+        {
+            clientLoop.quit();
+            return;
+        }
+        send();
+    });
+    clientChannel.enableReading();
+
+    Clock::time_point begin = Clock::now();
+    send();
+    clientLoop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    clientChannel.disableAll();
+    clientChannel.remove();
+    runSync(serverLoop, [&] {
+        serverChannel->disableAll();
+        serverChannel->remove();
+        serverChannel.reset();
+    });
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t idx = std::min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())));
+        return latencies[idx] / 1000.0;
+    };
+    report.add(name)
+        .param("busy_poll_us", static_cast<long long>(kBusyPollUs))
+        .metric("rtt_per_sec", (kRoundTrips + kWarmup) / seconds)
+        .metric("p50_us", percentile(0.50))
+        .metric("p99_us", percentile(0.99))
+        .metric("p999_us", percentile(0.999))
+        .metric("max_us", latencies.back() / 1000.0);
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("busypoll", argc, argv);
+    runMode(report, "blocking", false, false);
+    runMode(report, "spin_server", true, false);
+    runMode(report, "spin_both", true, true);
+    return 0;
+}
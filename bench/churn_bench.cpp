@@ -0,0 +1,176 @@
+#include "reactor/eventloop.h"
+#include "reactor/tcpserver.h"
+#include "reactor/tcpconnection.h"
+#include "reactor/inetaddress.h"
+#include "reactor/loopmetrics.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 高连接周转（短连接不断建立、关闭）下 Poller 的 Channel 登记开销：
+// - registry   只比较登记表本身：unordered_map<int, Channel*>（原实现的参照版本）与按 fd 下标的数组，
+//              模拟内核分配 fd 的方式（总是复用最小的空闲 fd），保持 live 个连接，每次关闭一个再建立一个
+// - tcp_churn  真实的 TcpServer：客户端线程按目标速率（默认 50k/s）connect 后立即 close，
+//              服务端 Loop 完成 accept、注册、读到 EOF、注销，统计实际达到的速率和服务端每轮循环耗时
+// 单 CPU 的机器上客户端和服务端抢同一个核，实际速率会低于目标速率
+
+namespace
+{
+
+constexpr int kRegistryOps = 1000000;
+constexpr int kTargetRate = 50000;
+constexpr int kClientThreads = 2;
+constexpr auto kChurnTime = std::chrono::milliseconds(1000);
+
+// 原实现：每次注册分配一个哈希表节点，断言也要查表
+class MapRegistry
+{
+public:
+    void add(int fd, void* channel) { m_channels[fd] = channel; }
+    void* find(int fd) const
+    {
+        auto it = m_channels.find(fd);
+        return it == m_channels.end() ? nullptr : it->second;
+    }
+    void remove(int fd) { m_channels.erase(fd); }
+
+private:
+    std::unordered_map<int, void*> m_channels;
+};
+
+// 和 EPollPoller 相同的按 fd 下标数组
+class TableRegistry
+{
+public:
+    TableRegistry() : m_channels(64, nullptr) {}
+    void add(int fd, void* channel)
+    {
+        const size_t slot = static_cast<size_t>(fd);
+        if (slot >= m_channels.size()) m_channels.resize(std::max(slot + 1, m_channels.size() * 2), nullptr);
+        m_channels[slot] = channel;
+    }
+    void* find(int fd) const
+    {
+        return static_cast<size_t>(fd) < m_channels.size() ? m_channels[static_cast<size_t>(fd)] : nullptr;
+    }
+    void remove(int fd) { m_channels[static_cast<size_t>(fd)] = nullptr; }
+
+private:
+    std::vector<void*> m_channels;
+};
+
+// 每次操作 = 关闭一个随机的活跃 fd（查表 + 注销）+ 新建连接复用该 fd（查表 + 注册）
+template<typename Registry>
+double registryNsPerOp(int live)
+{
+    Registry registry;
+    std::vector<int> fds(static_cast<size_t>(live));
+    for (int i = 0; i < live; ++i)
+    {
+        fds[i] = i + 3;
+        registry.add(fds[i], &fds[i]);
+    }
+
+    uint32_t seed = 12345;
+    uintptr_t sink = 0;
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < kRegistryOps; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        int& fd = fds[(seed >> 8) % static_cast<uint32_t>(live)];
+        sink += reinterpret_cast<uintptr_t>(registry.find(fd));
+        registry.remove(fd);
+        sink += reinterpret_cast<uintptr_t>(registry.find(fd));
+        registry.add(fd, &fd);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / kRegistryOps;
+    if (sink == 1) std::fprintf(stderr, "%lu\n", static_cast<unsigned long>(sink));
+    return ns;
+}
+
+void runChurn(bench::Reporter& report)
+{
+    EventLoopOptions options;
+    options.enableMetrics = true; // 输出每轮耗时
+    EventLoop loop(options);
+    TcpServer server(&loop, InetAddress(0, true), "churn");
+    std::atomic<long> accepted(0);
+    std::atomic<long> closed(0);
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+            accepted.fetch_add(1, std::memory_order_relaxed);
+        else
+            closed.fetch_add(1, std::memory_order_relaxed);
+    });
+    server.start();
+    const uint16_t port = server.listenAddress().port();
+
+    std::atomic<bool> stop(false);
+    std::atomic<long> failed(0);
+    std::vector<std::thread> clients;
+    for (int t = 0; t < kClientThreads; ++t)
+    {
+        clients.emplace_back([&] {
+            InetAddress serverAddr("127.0.0.1", port);
+            const auto interval = std::chrono::nanoseconds(1000000000LL * kClientThreads / kTargetRate);
+            Clock::time_point next = Clock::now();
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                if (::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) < 0)
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                ::close(fd);
+                next += interval;
+                if (next > Clock::now()) std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    Clock::time_point begin = Clock::now();
+    loop.runAfter(std::chrono::duration<double>(kChurnTime).count(), [&] {
+        stop.store(true);
+        for (auto& client : clients) client.join();
+        // 等服务端处理完已经关闭的连接
+        loop.runEvery(0.001, [&] {
+            if (closed.load() >= accepted.load()) loop.quit();
+        });
+    });
+    loop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    LoopMetricsSnapshot metrics = loop.metricsSnapshot();
+    report.add("tcp_churn")
+        .param("target_per_sec", kTargetRate)
+        .param("client_threads", kClientThreads)
+        .metric("accepted_per_sec", static_cast<double>(accepted.load()) / seconds)
+        .metric("closed_per_sec", static_cast<double>(closed.load()) / seconds)
+        .metric("connect_failures", static_cast<double>(failed.load()))
+        .metric("iteration_p50_ns", static_cast<double>(metrics.iterationNs.percentile(0.50)))
+        .metric("iteration_p99_ns", static_cast<double>(metrics.iterationNs.percentile(0.99)));
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("churn", argc, argv);
+    const int liveCounts[] = {100, 10000, 100000};
+    for (int live : liveCounts)
+    {
+        report.add("registry_map").param("live", live).metric("ns_per_op", registryNsPerOp<MapRegistry>(live));
+        report.add("registry_table").param("live", live).metric("ns_per_op", registryNsPerOp<TableRegistry>(live));
+    }
+    runChurn(report);
+    return 0;
+}
@@ -0,0 +1,311 @@
+#include "reactor/coroutine.h"
+#include "reactor/eventloop.h"
+#include "reactor/channel.h"
+#include "reactor/framepool.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 协程与回调两种写法在同一个 Loop 上的开销：
+// - pingpong: 多对 socketpair 来回传递1字节。callback 为 Channel 读回调；
+//             coroutine 为每端一个 Task 在 AsyncFd 上循环 co_await readable()
+// - request:  每个请求三个步骤（解析、处理、响应），每步之前经过一次 queueInLoop 调度，
+//             同时保持 kInFlight 个请求，一个完成后开始下一个。
+//             callback 为手写状态机：请求状态 make_shared，每步一个 std::function；
+//             coroutine 为 spawn 一个 Task，前两步各 co_await 一个子 Task
+// 输出每秒消息/请求数和平均每条消息/请求的堆分配次数（协程帧来自 FramePool）
+
+namespace
+{
+uint64_t g_allocs = 0;
+}
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    ++g_allocs;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+
+constexpr int kPairs = 16;
+constexpr long kMessagesPerPair = 20000;
+constexpr int kRequests = 200000;
+constexpr int kInFlight = 64;
+
+struct Result
+{
+    double perSecond;
+    double allocsPerOp;
+};
+
+// ---------------- pingpong ----------------
+
+class CallbackPair
+{
+public:
+    CallbackPair(EventLoop* loop, long* remaining) : m_loop(loop), m_remaining(remaining)
+    {
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, m_fds);
+        for (int i = 0; i < 2; ++i)
+        {
+            int fd = m_fds[i];
+            m_channels[i] = std::make_unique<Channel>(loop, fd);
+            m_channels[i]->setReadCallback([this, fd] { onReadable(fd); });
+            m_channels[i]->enableReading();
+        }
+    }
+
+    ~CallbackPair()
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            m_channels[i]->disableAll();
+            m_channels[i]->remove();
+            ::close(m_fds[i]);
+        }
+    }
+
+    void start() { (void)!::write(m_fds[0], "x", 1); }
+
+private:
+    void onReadable(int fd)
+    {
+        char c;
+        if (::read(fd, &c, 1) != 1) return;
+        if (--*m_remaining <= 0)
+        {
+            m_loop->quit();
+            return;
+        }
+        (void)!::write(fd, &c, 1);
+    }
+
+    EventLoop* m_loop;
+    long* m_remaining;
+    int m_fds[2];
+    std::unique_ptr<Channel> m_channels[2];
+};
+
+Task<> echoSide(EventLoop* loop, int fd, long* remaining)
+{
+    AsyncFd conn(loop, fd);
+    char c;
+    while (*remaining > 0)
+    {
+        co_await conn.readable();
+        if (::read(fd, &c, 1) != 1) continue;
+        if (--*remaining <= 0)
+        {
+            loop->quit();
+            break;
+        }
+        (void)!::write(fd, &c, 1);
+    }
+}
+
+Result runPingPongCallback()
+{
+    EventLoop loop;
+    long remaining = kPairs * kMessagesPerPair;
+    std::vector<std::unique_ptr<CallbackPair>> pairs;
+    for (int i = 0; i < kPairs; ++i)
+    {
+        pairs.push_back(std::make_unique<CallbackPair>(&loop, &remaining));
+    }
+    for (auto& pair : pairs) pair->start();
+
+    uint64_t allocs = g_allocs;
+    Clock::time_point begin = Clock::now();
+    loop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double messages = static_cast<double>(kPairs) * kMessagesPerPair;
+    return {messages / seconds, static_cast<double>(g_allocs - allocs) / messages};
+}
+
+Result runPingPongCoroutine()
+{
+    EventLoop loop;
+    long remaining = kPairs * kMessagesPerPair;
+    std::vector<int> fds;
+    for (int i = 0; i < kPairs; ++i)
+    {
+        int pair[2];
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pair);
+        fds.push_back(pair[0]);
+        fds.push_back(pair[1]);
+    }
+
+    uint64_t allocs = g_allocs;
+    Clock::time_point begin = Clock::now();
+    for (int fd : fds)
+    {
+        spawn(&loop, echoSide(&loop, fd, &remaining));
+    }
+    for (int i = 0; i < kPairs; ++i)
+    {
+        (void)!::write(fds[2 * i], "x", 1);
+    }
+    loop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double messages = static_cast<double>(kPairs) * kMessagesPerPair;
+    Result result{messages / seconds, static_cast<double>(g_allocs - allocs) / messages};
+    // 仍在等待的协程随 Loop 一起丢弃（见 coroutine.h 的约束），这里只关闭 fd
+    for (int fd : fds) ::close(fd);
+    return result;
+}
+
+// ---------------- request ----------------
+
+// 让出一次：在本轮 pending 任务阶段恢复
+class Yield
+{
+public:
+    explicit Yield(EventLoop* loop) : m_loop(loop) {}
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { m_loop->queueInLoop([h] { h.resume(); }); }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop* m_loop;
+};
+
+struct Driver
+{
+    EventLoop* loop;
+    void (*start)(Driver*, int id);
+    int started = 0;
+    int done = 0;
+
+    void finish()
+    {
+        if (++done == kRequests)
+            loop->quit();
+        else if (started < kRequests)
+            start(this, started++);
+    }
+};
+
+struct Request
+{
+    int id = 0;
+    int parsed = 0;
+    int computed = 0;
+    std::function<void()> next;
+};
+
+void callbackStep(Driver* driver, std::shared_ptr<Request> req, int step)
+{
+    switch (step)
+    {
+    case 0: break;
+    case 1: req->parsed = req->id + 1; break;
+    case 2: req->computed = req->parsed * 2; break;
+    default:
+        req->next = nullptr; // 打破 req 与 next 之间的循环引用
+        if (req->computed > 0) driver->finish();
+        return;
+    }
+    req->next = [driver, req, step] { callbackStep(driver, req, step + 1); };
+    driver->loop->queueInLoop([req] { req->next(); });
+}
+
+void startCallbackRequest(Driver* driver, int id)
+{
+    auto req = std::make_shared<Request>();
+    req->id = id;
+    callbackStep(driver, std::move(req), 0);
+}
+
+Task<int> parseStep(EventLoop* loop, int id)
+{
+    co_await Yield(loop);
+    co_return id + 1;
+}
+
+Task<int> computeStep(EventLoop* loop, int parsed)
+{
+    co_await Yield(loop);
+    co_return parsed * 2;
+}
+
+Task<> handleRequest(Driver* driver, int id)
+{
+    int parsed = co_await parseStep(driver->loop, id);
+    int computed = co_await computeStep(driver->loop, parsed);
+    co_await Yield(driver->loop);
+    if (computed > 0) driver->finish();
+}
+
+void startCoroutineRequest(Driver* driver, int id)
+{
+    spawn(driver->loop, handleRequest(driver, id));
+}
+
+Result runRequests(void (*start)(Driver*, int))
+{
+    EventLoop loop;
+    Driver driver{&loop, start};
+    uint64_t allocs = g_allocs;
+    Clock::time_point begin = Clock::now();
+    loop.queueInLoop([&driver] {
+        while (driver.started < kInFlight) driver.start(&driver, driver.started++);
+    });
+    loop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return {kRequests / seconds, static_cast<double>(g_allocs - allocs) / kRequests};
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("coroutine", argc, argv);
+
+    Result r = runPingPongCallback();
+    report.add("pingpong_callback")
+        .param("pairs", kPairs)
+        .metric("messages_per_sec", r.perSecond)
+        .metric("allocs_per_message", r.allocsPerOp);
+    r = runPingPongCoroutine();
+    report.add("pingpong_coroutine")
+        .param("pairs", kPairs)
+        .metric("messages_per_sec", r.perSecond)
+        .metric("allocs_per_message", r.allocsPerOp);
+
+    r = runRequests(startCallbackRequest);
+    report.add("request_callback")
+        .param("steps", 3)
+        .metric("requests_per_sec", r.perSecond)
+        .metric("allocs_per_request", r.allocsPerOp);
+    r = runRequests(startCoroutineRequest);
+    report.add("request_coroutine")
+        .param("steps", 3)
+        .metric("requests_per_sec", r.perSecond)
+        .metric("allocs_per_request", r.allocsPerOp);
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "reactor/eventloop.h"
+#include "reactor/channel.h"
+#include "reactor/poller.h"
+#include "reactor/iouringpoller.h"
+#include "benchutil.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// Poller::updateChannel / removeChannel 的开销（epoll 后端即 epoll_ctl 的次数和耗时）：
+// - modify     已注册的 Channel 反复打开/关闭写事件（EPOLL_CTL_MOD）
+// - add_remove 随机选择 Channel 注销后重新注册（EPOLL_CTL_DEL + EPOLL_CTL_ADD）
+// 注册的 Channel 数量不同，衡量 Poller 内部登记表随规模的变化
+// io_uring 后端的变化在下一次 poll 时批量提交，这里只统计 updateChannel 本身（不调用 poll）
+
+namespace
+{
+
+constexpr int kOps = 200000;
+
+struct Result
+{
+    double modifyNs;
+    double addRemoveNs;
+    double modifySyscalls;
+    double addRemoveSyscalls;
+};
+
+bool runOnce(PollerBackend backend, int channels, Result* result)
+{
+    EventLoopOptions options;
+    options.pollerBackend = backend;
+    EventLoop loop(options);
+    if (backend == PollerBackend::kIoUring && loop.ioUring() == nullptr) return false;
+
+    std::vector<int> fds(static_cast<size_t>(channels));
+    std::vector<std::unique_ptr<Channel>> list(static_cast<size_t>(channels));
+    for (int i = 0; i < channels; ++i)
+    {
+        fds[i] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        list[i] = std::make_unique<Channel>(&loop, fds[i]);
+        list[i]->enableReading();
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, channels - 1);
+    std::vector<int> order(kOps);
+    for (int& idx : order) idx = pick(rng);
+
+    uint64_t syscallsBefore = loop.poller()->syscalls();
+    Clock::time_point begin = Clock::now();
+    for (int idx : order)
+    {
+        Channel* channel = list[idx].get();
+        if (channel->isWriting())
+            channel->disableWriting();
+        else
+            channel->enableWriting();
+    }
+    Clock::time_point modified = Clock::now();
+    uint64_t syscallsModified = loop.poller()->syscalls();
+    for (int idx : order)
+    {
+        Channel* channel = list[idx].get();
+        channel->disableAll();
+        channel->remove();
+        channel->enableReading();
+    }
+    Clock::time_point end = Clock::now();
+    uint64_t syscallsEnd = loop.poller()->syscalls();
+
+    for (auto& channel : list)
+    {
+        channel->disableAll();
+        channel->remove();
+    }
+    for (int fd : fds) ::close(fd);
+
+    *result = Result{std::chrono::duration<double, std::nano>(modified - begin).count() / kOps,
+                  std::chrono::duration<double, std::nano>(end - modified).count() / kOps,
+                  static_cast<double>(syscallsModified - syscallsBefore) / kOps,
+                  static_cast<double>(syscallsEnd - syscallsModified) / kOps};
+    return true;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("epollctl", argc, argv);
+    const int channelCounts[] = {100, 1000, 10000};
+    const std::pair<const char*, PollerBackend> backends[] = {{"epoll", PollerBackend::kEpoll},
+                                                              {"io_uring", PollerBackend::kIoUring}};
+    for (int channels : channelCounts)
+    {
+        for (const auto& backend : backends)
+        {
+            Result r{};
+            bench::Reporter::Row& row = report.add(backend.first).param("channels", channels);
+            if (!runOnce(backend.second, channels, &r))
+            {
+                row.param("status", "unavailable");
+                continue;
+            }
+            row.metric("modify_ns", r.modifyNs)
+                .metric("add_remove_ns", r.addRemoveNs)
+                .metric("modify_syscalls", r.modifySyscalls)
+                .metric("add_remove_syscalls", r.addRemoveSyscalls);
+        }
+    }
+    return 0;
+}
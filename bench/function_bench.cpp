@@ -0,0 +1,101 @@
+#include "reactor/callbacks.h"
+#include "benchutil.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 比较 std::function<void()> 与 Functor（UniqueFunction<void()>）的投递/执行开销：
+// 模拟任务队列：构造回调并移动进预先分配的队列（post），再依次调用并销毁（dispatch）
+// 捕获大小分别为 8/24/48/96 字节，输出每个任务的耗时和堆分配次数
+
+namespace
+{
+uint64_t g_allocs = 0;
+}
+
+void* operator new(size_t size)
+{
+    ++g_allocs;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+
+constexpr int kBatch = 1024;
+constexpr int kRounds = 2000;
+
+template<size_t Bytes>
+struct Payload
+{
+    std::array<uint64_t, Bytes / 8> words{};
+};
+
+template<typename F, size_t Bytes>
+void run(bench::Reporter& report, const char* name, uint64_t* sink)
+{
+    std::vector<F> queue;
+    queue.reserve(kBatch);
+    Payload<Bytes> payload;
+    payload.words[0] = 1;
+
+    uint64_t allocsBefore = g_allocs;
+    Clock::time_point begin = Clock::now();
+    for (int round = 0; round < kRounds; ++round)
+    {
+        for (int i = 0; i < kBatch; ++i)
+        {
+            payload.words[0] = static_cast<uint64_t>(i);
+            queue.emplace_back([payload, sink] { *sink += payload.words[0]; });
+        }
+        for (F& fn : queue) fn();
+        queue.clear();
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    double ops = static_cast<double>(kBatch) * kRounds;
+    report.add(name)
+        .param("capture_bytes", static_cast<long long>(Bytes + sizeof(sink)))
+        .metric("task_ns", ns / ops)
+        .metric("allocs_per_task", static_cast<double>(g_allocs - allocsBefore) / ops);
+}
+
+template<size_t Bytes>
+void compare(bench::Reporter& report, uint64_t* sink)
+{
+    run<std::function<void()>, Bytes>(report, "std_function", sink);
+    run<Functor, Bytes>(report, "unique_function", sink);
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("function", argc, argv);
+    uint64_t sink = 0;
+    compare<8>(report, &sink);
+    compare<16>(report, &sink);
+    compare<40>(report, &sink);
+    compare<88>(report, &sink);
+    if (sink == 1) std::fprintf(stderr, "%llu\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthreadpool.h"
+#include "reactor/channel.h"
+#include "benchutil.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 负载不均的长连接场景下，比较 getNextLoop() 各策略的请求延迟：
+// - 会话逐个建立（每个会话在所属 Loop 上注册一个 Channel），已建立的会话持续产生请求
+// - 每4个会话中有1个是重会话（处理一次请求耗时是轻会话的20倍），轮询会把重会话全部分到同一个 Loop
+// - 请求通过 queueInLoop 投递，延迟 = 处理完成时间 - 投递时间
+// 输出 p50/p99/max 延迟（微秒）
+
+namespace
+{
+
+constexpr int kLoops = 4;
+constexpr int kSessions = 32;
+constexpr auto kSessionArrival = std::chrono::milliseconds(10); // 会话建立间隔
+constexpr auto kRequestInterval = std::chrono::milliseconds(5); // 每个会话的请求间隔
+constexpr auto kMeasureTime = std::chrono::milliseconds(1000);
+constexpr int64_t kLightCostNs = 10 * 1000;
+constexpr int64_t kHeavyCostNs = 200 * 1000;
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void spin(int64_t ns)
+{
+    int64_t end = nowNs() + ns;
+    while (nowNs() < end)
+    {
+    }
+}
+
+struct Session
+{
+    EventLoop* loop = nullptr;
+    int64_t costNs = 0;
+    int fd = -1;
+    std::unique_ptr<Channel> channel; // 只用于让 Loop 的 Channel 数反映会话数
+};
+
+// 每个 Loop 的延迟样本，只在该 Loop 线程写
+struct LoopSamples
+{
+    std::vector<int64_t> latencies;
+};
+
+void runSync(EventLoop* loop, const std::function<void()>& fn)
+{
+    std::atomic<bool> done(false);
+    loop->runInLoop([&] { fn(); done.store(true); });
+    while (!done.load()) std::this_thread::yield();
+}
+
+void runStrategy(bench::Reporter& report, const char* name, LoadBalance strategy)
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(kLoops);
+    pool.setLoadBalance(strategy);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    std::vector<LoopSamples> samples(loops.size());
+    for (auto& s : samples) s.latencies.reserve(1 << 16);
+
+    std::vector<Session> sessions(kSessions);
+    std::atomic<int> established(0);
+    std::atomic<bool> measuring(false);
+    std::atomic<bool> stop(false);
+
+    // 请求发生器：按固定间隔给每个已建立的会话投递请求
+    std::thread generator([&] {
+        Clock::time_point next = Clock::now();
+        while (!stop.load())
+        {
+            int count = established.load(std::memory_order_acquire);
+            for (int i = 0; i < count; ++i)
+            {
+                Session* session = &sessions[i];
+                size_t loopIndex = static_cast<size_t>(std::find(loops.begin(), loops.end(), session->loop) - loops.begin());
+                int64_t postedNs = nowNs();
+                bool record = measuring.load(std::memory_order_relaxed);
+                session->loop->queueInLoop([session, postedNs, record, &samples, loopIndex] {
+                    spin(session->costNs);
+                    if (record) samples[loopIndex].latencies.push_back(nowNs() - postedNs);
+                });
+            }
+            next += kRequestInterval;
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    // 会话逐个建立，策略可以看到已建立会话产生的负载
+    for (int i = 0; i < kSessions; ++i)
+    {
+        Session& session = sessions[i];
+        session.loop = pool.getNextLoop();
+        session.costNs = i % 4 == 0 ? kHeavyCostNs : kLightCostNs;
+        session.fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        runSync(session.loop, [&session] {
+            session.channel = std::make_unique<Channel>(session.loop, session.fd);
+            session.channel->enableReading();
+        });
+        established.store(i + 1, std::memory_order_release);
+        std::this_thread::sleep_for(kSessionArrival);
+    }
+
+    measuring.store(true);
+    std::this_thread::sleep_for(kMeasureTime);
+    measuring.store(false);
+    stop.store(true);
+    generator.join();
+
+    std::vector<int64_t> all;
+    std::vector<int> heavyPerLoop(loops.size(), 0);
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        runSync(loops[i], [] {}); // 等该 Loop 处理完剩余请求
+        all.insert(all.end(), samples[i].latencies.begin(), samples[i].latencies.end());
+    }
+    for (Session& session : sessions)
+    {
+        size_t loopIndex = static_cast<size_t>(std::find(loops.begin(), loops.end(), session.loop) - loops.begin());
+        if (session.costNs == kHeavyCostNs) ++heavyPerLoop[loopIndex];
+        runSync(session.loop, [&session] {
+            session.channel->disableAll();
+            session.channel->remove();
+            session.channel.reset();
+        });
+        ::close(session.fd);
+    }
+
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+        if (all.empty()) return 0.0;
+        size_t idx = std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())));
+        return all[idx] / 1000.0;
+    };
+
+    std::string placement;
+    for (size_t i = 0; i < heavyPerLoop.size(); ++i)
+    {
+        placement += (i ? "/" : "") + std::to_string(heavyPerLoop[i]);
+    }
+    report.add(name)
+        .param("heavy_per_loop", placement)
+        .metric("requests", static_cast<double>(all.size()))
+        .metric("p50_us", percentile(0.50))
+        .metric("p99_us", percentile(0.99))
+        .metric("max_us", all.empty() ? 0.0 : all.back() / 1000.0);
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("loadbalance", argc, argv);
+    runStrategy(report, "round_robin", LoadBalance::kRoundRobin);
+    runStrategy(report, "least_channels", LoadBalance::kLeastChannels);
+    runStrategy(report, "shortest_queue", LoadBalance::kShortestQueue);
+    runStrategy(report, "lowest_util", LoadBalance::kLowestUtilization);
+    runStrategy(report, "power_of_two", LoadBalance::kPowerOfTwoChoices);
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthread.h"
+#include "reactor/channel.h"
+#include "reactor/computepool.h"
+#include "reactor/histogram.h"
+#include "reactor/countdownlatch.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <thread>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// CPU/I-O 混合负载下 I/O Loop 的延迟：
+// 一个 Loop 服务两条 socketpair
+// - light: 客户端发1字节，Loop 立即回写，客户端记录往返时间（每 200us 一次）
+// - heavy: 客户端连续发请求，每个请求需要约 kHeavyWork 的 CPU 计算，算完回写
+// 对比 heavy 请求的三种处理方式：
+// - none:    没有 heavy 负载（基线）
+// - inline:  在 Loop 线程直接计算，期间 light 请求排队
+// - offload: EventLoop::offload 交给 ComputePool，结果经 queueInLoop 回到 Loop 再回写
+// 输出 light 请求往返时间的 p50/p99/max（微秒）和 heavy 请求的完成速率
+
+namespace
+{
+
+constexpr auto kHeavyWork = std::chrono::milliseconds(2);
+constexpr int kLightRequests = 3000;
+constexpr auto kLightInterval = std::chrono::microseconds(200);
+
+enum class Mode
+{
+    kNone,
+    kInline,
+    kOffload,
+};
+
+const char* modeName(Mode mode)
+{
+    switch (mode)
+    {
+    case Mode::kNone: return "none";
+    case Mode::kInline: return "inline";
+    default: return "offload";
+    }
+}
+
+int64_t threadCpuNs()
+{
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// 占用 d 的 CPU 时间（模拟压缩、解析、加解密）；按线程 CPU 时间计，被抢占的时间不算
+uint64_t burnCpu(std::chrono::nanoseconds d)
+{
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    const int64_t end = threadCpuNs() + d.count();
+    while (threadCpuNs() < end)
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+    }
+    return x;
+}
+
+// Loop 一侧：收到的每个字节都是一个请求
+class Server
+{
+public:
+    Server(EventLoop* loop, int fd, Mode heavyMode) : m_loop(loop), m_fd(fd), m_mode(heavyMode)
+    {
+        m_channel = std::make_unique<Channel>(loop, fd);
+        m_channel->setReadCallback([this] { onReadable(); });
+        m_channel->enableReading();
+    }
+
+    ~Server()
+    {
+        m_channel->disableAll();
+        m_channel->remove();
+    }
+
+private:
+    void onReadable()
+    {
+        char buf[64];
+        ssize_t n = ::read(m_fd, buf, sizeof buf);
+        if (n <= 0)
+        {
+            m_channel->disableAll(); // 客户端已关闭
+            return;
+        }
+        for (ssize_t i = 0; i < n; ++i)
+        {
+            if (buf[i] != 'H')
+            {
+                (void)!::send(m_fd, "L", 1, MSG_NOSIGNAL);
+            }
+            else if (m_mode == Mode::kInline)
+            {
+                m_sink += burnCpu(kHeavyWork);
+                (void)!::send(m_fd, "H", 1, MSG_NOSIGNAL);
+            }
+            else
+            {
+                int fd = m_fd;
+                m_loop->offload([] { return burnCpu(kHeavyWork); },
+                                [this, fd](uint64_t v) {
+                                    m_sink += v;
+                                    (void)!::send(fd, "H", 1, MSG_NOSIGNAL);
+                                });
+            }
+        }
+    }
+
+    EventLoop* m_loop;
+    int m_fd;
+    Mode m_mode;
+    uint64_t m_sink = 0;
+    std::unique_ptr<Channel> m_channel;
+};
+
+struct Result
+{
+    HistogramSnapshot lightUs;
+    double heavyPerSecond;
+};
+
+Result runOnce(Mode mode, ComputePool* compute)
+{
+    EventLoopThread thread;
+    EventLoop* loop = thread.startLoop();
+    loop->setComputePool(compute);
+
+    int light[2];
+    int heavy[2];
+    // 阻塞 socket：客户端阻塞读，不和 Loop 抢 CPU；Loop 只在可读时读，每次只写1字节
+    ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, light);
+    ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, heavy);
+    std::unique_ptr<Server> lightServer;
+    std::unique_ptr<Server> heavyServer;
+    loop->runInLoop([&] {
+        lightServer = std::make_unique<Server>(loop, light[1], mode);
+        heavyServer = std::make_unique<Server>(loop, heavy[1], mode);
+    });
+
+    // heavy 客户端保持 4 个请求在途
+    std::atomic<bool> stop(false);
+    std::atomic<long> heavyDone(0);
+    std::thread heavyClient([&] {
+        if (mode == Mode::kNone) return;
+        constexpr int kInFlight = 4;
+        for (int i = 0; i < kInFlight; ++i) (void)!::write(heavy[0], "H", 1);
+        char c;
+        while (!stop.load() && ::read(heavy[0], &c, 1) == 1)
+        {
+            ++heavyDone;
+            (void)!::write(heavy[0], "H", 1);
+        }
+    });
+
+    Histogram hist;
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < kLightRequests; ++i)
+    {
+        Clock::time_point sent = Clock::now();
+        (void)!::write(light[0], "L", 1);
+        char c;
+        if (::read(light[0], &c, 1) != 1) break;
+        Clock::time_point now = Clock::now();
+        hist.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - sent).count()));
+        std::this_thread::sleep_until(sent + kLightInterval);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    long heavyCompleted = heavyDone.load();
+
+    stop = true;
+    ::shutdown(heavy[0], SHUT_RDWR);
+    heavyClient.join();
+    // 等在途的计算完成（续延已入队），再在 Loop 线程销毁 Server
+    if (compute) compute->stop();
+    CountDownLatch destroyed(1);
+    loop->queueInLoop([&] {
+        lightServer.reset();
+        heavyServer.reset();
+        destroyed.countDown();
+    });
+    destroyed.wait();
+    for (int fd : {light[0], light[1], heavy[0], heavy[1]}) ::close(fd);
+    return {hist.snapshot(), heavyCompleted / seconds};
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("offload", argc, argv);
+    const int threads = 2;
+    for (Mode mode : {Mode::kNone, Mode::kInline, Mode::kOffload})
+    {
+        std::unique_ptr<ComputePool> compute;
+        if (mode == Mode::kOffload)
+        {
+            compute = std::make_unique<ComputePool>("bench");
+            compute->setThreadNum(threads);
+            compute->start();
+        }
+        Result r = runOnce(mode, compute.get());
+        report.add(modeName(mode))
+            .param("heavy_work_us", static_cast<long long>(std::chrono::microseconds(kHeavyWork).count()))
+            .param("compute_threads", mode == Mode::kOffload ? threads : 0)
+            .metric("light_p50_us", static_cast<double>(r.lightUs.percentile(0.5)))
+            .metric("light_p99_us", static_cast<double>(r.lightUs.percentile(0.99)))
+            .metric("light_max_us", static_cast<double>(r.lightUs.max))
+            .metric("heavy_per_sec", r.heavyPerSecond);
+    }
+    return 0;
+}
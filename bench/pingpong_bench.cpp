@@ -0,0 +1,249 @@
+#include "reactor/eventloop.h"
+#include "reactor/channel.h"
+#include "reactor/poller.h"
+#include "reactor/iouringpoller.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 单个 EventLoop 内多对 socketpair 来回传递1字节（ping-pong），比较：
+// - epoll            就绪通知 + read/write
+// - io_uring         POLL_ADD 就绪通知 + read/write（Channel 语义不变）
+// - io_uring+fixed   完成式 READ_FIXED/WRITE_FIXED，不经过 Channel
+// 输出每秒消息数、平均往返时间（每对每个来回两条消息），以及每条消息平均的 Poller 系统调用数和总系统调用数
+
+namespace
+{
+
+constexpr long kMessagesPerPair = 20000;
+
+struct Result
+{
+    double messagesPerSecond;
+    double pollerSyscallsPerMessage;
+    double totalSyscallsPerMessage;
+};
+
+// 就绪通知模式：收到1字节就原样写回
+class ReadinessPair
+{
+public:
+    ReadinessPair(EventLoop* loop, long* remaining, uint64_t* ioSyscalls)
+        : m_loop(loop), m_remaining(remaining), m_ioSyscalls(ioSyscalls)
+    {
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, m_fds);
+        for (int i = 0; i < 2; ++i)
+        {
+            int fd = m_fds[i];
+            m_channels[i] = std::make_unique<Channel>(loop, fd);
+            m_channels[i]->setReadCallback([this, fd] { onReadable(fd); });
+            m_channels[i]->enableReading();
+        }
+    }
+
+    ~ReadinessPair()
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            m_channels[i]->disableAll();
+            m_channels[i]->remove();
+            ::close(m_fds[i]);
+        }
+    }
+
+    void start()
+    {
+        ++*m_ioSyscalls;
+        ssize_t n = ::write(m_fds[0], "x", 1);
+        (void)n;
+    }
+
+private:
+    void onReadable(int fd)
+    {
+        char buf[64];
+        ++*m_ioSyscalls;
+        ssize_t n = ::read(fd, buf, sizeof buf);
+        if (n <= 0) return;
+        if (--*m_remaining <= 0)
+        {
+            m_loop->quit();
+            return;
+        }
+        ++*m_ioSyscalls;
+        n = ::write(fd, buf, static_cast<size_t>(n));
+    }
+
+    EventLoop* m_loop;
+    long* m_remaining;
+    uint64_t* m_ioSyscalls;
+    int m_fds[2];
+    std::unique_ptr<Channel> m_channels[2];
+};
+
+// 完成式模式：每端循环提交 READ_FIXED，读完后 WRITE_FIXED 写回
+class CompletionPair
+{
+public:
+    CompletionPair(EventLoop* loop, IoUringPoller* ring, char* buffers, int bufIndex, long* remaining)
+        : m_loop(loop), m_ring(ring), m_buffers(buffers), m_bufIndex(bufIndex), m_remaining(remaining)
+    {
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, m_fds);
+    }
+
+    ~CompletionPair()
+    {
+        ::close(m_fds[0]);
+        ::close(m_fds[1]);
+    }
+
+    // 让挂起的读请求以0字节完成
+    void shutdown()
+    {
+        ::shutdown(m_fds[0], SHUT_RDWR);
+        ::shutdown(m_fds[1], SHUT_RDWR);
+    }
+
+    void start()
+    {
+        postRead(0);
+        postRead(1);
+        m_buffers[0] = 'x';
+        m_ring->submitWriteFixed(m_fds[0], m_buffers, 1, m_bufIndex, [](int) {});
+    }
+
+private:
+    void postRead(int end)
+    {
+        char* buf = m_buffers + end;
+        m_ring->submitReadFixed(m_fds[end], buf, 1, m_bufIndex, [this, end, buf](int res) {
+            if (res <= 0 || *m_remaining <= 0) return;
+            if (--*m_remaining == 0)
+            {
+                m_loop->quit();
+                return;
+            }
+            m_ring->submitWriteFixed(m_fds[end], buf, 1, m_bufIndex, [](int) {});
+            postRead(end);
+        });
+    }
+
+    EventLoop* m_loop;
+    IoUringPoller* m_ring;
+    char* m_buffers; // 每对占用2字节
+    int m_bufIndex;
+    long* m_remaining;
+    int m_fds[2];
+};
+
+Result finish(EventLoop& loop, Clock::time_point begin, uint64_t pollerBefore, uint64_t ioSyscalls, long messages)
+{
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double pollerSyscalls = static_cast<double>(loop.poller()->syscalls() - pollerBefore);
+    return Result{messages / seconds,
+                  pollerSyscalls / messages,
+                  (pollerSyscalls + static_cast<double>(ioSyscalls)) / messages};
+}
+
+bool runReadiness(PollerBackend backend, int pairs, Result* result)
+{
+    EventLoopOptions options;
+    options.pollerBackend = backend;
+    EventLoop loop(options);
+    if (backend == PollerBackend::kIoUring && loop.ioUring() == nullptr) return false;
+
+    const long messages = kMessagesPerPair * pairs;
+    long remaining = messages;
+    uint64_t ioSyscalls = 0;
+    std::vector<std::unique_ptr<ReadinessPair>> conns;
+    for (int i = 0; i < pairs; ++i)
+    {
+        conns.push_back(std::make_unique<ReadinessPair>(&loop, &remaining, &ioSyscalls));
+    }
+
+    uint64_t pollerBefore = loop.poller()->syscalls();
+    Clock::time_point begin = Clock::now();
+    for (auto& conn : conns) conn->start();
+    loop.loop();
+    *result = finish(loop, begin, pollerBefore, ioSyscalls, messages);
+    return true;
+}
+
+bool runCompletion(int pairs, Result* result)
+{
+    EventLoopOptions options;
+    options.pollerBackend = PollerBackend::kIoUring;
+    options.ioUringEntries = 1024;
+    EventLoop loop(options);
+    IoUringPoller* ring = loop.ioUring();
+    if (ring == nullptr) return false;
+
+    std::vector<char> buffers(static_cast<size_t>(pairs) * 2);
+    struct iovec iov = {buffers.data(), buffers.size()};
+    if (!ring->registerBuffers(&iov, 1)) return false;
+
+    const long messages = kMessagesPerPair * pairs;
+    long remaining = messages;
+    std::vector<std::unique_ptr<CompletionPair>> conns;
+    for (int i = 0; i < pairs; ++i)
+    {
+        conns.push_back(std::make_unique<CompletionPair>(&loop, ring, buffers.data() + i * 2, 0, &remaining));
+    }
+
+    uint64_t pollerBefore = loop.poller()->syscalls();
+    Clock::time_point begin = Clock::now();
+    for (auto& conn : conns) conn->start();
+    loop.loop();
+    *result = finish(loop, begin, pollerBefore, 0, messages);
+
+    // 等挂起的读写请求全部完成后再释放连接和注销缓冲区
+    for (auto& conn : conns) conn->shutdown();
+    loop.runAfter(0.01, [&loop] { loop.quit(); });
+    loop.loop();
+    ring->unregisterBuffers();
+    return true;
+}
+
+void print(bench::Reporter& report, const char* name, int pairs, bool ok, const Result& r)
+{
+    bench::Reporter::Row& row = report.add(name).param("pairs", pairs);
+    if (!ok)
+    {
+        row.param("status", "unavailable");
+        return;
+    }
+    row.metric("msgs_per_sec", r.messagesPerSecond)
+        .metric("avg_rtt_ns", 2e9 * pairs / r.messagesPerSecond)
+        .metric("poller_syscalls_per_msg", r.pollerSyscallsPerMessage)
+        .metric("syscalls_per_msg", r.totalSyscallsPerMessage);
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    ::signal(SIGPIPE, SIG_IGN); // 收尾时写已关闭的 socket
+    bench::Reporter report("pingpong", argc, argv);
+    const int pairCounts[] = {1, 16, 128};
+    for (int pairs : pairCounts)
+    {
+        Result r{};
+        bool ok = runReadiness(PollerBackend::kEpoll, pairs, &r);
+        print(report, "epoll", pairs, ok, r);
+        ok = runReadiness(PollerBackend::kIoUring, pairs, &r);
+        print(report, "io_uring", pairs, ok, r);
+        ok = runCompletion(pairs, &r);
+        print(report, "io_uring+fixed", pairs, ok, r);
+    }
+    return 0;
+}
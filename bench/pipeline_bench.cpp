@@ -0,0 +1,116 @@
+#include "reactor/eventloop.h"
+#include "reactor/tcpserver.h"
+#include "reactor/tcpconnection.h"
+#include "reactor/inetaddress.h"
+#include "reactor/buffer.h"
+#include "benchutil.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 流水线协议下延迟发送（本轮结束时合并写出）的效果：
+// 客户端一次写入 depth 个 16 字节请求，服务端对每个请求 send() 一个 16 字节响应，
+// 客户端读完全部响应后发下一批
+// - immediate: setDeferredSend(false)，每个响应一次 send 系统调用
+// - deferred:  默认行为，同一轮的响应合并为一次 send
+// 输出每秒响应数和每个响应平均的写系统调用数
+
+namespace
+{
+
+constexpr size_t kMessageSize = 16;
+constexpr int kBatches = 20000;
+
+struct Result
+{
+    double responsesPerSecond;
+    double syscallsPerResponse;
+};
+
+Result runOnce(int depth, bool deferred)
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "pipeline");
+    TcpConnectionPtr serverConn;
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (!conn->connected()) return;
+        conn->setDeferredSend(deferred);
+        conn->setTcpNoDelay(true);
+        serverConn = conn;
+    });
+    server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf) {
+        while (buf->readableBytes() >= kMessageSize)
+        {
+            conn->send(buf->peek(), kMessageSize);
+            buf->retrieve(kMessageSize);
+        }
+    });
+    server.start();
+
+    const uint16_t port = server.listenAddress().port();
+    Clock::time_point begin = Clock::now();
+    std::thread client([&] {
+        InetAddress serverAddr("127.0.0.1", port);
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) < 0)
+        {
+            std::perror("connect");
+            std::exit(1);
+        }
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+        std::string batch(kMessageSize * static_cast<size_t>(depth), 'q');
+        std::vector<char> buf(batch.size());
+        for (int i = 0; i < kBatches; ++i)
+        {
+            if (::write(fd, batch.data(), batch.size()) != static_cast<ssize_t>(batch.size())) break;
+            size_t received = 0;
+            while (received < batch.size())
+            {
+                ssize_t n = ::read(fd, buf.data(), buf.size() - received);
+                if (n <= 0) break;
+                received += static_cast<size_t>(n);
+            }
+        }
+        ::close(fd);
+        loop.queueInLoop([&loop] { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double responses = static_cast<double>(kBatches) * depth;
+    Result result{responses / seconds, static_cast<double>(serverConn->writeSyscalls()) / responses};
+    serverConn.reset();
+    return result;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("pipeline", argc, argv);
+    const int depths[] = {1, 4, 16, 64};
+    for (int depth : depths)
+    {
+        for (bool deferred : {false, true})
+        {
+            Result r = runOnce(depth, deferred);
+            report.add(deferred ? "deferred" : "immediate")
+                .param("depth", depth)
+                .metric("responses_per_sec", r.responsesPerSecond)
+                .metric("write_syscalls_per_response", r.syscallsPerResponse);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthread.h"
+#include "reactor/channel.h"
+#include "benchutil.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 多生产者向同一个 EventLoop 投递任务的吞吐量：
+// - lockfree: EventLoop::queueInLoop（无锁 MPSC 队列 + 唤醒合并）
+// - lockfree_metrics: 同上，Loop 开启 LoopMetrics（排队延迟采样、每轮的耗时直方图）
+// - mutex:    原实现的参照版本，互斥锁 + vector，每次跨线程投递都写一次 eventfd
+// 每个生产者投递 kTasksPerProducer 个空任务，统计从开始投递到最后一个任务执行完的时间
+
+namespace
+{
+
+constexpr int kTasksPerProducer = 200000;
+
+// 参照实现：和改造前的 queueInLoop 相同的加锁 + 每次写 eventfd
+class MutexQueue
+{
+public:
+    explicit MutexQueue(EventLoop* loop)
+        : m_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+          m_channel(loop, m_fd)
+    {
+        m_channel.setReadCallback([this] { drain(); });
+        m_channel.enableReading();
+    }
+
+    ~MutexQueue()
+    {
+        m_channel.disableAll();
+        m_channel.remove();
+        ::close(m_fd);
+    }
+
+    void post(std::function<void()> cb)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_pending.push_back(std::move(cb));
+        }
+        uint64_t one = 1;
+        ssize_t n = ::write(m_fd, &one, sizeof one);
+        (void)n;
+    }
+
+private:
+    void drain()
+    {
+        uint64_t value;
+        ssize_t n = ::read(m_fd, &value, sizeof value);
+        (void)n;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_calling.swap(m_pending);
+        }
+        for (const auto& f : m_calling) f();
+        m_calling.clear();
+    }
+
+    int m_fd;
+    Channel m_channel;
+    std::mutex m_mtx;
+    std::vector<std::function<void()>> m_pending;
+    std::vector<std::function<void()>> m_calling;
+};
+
+// 在 loop 所在线程里执行 fn 并等待完成
+void runSync(EventLoop* loop, std::function<void()> fn)
+{
+    std::atomic<bool> done(false);
+    loop->runInLoop([&] { fn(); done.store(true); });
+    while (!done.load()) std::this_thread::yield();
+}
+
+template <typename Post>
+double runOnce(int producers, Post post)
+{
+    const long total = static_cast<long>(producers) * kTasksPerProducer;
+    std::atomic<long> executed(0);
+    std::atomic<bool> go(false);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&] {
+            while (!go.load()) std::this_thread::yield();
+            for (int i = 0; i < kTasksPerProducer; ++i)
+            {
+                post([&executed] { executed.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+
+    Clock::time_point begin = Clock::now();
+    go.store(true);
+    for (auto& t : threads) t.join();
+    while (executed.load(std::memory_order_relaxed) < total) std::this_thread::yield();
+    Clock::time_point end = Clock::now();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    return total / seconds;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("queueinloop", argc, argv);
+    EventLoopThread thread;
+    EventLoop* loop = thread.startLoop();
+    EventLoopOptions withMetrics;
+    withMetrics.enableMetrics = true;
+    EventLoopThread metricsThread(withMetrics);
+    EventLoop* metricsLoop = metricsThread.startLoop();
+
+    MutexQueue* reference = nullptr;
+    runSync(loop, [&] { reference = new MutexQueue(loop); });
+
+    const int producerCounts[] = {1, 2, 4, 8};
+    for (int producers : producerCounts)
+    {
+        double lockfree = runOnce(producers, [loop](std::function<void()> cb) {
+            loop->queueInLoop(std::move(cb));
+        });
+        report.add("lockfree").param("producers", producers).metric("tasks_per_sec", lockfree);
+
+        double measured = runOnce(producers, [metricsLoop](std::function<void()> cb) {
+            metricsLoop->queueInLoop(std::move(cb));
+        });
+        report.add("lockfree_metrics").param("producers", producers).metric("tasks_per_sec", measured);
+
+        double locked = runOnce(producers, [reference](std::function<void()> cb) {
+            reference->post(std::move(cb));
+        });
+        report.add("mutex").param("producers", producers).metric("tasks_per_sec", locked);
+    }
+
+    runSync(loop, [&] { delete reference; });
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthreadpool.h"
+#include "reactor/channel.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// EventLoopThreadPool 的多 Loop 扩展性：
+// 每个工作 Loop 上有 kPairsPerLoop 对 socketpair 在本 Loop 内来回传递1字节，
+// 运行 kRunTime 后统计所有 Loop 合计的消息速率，以及相对单 Loop 的加速比
+// 理想情况下加速比随 Loop 数线性增长，直到 Loop 数超过可用 CPU 数
+
+namespace
+{
+
+constexpr int kPairsPerLoop = 8;
+constexpr auto kRunTime = std::chrono::milliseconds(500);
+
+class Pair
+{
+public:
+    Pair(EventLoop* loop, const std::atomic<bool>* stop)
+        : m_stop(stop), m_messages(0)
+    {
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, m_fds);
+        for (int i = 0; i < 2; ++i)
+        {
+            int fd = m_fds[i];
+            m_channels[i] = std::make_unique<Channel>(loop, fd);
+            m_channels[i]->setReadCallback([this, fd] { onReadable(fd); });
+            m_channels[i]->enableReading();
+        }
+    }
+
+    ~Pair()
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            m_channels[i]->disableAll();
+            m_channels[i]->remove();
+            ::close(m_fds[i]);
+        }
+    }
+
+    void start()
+    {
+        ssize_t n = ::write(m_fds[0], "x", 1);
+        (void)n;
+    }
+
+    uint64_t messages() const { return m_messages; }
+
+private:
+    void onReadable(int fd)
+    {
+        char buf[64];
+        ssize_t n = ::read(fd, buf, sizeof buf);
+        if (n <= 0) return;
+        ++m_messages;
+        if (m_stop->load(std::memory_order_relaxed)) return;
+        n = ::write(fd, buf, static_cast<size_t>(n));
+    }
+
+    const std::atomic<bool>* m_stop;
+    uint64_t m_messages;
+    int m_fds[2];
+    std::unique_ptr<Channel> m_channels[2];
+};
+
+void runSync(EventLoop* loop, const std::function<void()>& fn)
+{
+    std::atomic<bool> done(false);
+    loop->runInLoop([&] { fn(); done.store(true); });
+    while (!done.load()) std::this_thread::yield();
+}
+
+double runOnce(int threads)
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(threads);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    std::atomic<bool> stop(false);
+    std::vector<std::vector<std::unique_ptr<Pair>>> pairs(loops.size());
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        runSync(loops[i], [&, i] {
+            for (int p = 0; p < kPairsPerLoop; ++p)
+            {
+                pairs[i].push_back(std::make_unique<Pair>(loops[i], &stop));
+            }
+        });
+    }
+
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        runSync(loops[i], [&, i] {
+            for (auto& pair : pairs[i]) pair->start();
+        });
+    }
+    std::this_thread::sleep_for(kRunTime);
+    stop.store(true);
+
+    uint64_t total = 0;
+    double seconds = 0;
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        runSync(loops[i], [&, i] {
+            if (i == 0) seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            for (auto& pair : pairs[i]) total += pair->messages();
+            pairs[i].clear();
+        });
+    }
+    return static_cast<double>(total) / seconds;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("scaling", argc, argv);
+    const int threadCounts[] = {1, 2, 4, 8};
+    double base = 0;
+    for (int threads : threadCounts)
+    {
+        double rate = runOnce(threads);
+        if (base == 0) base = rate;
+        report.add("pool_pingpong")
+            .param("loops", threads)
+            .param("pairs_per_loop", kPairsPerLoop)
+            .metric("msgs_per_sec", rate)
+            .metric("speedup", rate / base);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "reactor/eventloop.h"
+#include "benchutil.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 比较两种定时器后端在不同规模下的开销：
+// 1. 添加 N 个随机到期时间的单次定时器
+// 2. 取消其中一半
+// 3. 等待全部到期后，一次 loop() 触发剩下的定时器
+
+namespace
+{
+
+constexpr double kSpreadSeconds = 0.2; // 定时器到期时间分布在 [1ms, 200ms]
+
+struct Result
+{
+    double addNs;
+    double cancelNs;
+    double fireNs;
+};
+
+double nsPerOp(Clock::time_point begin, Clock::time_point end, int ops)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count() / ops;
+}
+
+Result runOnce(TimerBackend backend, int count)
+{
+    EventLoopOptions options;
+    options.timerBackend = backend;
+    EventLoop loop(options);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(0.001, kSpreadSeconds);
+    std::vector<double> delays(count);
+    for (double& d : delays) d = dist(rng);
+
+    std::vector<TimerId> ids;
+    ids.reserve(count);
+    int fired = 0;
+    const int expected = count - count / 2;
+    auto cb = [&fired, &loop, expected]() {
+        if (++fired == expected) loop.quit();
+    };
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        ids.push_back(loop.runAfter(delays[i], cb));
+    }
+    Clock::time_point added = Clock::now();
+
+    for (int i = 0; i < count; i += 2)
+    {
+        loop.cancel(ids[i]);
+    }
+    Clock::time_point cancelled = Clock::now();
+
+    // 等所有定时器都到期，单独衡量触发开销
+    std::this_thread::sleep_until(start + std::chrono::duration<double>(kSpreadSeconds + 0.02));
+    Clock::time_point fireBegin = Clock::now();
+    loop.loop();
+    Clock::time_point fireEnd = Clock::now();
+
+    return Result{nsPerOp(start, added, count),
+                  nsPerOp(added, cancelled, count / 2),
+                  nsPerOp(fireBegin, fireEnd, expected)};
+}
+
+const char* backendName(TimerBackend backend)
+{
+    return backend == TimerBackend::kOrderedSet ? "ordered_set" : "timing_wheel";
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("timerqueue", argc, argv);
+    const int sizes[] = {10000, 100000, 1000000};
+    const TimerBackend backends[] = {TimerBackend::kOrderedSet, TimerBackend::kTimingWheel};
+
+    for (int size : sizes)
+    {
+        for (TimerBackend backend : backends)
+        {
+            Result r = runOnce(backend, size);
+            report.add(backendName(backend))
+                .param("timers", size)
+                .metric("add_ns", r.addNs)
+                .metric("cancel_ns", r.cancelNs)
+                .metric("fire_ns", r.fireNs)
+                .metric("timers_per_sec", 1e9 / (r.addNs + r.fireNs));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "reactor/eventloop.h"
+#include "reactor/timerqueue.h"
+#include "benchutil.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+using namespace reactor;
+
+// 大量短超时的场景下，比较不同定时器容差（slack）的 timerfd 开销：
+// - 保持 kTimers 个单次定时器，每个到期后用新的随机延时 [1ms, 20ms] 重新添加自己
+// - 运行 kRunTime，统计 timerfd_settime 次数、timerfd 唤醒次数、每次唤醒执行的定时器数，
+//   以及实际触发时间比到期时间晚多少（来自 LoopMetrics）
+
+namespace
+{
+
+constexpr int kTimers = 2000;
+constexpr auto kRunTime = std::chrono::milliseconds(500);
+constexpr int64_t kMinDelayUs = 1000;
+constexpr int64_t kMaxDelayUs = 20000;
+
+struct Churn
+{
+    EventLoop* loop;
+    Nanoseconds slack;
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int64_t> delayUs{kMinDelayUs, kMaxDelayUs};
+    uint64_t fired = 0;
+    bool stopping = false;
+
+    void schedule()
+    {
+        loop->runAfter(std::chrono::microseconds(delayUs(rng)), [this] { onTimer(); }, slack);
+    }
+
+    void onTimer()
+    {
+        ++fired;
+        if (!stopping) schedule();
+    }
+};
+
+void runOnce(bench::Reporter& report, Nanoseconds slack)
+{
+    EventLoopOptions options;
+    options.enableMetrics = true; // 输出定时器触发延迟
+    EventLoop loop(options);
+    Churn churn{&loop, slack};
+    for (int i = 0; i < kTimers; ++i) churn.schedule();
+
+    const TimerQueue* timers = loop.timerQueue();
+    uint64_t settimeBefore = timers->syscalls();
+    uint64_t wakeupsBefore = timers->wakeups();
+    loop.runAfter(kRunTime, [&] {
+        churn.stopping = true;
+        loop.quit();
+    }, Nanoseconds::zero());
+    loop.loop();
+
+    double seconds = std::chrono::duration<double>(kRunTime).count();
+    uint64_t settime = timers->syscalls() - settimeBefore;
+    uint64_t wakeups = timers->wakeups() - wakeupsBefore;
+    LoopMetricsSnapshot metrics = loop.metricsSnapshot();
+    report.add("timer_slack")
+        .param("slack_us", static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(slack).count()))
+        .metric("timers_per_sec", churn.fired / seconds)
+        .metric("settime_per_sec", settime / seconds)
+        .metric("wakeups_per_sec", wakeups / seconds)
+        .metric("timers_per_wakeup", wakeups ? static_cast<double>(churn.fired) / static_cast<double>(wakeups) : 0.0)
+        .metric("lateness_avg_us", metrics.timerLatenessNs.mean() / 1000.0)
+        .metric("lateness_p99_us", metrics.timerLatenessNs.percentile(0.99) / 1000.0);
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("timerslack", argc, argv);
+    const int64_t slacksUs[] = {0, 50, 200, 1000, 5000};
+    for (int64_t slackUs : slacksUs)
+    {
+        runOnce(report, std::chrono::microseconds(slackUs));
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthread.h"
+#include "reactor/udpendpoint.h"
+#include "benchutil.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 本机 UDP 小包（64 字节）吞吐：发送端在独立的 EventLoopThread 中不停投递一批数据报，
+// 接收端在主线程的 Loop 中接收，运行 kRunTime 后统计
+// - single:  batchSize = 1，每个数据报一次 sendmmsg/recvmmsg（等价于 sendto/recvfrom）
+// - mmsg:    batchSize = 64，sendmmsg/recvmmsg 批量收发
+// - gso_gro: 在 mmsg 基础上开启 UDP_SEGMENT/UDP_GRO，一条消息携带多个数据报
+// 输出接收端每秒数据报数，以及收发两端每个数据报平均的系统调用数
+
+namespace
+{
+
+constexpr size_t kPayload = 64;
+constexpr int kBurst = 256; // 发送端每个任务投递的数据报数
+constexpr auto kRunTime = std::chrono::milliseconds(1000);
+
+struct Result
+{
+    double receivedPerSecond;
+    double sentPerSecond;
+    double recvSyscallsPerDatagram;
+    double sendSyscallsPerDatagram;
+    bool gso;
+    bool gro;
+};
+
+class Pump
+{
+public:
+    Pump(EventLoop* loop, UdpEndpoint* endpoint, const InetAddress& target, const std::atomic<bool>* stop)
+        : m_loop(loop), m_endpoint(endpoint), m_target(target), m_stop(stop)
+    {
+        for (size_t i = 0; i < kPayload; ++i) m_payload[i] = static_cast<char>('a' + i % 26);
+    }
+
+    void run()
+    {
+        if (m_stop->load(std::memory_order_relaxed)) return;
+        for (int i = 0; i < kBurst; ++i) m_endpoint->sendTo(m_payload, kPayload, m_target);
+        m_loop->queueInLoop([this] { run(); });
+    }
+
+private:
+    EventLoop* m_loop;
+    UdpEndpoint* m_endpoint;
+    InetAddress m_target;
+    const std::atomic<bool>* m_stop;
+    char m_payload[kPayload];
+};
+
+Result runOnce(int batchSize, bool offload)
+{
+    UdpOptions options;
+    options.batchSize = batchSize;
+    options.enableGro = offload;
+    options.enableGso = offload;
+    options.socketBufferBytes = 4 << 20;
+
+    EventLoop loop;
+    UdpEndpoint receiver(&loop, InetAddress(0, true), "rx", options);
+    receiver.start();
+    const InetAddress target("127.0.0.1", receiver.localAddress().port());
+
+    EventLoopThread senderThread;
+    EventLoop* senderLoop = senderThread.startLoop();
+    std::atomic<bool> stop(false);
+    std::unique_ptr<UdpEndpoint> sender;
+    std::unique_ptr<Pump> pump;
+    std::atomic<bool> ready(false);
+    senderLoop->runInLoop([&] {
+        sender = std::make_unique<UdpEndpoint>(senderLoop, InetAddress(0, true), "tx", options);
+        pump = std::make_unique<Pump>(senderLoop, sender.get(), target, &stop);
+        ready = true;
+    });
+    while (!ready.load()) std::this_thread::yield();
+
+    uint64_t recvBefore = receiver.datagramsReceived();
+    Clock::time_point begin = Clock::now();
+    senderLoop->runInLoop([&] { pump->run(); });
+    loop.runAfter(std::chrono::duration<double>(kRunTime).count(), [&loop] { loop.quit(); });
+    loop.loop();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    stop = true;
+
+    Result result{};
+    std::atomic<bool> done(false);
+    senderLoop->runInLoop([&] {
+        double sent = static_cast<double>(sender->datagramsSent());
+        result.sentPerSecond = sent / seconds;
+        result.sendSyscallsPerDatagram = sent > 0 ? static_cast<double>(sender->sendSyscalls()) / sent : 0;
+        result.gso = sender->gsoEnabled();
+        pump.reset();
+        sender.reset();
+        done = true;
+    });
+    while (!done.load()) std::this_thread::yield();
+
+    double received = static_cast<double>(receiver.datagramsReceived() - recvBefore);
+    result.receivedPerSecond = received / seconds;
+    result.recvSyscallsPerDatagram = received > 0 ? static_cast<double>(receiver.recvSyscalls()) / received : 0;
+    result.gro = receiver.groEnabled();
+    return result;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("udp", argc, argv);
+    struct Mode
+    {
+        const char* name;
+        int batchSize;
+        bool offload;
+    };
+    const Mode modes[] = {{"single", 1, false}, {"mmsg", 64, false}, {"gso_gro", 64, true}};
+    for (const Mode& mode : modes)
+    {
+        Result r = runOnce(mode.batchSize, mode.offload);
+        report.add(mode.name)
+            .param("batch", mode.batchSize)
+            .param("payload", static_cast<long long>(kPayload))
+            .param("gso", r.gso ? "on" : "off")
+            .param("gro", r.gro ? "on" : "off")
+            .metric("received_per_sec", r.receivedPerSecond)
+            .metric("sent_per_sec", r.sentPerSecond)
+            .metric("recv_syscalls_per_datagram", r.recvSyscallsPerDatagram)
+            .metric("send_syscalls_per_datagram", r.sendSyscallsPerDatagram);
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include "reactor/eventloop.h"
+#include "reactor/tcpserver.h"
+#include "reactor/tcpconnection.h"
+#include "reactor/inetaddress.h"
+#include "reactor/buffer.h"
+#include "benchutil.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace reactor;
+using Clock = std::chrono::steady_clock;
+
+// 零拷贝输出与经过用户态复制的对比（本机 TCP，单个 EventLoop）：
+// - file   copy:     pread 64KB 到用户态再 send()，写空后读下一块
+//          sendfile: TcpConnection::sendFile() 一次提交整个文件
+// - proxy  buffer:   源连接的 MessageCallback 里 sink->send(buf)
+//          splice:   TcpConnection::forwardTo()，经 PipePool 的管道在内核中转发
+// 客户端读完全部数据为止，输出吞吐量（MB/s）
+
+namespace
+{
+
+constexpr size_t kTransferBytes = 64 << 20;
+constexpr size_t kChunk = 64 * 1024;
+
+int connectTo(uint16_t port)
+{
+    InetAddress serverAddr("127.0.0.1", port);
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) < 0)
+    {
+        std::perror("connect");
+        std::exit(1);
+    }
+    return fd;
+}
+
+size_t drain(int fd)
+{
+    std::vector<char> buf(kChunk);
+    size_t total = 0;
+    for (;;)
+    {
+        ssize_t n = ::read(fd, buf.data(), buf.size());
+        if (n <= 0) break;
+        total += static_cast<size_t>(n);
+    }
+    return total;
+}
+
+double runFile(int fileFd, bool zeroCopy)
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "file");
+    auto offset = std::make_shared<off_t>(0);
+    std::vector<char> chunk(kChunk);
+    auto sendNextChunk = [&, offset](const TcpConnectionPtr& conn) {
+        if (static_cast<size_t>(*offset) >= kTransferBytes)
+        {
+            conn->shutdown();
+            return;
+        }
+        ssize_t n = ::pread(fileFd, chunk.data(), chunk.size(), *offset);
+        if (n <= 0) return;
+        *offset += n;
+        conn->send(chunk.data(), static_cast<size_t>(n));
+    };
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (!conn->connected()) return;
+        if (zeroCopy)
+        {
+            conn->sendFile(fileFd, 0, kTransferBytes);
+            conn->shutdown();
+        }
+        else
+        {
+            sendNextChunk(conn);
+        }
+    });
+    if (!zeroCopy) server.setWriteCompleteCallback(sendNextChunk);
+    server.start();
+
+    size_t received = 0;
+    Clock::time_point begin = Clock::now();
+    std::thread client([&] {
+        int fd = connectTo(server.listenAddress().port());
+        received = drain(fd);
+        ::close(fd);
+        loop.queueInLoop([&loop] { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return static_cast<double>(received) / seconds / 1e6;
+}
+
+double runProxy(bool zeroCopy)
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "proxy");
+    std::vector<TcpConnectionPtr> conns;
+    std::atomic<bool> ready(false);
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (!conn->connected())
+        {
+            // 源关闭后关闭 sink 的写端，客户端读到 EOF
+            if (!zeroCopy && conn == conns[0]) conns[1]->shutdown();
+            return;
+        }
+        conns.push_back(conn);
+        if (conns.size() == 2)
+        {
+            if (zeroCopy) conns[0]->forwardTo(conns[1]);
+            ready = true;
+        }
+    });
+    server.setMessageCallback([&](const TcpConnectionPtr& conn, Buffer* buf) {
+        if (conn == conns[0]) conns[1]->send(buf);
+        else buf->retrieveAll();
+    });
+    server.start();
+
+    size_t received = 0;
+    Clock::time_point begin = Clock::now();
+    std::thread client([&] {
+        uint16_t port = server.listenAddress().port();
+        int source = connectTo(port);
+        int sink = connectTo(port);
+        while (!ready.load()) std::this_thread::yield();
+        std::thread writer([source] {
+            std::vector<char> buf(kChunk, 'x');
+            size_t written = 0;
+            while (written < kTransferBytes)
+            {
+                ssize_t n = ::write(source, buf.data(), buf.size());
+                if (n <= 0) break;
+                written += static_cast<size_t>(n);
+            }
+            ::close(source);
+        });
+        received = drain(sink);
+        writer.join();
+        ::close(sink);
+        loop.queueInLoop([&loop] { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+    conns.clear();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return static_cast<double>(received) / seconds / 1e6;
+}
+
+}// namespace
+
+int main(int argc, char** argv)
+{
+    bench::Reporter report("zerocopy", argc, argv);
+
+    char path[] = "/tmp/reactor_zerocopy_XXXXXX";
+    int fileFd = ::mkstemp(path);
+    ::unlink(path);
+    std::vector<char> block(kChunk, 'f');
+    for (size_t written = 0; written < kTransferBytes; written += block.size())
+    {
+        if (::write(fileFd, block.data(), block.size()) != static_cast<ssize_t>(block.size())) return 1;
+    }
+
+    report.add("file").param("mode", "copy").param("bytes", static_cast<long long>(kTransferBytes))
+        .metric("mb_per_sec", runFile(fileFd, false));
+    report.add("file").param("mode", "sendfile").param("bytes", static_cast<long long>(kTransferBytes))
+        .metric("mb_per_sec", runFile(fileFd, true));
+    report.add("proxy").param("mode", "buffer").param("bytes", static_cast<long long>(kTransferBytes))
+        .metric("mb_per_sec", runProxy(false));
+    report.add("proxy").param("mode", "splice").param("bytes", static_cast<long long>(kTransferBytes))
+        .metric("mb_per_sec", runProxy(true));
+    ::close(fileFd);
+    return 0;
+}
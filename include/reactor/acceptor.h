@@ -0,0 +1,49 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "channel.h"
+#include "socket.h"
+#include <functional>
+
+namespace reactor
+{
+
+class EventLoop;
+class InetAddress;
+
+// Acceptor 在主 Loop 上接受新连接
+// 职责：
+// 1. 创建、绑定、监听非阻塞的监听 socket
+// 2. 监听 socket 可读时 accept，把连接 fd 交给 NewConnectionCallback（通常是 TcpServer）
+//
+// 实现细节：
+// - 预留一个空闲 fd（/dev/null）：fd 耗尽（EMFILE）时先关闭它腾出位置，
+//   accept 后立即关闭连接再重新占位，避免监听 socket 一直可读导致忙等
+class Acceptor : private NonCopyable
+{
+public:
+    using NewConnectionCallback = std::function<void(int sockfd, const InetAddress&)>;
+
+    Acceptor(EventLoop* loop, const InetAddress& listenAddr, bool reusePort);
+    ~Acceptor();
+
+    void setNewConnectionCallback(NewConnectionCallback cb) { m_newConnectionCallback = std::move(cb); }
+
+    void listen();
+    bool listening() const { return m_listening; }
+
+    // 实际监听的地址（端口为0时由内核分配）
+    InetAddress listenAddress() const;
+
+private:
+    void handleRead();
+
+    EventLoop* m_loop;
+    Socket m_acceptSocket;
+    Channel m_acceptChannel;
+    NewConnectionCallback m_newConnectionCallback;
+    bool m_listening;
+    int m_idleFd; // EMFILE 时使用的预留 fd
+};
+
+}// namespace reactor
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <sys/types.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace reactor
+{
+
+// Buffer 是网络收发用的字节缓冲区
+// 职责：
+// 1. 读写两端都是连续内存，可以直接交给 read/write/send
+// 2. 头部预留 kCheapPrepend 字节，协议编码时可以在已写好的数据前补长度字段，不需要搬移数据
+// 3. readFd() 一次 readv 读入缓冲区剩余空间和栈上 64KB 的额外空间，
+//    一次系统调用就能读空 socket，同时不需要为每个连接预先分配大缓冲区
+//
+// 内存布局：
+// +-------------------+------------------+------------------+
+// | prependable bytes |  readable bytes  |  writable bytes  |
+// |                   |     (CONTENT)    |                  |
+// +-------------------+------------------+------------------+
+// 0      <=      readerIndex   <=   writerIndex    <=     size
+//
+// 实现细节：
+// - 写空间不够时，如果 prependable + writable 足够，把可读数据搬到前面（内部整理）而不是扩容
+// - 只能在一个线程中使用（通常是所属连接的 Loop 线程）
+class Buffer
+{
+public:
+    static constexpr size_t kCheapPrepend = 8;
+    static constexpr size_t kInitialSize = 1024;
+
+    explicit Buffer(size_t initialSize = kInitialSize)
+        : m_buffer(kCheapPrepend + initialSize),
+          m_readerIndex(kCheapPrepend),
+          m_writerIndex(kCheapPrepend)
+    {
+    }
+
+    void swap(Buffer& rhs)
+    {
+        m_buffer.swap(rhs.m_buffer);
+        std::swap(m_readerIndex, rhs.m_readerIndex);
+        std::swap(m_writerIndex, rhs.m_writerIndex);
+    }
+
+    size_t readableBytes() const { return m_writerIndex - m_readerIndex; }
+    size_t writableBytes() const { return m_buffer.size() - m_writerIndex; }
+    size_t prependableBytes() const { return m_readerIndex; }
+
+    // 可读数据的起始地址
+    const char* peek() const { return begin() + m_readerIndex; }
+
+    // 在可读数据中查找 \r\n，找不到返回 nullptr
+    const char* findCRLF() const
+    {
+        const char* crlf = std::search(peek(), beginWrite(), kCRLF, kCRLF + 2);
+        return crlf == beginWrite() ? nullptr : crlf;
+    }
+
+    // 取走 len 字节（只移动读指针）
+    void retrieve(size_t len)
+    {
+        assert(len <= readableBytes());
+        if(len < readableBytes())
+        {
+            m_readerIndex += len;
+        }
+        else
+        {
+            retrieveAll();
+        }
+    }
+
+    void retrieveUntil(const char* end)
+    {
+        assert(peek() <= end);
+        assert(end <= beginWrite());
+        retrieve(static_cast<size_t>(end - peek()));
+    }
+
+    // 全部取走后读写指针回到预留区之后，下次写入不需要整理
+    void retrieveAll()
+    {
+        m_readerIndex = kCheapPrepend;
+        m_writerIndex = kCheapPrepend;
+    }
+
+    std::string retrieveAsString(size_t len)
+    {
+        assert(len <= readableBytes());
+        std::string result(peek(), len);
+        retrieve(len);
+        return result;
+    }
+
+    std::string retrieveAllAsString() { return retrieveAsString(readableBytes()); }
+
+    void append(const char* data, size_t len)
+    {
+        ensureWritableBytes(len);
+        std::memcpy(beginWrite(), data, len);
+        hasWritten(len);
+    }
+
+    void append(const void* data, size_t len) { append(static_cast<const char*>(data), len); }
+    void append(const std::string& str) { append(str.data(), str.size()); }
+
+    void ensureWritableBytes(size_t len)
+    {
+        if(writableBytes() < len)
+        {
+            makeSpace(len);
+        }
+        assert(writableBytes() >= len);
+    }
+
+    char* beginWrite() { return begin() + m_writerIndex; }
+    const char* beginWrite() const { return begin() + m_writerIndex; }
+
+    // 直接写入 beginWrite() 之后调用
+    void hasWritten(size_t len)
+    {
+        assert(len <= writableBytes());
+        m_writerIndex += len;
+    }
+
+    // 撤销最后写入的 len 字节
+    void unwrite(size_t len)
+    {
+        assert(len <= readableBytes());
+        m_writerIndex -= len;
+    }
+
+    // 在可读数据之前插入（例如长度字段），不搬移已有数据
+    void prepend(const void* data, size_t len)
+    {
+        assert(len <= prependableBytes());
+        m_readerIndex -= len;
+        std::memcpy(begin() + m_readerIndex, data, len);
+    }
+
+    // 网络字节序的整数读写
+    void appendInt32(int32_t x);
+    void prependInt32(int32_t x);
+    int32_t peekInt32() const;
+    int32_t readInt32();
+
+    // 释放多余的容量，只保留可读数据和 reserve 字节的写空间
+    void shrink(size_t reserve);
+
+    size_t internalCapacity() const { return m_buffer.capacity(); }
+
+    // 从 fd 读数据，一次 readv 同时使用剩余写空间和栈上的额外缓冲区
+    // 返回 read 的结果，出错时 *savedErrno 保存 errno
+    ssize_t readFd(int fd, int* savedErrno);
+
+private:
+    char* begin() { return m_buffer.data(); }
+    const char* begin() const { return m_buffer.data(); }
+
+    void makeSpace(size_t len);
+
+    static const char kCRLF[];
+
+    std::vector<char> m_buffer;
+    size_t m_readerIndex;
+    size_t m_writerIndex;
+};
+
+}// namespace reactor
@@ -1,12 +1,34 @@
 #pragma once
+#include "uniquefunction.h"
 #include <functional>
 #include <memory>
 
 namespace reactor
 {
 
-using EventCallback = std::function<void()>;
-using TimerCallback = std::function<void()>;
-using Functor = std::function<void()>;
+class Buffer;
+class TcpConnection;
+using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
+
+// Loop 内部保存、只调用不复制的回调使用只能移动的 UniqueFunction：
+// 捕获不超过56字节时不分配内存，也可以捕获 std::unique_ptr
+using EventCallback = UniqueFunction<void()>;
+using TimerCallback = UniqueFunction<void()>;
+using Functor = UniqueFunction<void()>;
+
+static_assert(sizeof(Functor) == 64, "Functor should fit in one cache line");
+
+// 完成式 IO 的回调，参数为读写的字节数或 -errno
+using IoCompletionCallback = UniqueFunction<void(int)>;
+
+// 需要复制到多个 Loop 的任务（EventLoopThreadPool::broadcast）
+using SharedFunctor = std::function<void()>;
+
+// TCP 连接回调
+using ConnectionCallback = std::function<void(const TcpConnectionPtr&)>; // 连接建立/断开
+using MessageCallback = std::function<void(const TcpConnectionPtr&, Buffer*)>; // 收到数据
+using WriteCompleteCallback = std::function<void(const TcpConnectionPtr&)>; // 输出缓冲区写空
+using HighWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t)>; // 输出缓冲区超过高水位
+using CloseCallback = std::function<void(const TcpConnectionPtr&)>; // 内部使用：通知 TcpServer 移除连接
 
 }// namespace reactor
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "noncopyable.h"
 #include "callbacks.h"
+#include <memory>
 
 
 namespace reactor
@@ -9,6 +10,15 @@ namespace reactor
 
 class EventLoop;
 
+// Channel 负责一个 fd 的事件分发
+// 触发模式（默认水平触发，均需在 enableReading/enableWriting 之前设置）：
+// - 边沿触发 setEdgeTriggered(true)：向 epoll 一次性注册 IN|OUT|ET，
+//   handleEvent 按关心的事件过滤回调。回调必须读/写到 EAGAIN，否则不会再次通知。
+//   关闭读/写只修改用户关心的事件，不产生 epoll_ctl；关闭期间到达的边沿被丢弃并记录，
+//   重新开启该方向时如果丢过边沿，用一次 epoll_ctl MOD 让内核重新报告当前就绪状态
+// - 单次触发 setOneShot(true)：每次事件通知后 fd 被内核禁用，
+//   处理完后调用 rearm() 重新启用（一次 epoll_ctl MOD）
+// - setWatchPeerClose(true)：额外关注 EPOLLRDHUP，对端半关闭时触发读回调
 class Channel : private NonCopyable
 {
 public:
@@ -21,17 +31,38 @@ public:
     void setCloseCallback(EventCallback cb) { m_closeCallback = std::move(cb); }
     void setErrorCallback(EventCallback cb) { m_errorCallback = std::move(cb); }
 
+    // 绑定拥有者（通常是 TcpConnection），handleEvent 期间持有它，
+    // 防止回调中拥有者被销毁；拥有者已销毁时不再分发事件
+    void tie(const std::shared_ptr<void>& owner);
+
     int fd() const { return m_fd; }
 
     uint32_t events() const { return m_events; }
     void setRevents(uint32_t revents) { m_revents = revents; }
 
-    //是否没有关心任何事件
+    // 实际注册到 epoll 的事件（关心的事件 + 触发模式标志），没有关心的事件时为0
+    uint32_t pollEvents() const;
+
+    // 最近一次成功注册到 Poller 的事件，由 Poller 维护；单次触发的 fd 通知后置为0（已禁用）
+    uint32_t registeredEvents() const { return m_registeredEvents; }
+    void setRegisteredEvents(uint32_t events) { m_registeredEvents = events; }
+
+    //是否没有关心任何事件（不含触发模式标志）
     bool isNoneEvent() const { return m_events == kNoneEvent; }
 
+    // 触发模式
+    void setEdgeTriggered(bool on) { setMode(kEdgeTriggered, on); }
+    void setOneShot(bool on) { setMode(kOneShot, on); }
+    void setWatchPeerClose(bool on) { setMode(kWatchPeerClose, on); }
+    bool isEdgeTriggered() const { return m_mode & kEdgeTriggered; }
+    bool isOneShot() const { return m_mode & kOneShot; }
+
+    // 单次触发模式下重新启用 fd；已启用时不产生系统调用
+    void rearm() { update(); }
+
     //启用事件
-    void enableReading() { m_events |= kReadEvent; update(); }
-    void enableWriting() { m_events |= kWriteEvent; update(); }
+    void enableReading() { enableEvents(kReadEvent); }
+    void enableWriting() { enableEvents(kWriteEvent); }
     void disableWriting() { m_events &= ~kWriteEvent; update(); }
     void disableAll() { m_events = kNoneEvent; update(); }
     void disableReading() { m_events &= ~kReadEvent; update(); }
@@ -54,16 +85,27 @@ public:
     
 private:
     void update();
+    void enableEvents(uint32_t events);
+    void setMode(uint32_t flag, bool on);
+    void handleEventWithGuard();
 
     //事件常量(epoll的事件类型)
     static const uint32_t kNoneEvent;
     static const uint32_t kReadEvent;
     static const uint32_t kWriteEvent;
 
+    // 触发模式标志（m_mode）
+    static const uint32_t kEdgeTriggered;
+    static const uint32_t kOneShot;
+    static const uint32_t kWatchPeerClose;
+
     EventLoop* m_loop; // EventLoop对象指针
     const int m_fd; // 文件描述符
     uint32_t m_events; // 关心事件
     uint32_t m_revents; // 实际发生的事件
+    uint32_t m_mode; // 触发模式标志
+    uint32_t m_registeredEvents; // 已注册到 epoll 的事件
+    uint32_t m_missedEvents; // 边沿触发下因为不关心而丢弃的事件
     int m_index;  // 在Poller中的状态（kNew=-1, kAdded=1, kDeleted=2）
 
     //回调
@@ -74,6 +116,9 @@ private:
 
     bool m_eventHandling; // 是否正在处理事件
 
+    std::weak_ptr<void> m_tie; // 拥有者
+    bool m_tied;
+
 };
 
 }
\ No newline at end of file
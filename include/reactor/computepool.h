@@ -0,0 +1,93 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "callbacks.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace reactor
+{
+
+// ComputePool 是给 CPU 密集任务用的工作窃取线程池（与 I/O 的 EventLoopThreadPool 分开）
+// 职责：
+// 1. 执行从 EventLoop 卸载的计算（压缩、解析、加解密），不阻塞 Loop 上的其他连接
+// 2. 结果由 EventLoop::offload 通过 queueInLoop 送回发起的 Loop
+//
+// 实现细节：
+// - 每个工作线程一个双端队列；外部线程提交的任务轮流放到各个队列尾部，
+//   工作线程中提交的任务放到自己的队列尾部
+// - 工作线程从自己队列的头部取任务（先提交先执行，卸载的请求按顺序完成），
+//   自己的队列空了就从其他队列的尾部窃取
+// - 队列各自加锁，只有自己和窃取者竞争；所有队列都空时在条件变量上休眠，
+//   提交者只在有线程休眠时才加锁唤醒
+// - 析构时执行完已提交的任务再退出
+//
+// 使用示例：
+//   ComputePool compute("compress");
+//   compute.setThreadNum(4);
+//   compute.start();
+//   loop->setComputePool(&compute);
+//   loop->offload([data] { return compress(data); },
+//                 [conn](std::string out) { conn->send(out); });
+class ComputePool : private NonCopyable
+{
+public:
+    // setThreadNum(kAutoThreadNum)：按 cgroup CPU 配额和亲和性掩码决定线程数
+    static constexpr int kAutoThreadNum = -1;
+
+    explicit ComputePool(std::string name = "ComputePool");
+    ~ComputePool();
+
+    // 设置线程数（必须在start()前调用）
+    void setThreadNum(int num) { m_threadNum = num; }
+    void start();
+    // 等已提交的任务执行完后停止全部线程（析构时自动调用）
+    void stop();
+
+    // 提交任务，任意线程可调用（必须在start()之后、stop()之前）
+    void submit(Functor task);
+
+    int numThreads() const { return static_cast<int>(m_workers.size()); }
+    const std::string& name() const { return m_name; }
+
+    // 统计（近似值，任意线程可读）
+    size_t pendingTasks() const { return m_queued.load(std::memory_order_relaxed); }
+    uint64_t executedTasks() const;
+    uint64_t stolenTasks() const;
+
+private:
+    struct alignas(64) Worker
+    {
+        std::mutex mtx;
+        std::deque<Functor> tasks;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::thread thread;
+    };
+
+    void workerFunc(size_t index);
+    bool popLocal(size_t index, Functor* task);
+    bool steal(size_t thief, Functor* task);
+    void push(size_t index, Functor task);
+
+    const std::string m_name;
+    int m_threadNum;
+    bool m_started;
+    std::atomic<bool> m_stopping;
+    std::atomic<size_t> m_queued; // 所有队列中的任务总数
+    std::atomic<size_t> m_next; // 外部提交的轮询位置
+    std::atomic<int> m_sleepers; // 正在（或即将）休眠的线程数
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCond;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+}// namespace reactor
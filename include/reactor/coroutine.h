@@ -0,0 +1,437 @@
+#pragma once
+
+// C++20 协程接口（可选）：库本身按 C++17 编译，只有包含本头文件的翻译单元需要 -std=c++20
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "reactor/coroutine.h requires C++20 coroutines (-std=c++20)"
+#endif
+
+#include "noncopyable.h"
+#include "eventloop.h"
+#include "channel.h"
+#include "framepool.h"
+#include "monotime.h"
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace reactor
+{
+
+// 在 EventLoop 上用协程代替回调状态机
+//
+// Task<T> 是惰性的协程：创建时不执行，被 co_await 或 spawn() 时才开始
+// - co_await task：在当前线程执行，结束后直接切回等待者（对称转移），返回值或异常传给等待者
+// - spawn(loop, task)：在 loop 线程开始执行，结束后自动释放（异常会 std::terminate）
+// - 协程帧从当前线程 Loop 的 FramePool 分配，稳定状态下不经过堆
+//
+// 在 Task 中可以等待：
+// - co_await readable(fd) / writable(fd)：一次性等待，每次注册、移除一个临时 Channel
+// - co_await asyncFd.readable() / writable()：同一个 fd 反复等待，Channel 常驻
+// - co_await sleepFor(d) / sleepUntil(t)：基于 TimerQueue
+// - co_await resumeOn(loop)：切换到 loop 线程继续执行（queueInLoop），已在该线程时不挂起
+//
+// 约束：
+// - 等待 fd 和定时器的 Task 必须运行在某个 EventLoop 线程上
+// - 挂起中的 Task 不能被销毁；Loop 退出时仍挂起的协程不会被恢复，帧也不会释放
+// - fd 就绪后协程在本轮的 pending 任务阶段恢复，而不是在 Channel 回调中，
+//   协程可以在恢复后销毁等待用的 Channel/AsyncFd
+
+template<typename T = void>
+class Task;
+
+namespace detail
+{
+
+inline EventLoop* currentLoop()
+{
+    EventLoop* loop = EventLoop::getEventLoopOfCurrentThread();
+    assert(loop != nullptr && "coroutine awaits fd/timer outside an EventLoop thread");
+    return loop;
+}
+
+class TaskPromiseBase
+{
+public:
+    static void* operator new(size_t size) { return FramePool::allocateFrame(size); }
+    static void operator delete(void* p, size_t size) { FramePool::deallocateFrame(p, size); }
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            TaskPromiseBase& promise = h.promise();
+            std::coroutine_handle<> next = promise.m_continuation ? promise.m_continuation : std::noop_coroutine();
+            if(promise.m_detached) h.destroy();
+            return next;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept
+    {
+        // 没有等待者可以接收异常
+        if(m_detached) std::terminate();
+        m_exception = std::current_exception();
+    }
+
+protected:
+    void rethrowIfFailed()
+    {
+        if(m_exception) std::rethrow_exception(m_exception);
+    }
+
+private:
+    template<typename>
+    friend class reactor::Task;
+
+    std::coroutine_handle<> m_continuation; // co_await 本 Task 的协程
+    std::exception_ptr m_exception;
+    bool m_detached = false;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void result() { rethrowIfFailed(); }
+};
+
+}// namespace detail
+
+template<typename T>
+class [[nodiscard]] Task
+{
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(Handle handle) noexcept : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if(m_handle) m_handle.destroy();
+    }
+
+    bool valid() const { return static_cast<bool>(m_handle); }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            Handle handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+                handle.promise().m_continuation = caller;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{m_handle};
+    }
+
+    // 在当前线程开始执行并交出帧的所有权，协程结束时帧自动释放
+    void detach() &&
+    {
+        Handle handle = std::exchange(m_handle, {});
+        handle.promise().m_detached = true;
+        handle.resume();
+    }
+
+private:
+    Handle m_handle;
+};
+
+namespace detail
+{
+
+template<typename T>
+inline Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}// namespace detail
+
+// 在 loop 线程启动 task（已在该线程时立即开始执行），任意线程可调用
+inline void spawn(EventLoop* loop, Task<void> task)
+{
+    loop->runInLoop([task = std::move(task)]() mutable { std::move(task).detach(); });
+}
+
+// co_await resumeOn(loop)：之后的代码在 loop 线程执行
+class ResumeOnAwaiter
+{
+public:
+    explicit ResumeOnAwaiter(EventLoop* loop) : m_loop(loop) {}
+
+    bool await_ready() const { return m_loop->isInLoopThread(); }
+    void await_suspend(std::coroutine_handle<> h) { m_loop->queueInLoop([h] { h.resume(); }); }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop* m_loop;
+};
+
+inline ResumeOnAwaiter resumeOn(EventLoop* loop)
+{
+    return ResumeOnAwaiter(loop);
+}
+
+// co_await sleepUntil(t) / sleepFor(d)：在当前 Loop 上挂起到时间点之后，已经到期时不挂起
+// slack 与 EventLoop::runAt 相同
+class SleepAwaiter
+{
+public:
+    SleepAwaiter(MonoTime deadline, Nanoseconds slack) : m_deadline(deadline), m_slack(slack) {}
+
+    bool await_ready() const { return m_deadline <= MonoClock::now(); }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        detail::currentLoop()->runAt(m_deadline, [h] { h.resume(); }, m_slack);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    MonoTime m_deadline;
+    Nanoseconds m_slack;
+};
+
+inline SleepAwaiter sleepUntil(MonoTime deadline, Nanoseconds slack = EventLoop::kDefaultTimerSlack)
+{
+    return SleepAwaiter(deadline, slack);
+}
+
+inline SleepAwaiter sleepFor(Nanoseconds delay, Nanoseconds slack = EventLoop::kDefaultTimerSlack)
+{
+    return SleepAwaiter(MonoClock::now() + delay, slack);
+}
+
+// co_await readable(fd) / writable(fd)：一次性等待 fd 可读/可写（或挂起、出错）
+// 等待期间 Channel 放在协程帧中，就绪时 epoll_ctl DEL；反复等待同一个 fd 用 AsyncFd
+class FdReadyAwaiter
+{
+public:
+    FdReadyAwaiter(int fd, bool write) : m_fd(fd), m_write(write) {}
+    FdReadyAwaiter(FdReadyAwaiter&& other) noexcept : m_fd(other.m_fd), m_write(other.m_write) {}
+
+    // 挂起中被销毁（所在的 Task 被销毁）时注销 Channel
+    ~FdReadyAwaiter()
+    {
+        if(m_handle) unregister();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        m_handle = h;
+        m_channel.emplace(detail::currentLoop(), m_fd);
+        auto ready = [this] { handleReady(); };
+        m_channel->setCloseCallback(ready);
+        m_channel->setErrorCallback(ready);
+        if(m_write)
+        {
+            m_channel->setWriteCallback(ready);
+            m_channel->enableWriting();
+        }
+        else
+        {
+            m_channel->setReadCallback(ready);
+            m_channel->enableReading();
+        }
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    void handleReady()
+    {
+        // 同一次通知可能同时触发错误和读写回调
+        if(!m_handle) return;
+        std::coroutine_handle<> h = std::exchange(m_handle, {});
+        unregister();
+        // Channel 正在 handleEvent 中，不能在这里恢复协程（恢复后 Channel 随 awaiter 销毁）
+        m_channel->ownerLoop()->queueInLoop([h] { h.resume(); });
+    }
+
+    void unregister()
+    {
+        m_channel->disableAll();
+        m_channel->remove();
+    }
+
+    int m_fd;
+    bool m_write;
+    std::coroutine_handle<> m_handle;
+    std::optional<Channel> m_channel;
+};
+
+inline FdReadyAwaiter readable(int fd)
+{
+    return FdReadyAwaiter(fd, false);
+}
+
+inline FdReadyAwaiter writable(int fd)
+{
+    return FdReadyAwaiter(fd, true);
+}
+
+// AsyncFd 为一个 fd 保持常驻的 Channel，供协程反复等待（不拥有 fd）
+// - 就绪后保持关心的事件：协程处理完在本轮再次等待时不产生 epoll_ctl；
+//   没有协程在等的时候再次通知，才关闭该方向的事件
+// - 同一方向同时只能有一个协程等待
+// - 只能在所属 Loop 线程创建、使用和销毁；销毁时不能有协程在等待
+class AsyncFd : private NonCopyable
+{
+public:
+    class Awaiter
+    {
+    public:
+        Awaiter(AsyncFd* owner, bool write) : m_owner(owner), m_write(write) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { m_owner->wait(m_write, h); }
+        void await_resume() const noexcept {}
+
+    private:
+        AsyncFd* m_owner;
+        bool m_write;
+    };
+
+    AsyncFd(EventLoop* loop, int fd) : m_channel(loop, fd)
+    {
+        m_channel.setReadCallback([this] { handleRead(); });
+        m_channel.setWriteCallback([this] { handleWrite(); });
+        m_channel.setCloseCallback([this] { handleClose(); });
+        m_channel.setErrorCallback([this] { handleClose(); });
+    }
+
+    ~AsyncFd()
+    {
+        assert(!m_reader && !m_writer);
+        if(m_channel.index() >= 0)
+        {
+            m_channel.disableAll();
+            m_channel.remove();
+        }
+    }
+
+    int fd() const { return m_channel.fd(); }
+
+    Awaiter readable() { return Awaiter(this, false); }
+    Awaiter writable() { return Awaiter(this, true); }
+
+private:
+    void wait(bool write, std::coroutine_handle<> h)
+    {
+        if(write)
+        {
+            assert(!m_writer);
+            m_writer = h;
+            if(!m_channel.isWriting()) m_channel.enableWriting();
+        }
+        else
+        {
+            assert(!m_reader);
+            m_reader = h;
+            if(!m_channel.isReading()) m_channel.enableReading();
+        }
+    }
+
+    void handleRead()
+    {
+        if(m_reader)
+            wake(m_reader);
+        else
+            m_channel.disableReading();
+    }
+
+    void handleWrite()
+    {
+        if(m_writer)
+            wake(m_writer);
+        else
+            m_channel.disableWriting();
+    }
+
+    // 挂起或出错：两个方向的等待者都恢复，由它们的读写调用得到结果
+    void handleClose()
+    {
+        if(!m_reader && !m_writer)
+        {
+            m_channel.disableAll();
+            return;
+        }
+        if(m_reader) wake(m_reader);
+        if(m_writer) wake(m_writer);
+    }
+
+    void wake(std::coroutine_handle<>& waiter)
+    {
+        std::coroutine_handle<> h = std::exchange(waiter, {});
+        m_channel.ownerLoop()->queueInLoop([h] { h.resume(); });
+    }
+
+    Channel m_channel;
+    std::coroutine_handle<> m_reader;
+    std::coroutine_handle<> m_writer;
+};
+
+}// namespace reactor
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "monotime.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace reactor
+{
+
+// CountDownLatch 倒计数屏障
+// 职责：
+// 1. 构造时给定计数，countDown() 递减，减到0时唤醒所有 wait()
+// 2. 用作 EventLoopThreadPool::broadcastWithBarrier() 的完成屏障：每个 Loop 执行完任务后 countDown()
+class CountDownLatch : private NonCopyable
+{
+public:
+    explicit CountDownLatch(int count) : m_count(count) {}
+
+    void countDown();
+    void wait();
+    // 超时返回 false
+    bool waitFor(Nanoseconds timeout);
+    int count() const;
+
+private:
+    mutable std::mutex m_mtx;
+    std::condition_variable m_cond;
+    int m_count;
+};
+
+}// namespace reactor
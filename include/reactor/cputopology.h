@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace reactor
+{
+
+// EventLoopThread 的 CPU 放置策略
+enum class CpuPlacement
+{
+    kNone,          // 不绑定，由调度器决定（默认）
+    kExplicit,      // 第 i 个线程绑定到 cpus[i % cpus.size()]
+    kPhysicalCores, // 每个物理核一个线程（跳过超线程兄弟），按顺序循环分配
+    kNumaNode,      // 所有线程绑定到 numaNode 的全部 CPU，由调度器在节点内调度
+};
+
+struct CpuPlacementPolicy
+{
+    CpuPlacement mode = CpuPlacement::kNone;
+    std::vector<int> cpus; // kExplicit 使用
+    int numaNode = 0; // kNumaNode 使用
+};
+
+// CpuTopology 读取当前进程可用的 CPU 信息（sysfs/procfs/cgroup）
+// - 所有结果都已经和进程的亲和性掩码（sched_getaffinity）取交集
+// - 读取失败时退化为保守结果并记录警告，不会终止进程
+class CpuTopology
+{
+public:
+    // 进程允许运行的 CPU（sched_getaffinity）
+    static std::vector<int> allowedCpus();
+
+    // 每个物理核取一个逻辑 CPU（按 package/core_id 去重）
+    static std::vector<int> physicalCores();
+
+    // NUMA 节点上的 CPU（/sys/devices/system/node/nodeN/cpulist）
+    static std::vector<int> numaNodeCpus(int node);
+
+    // cgroup CPU 配额折算的核数（v2 cpu.max，v1 cfs_quota_us/cfs_period_us，向上取整），
+    // 没有限制时返回0
+    static int cgroupCpuLimit();
+
+    // 实际可用的并行度：min(亲和性掩码中的 CPU 数, cgroup 配额)，至少为1
+    static int availableCpus();
+
+    // 按策略算出第 index 个线程应绑定的 CPU 集合，空表示不绑定
+    static std::vector<int> cpusForThread(const CpuPlacementPolicy& policy, int index);
+
+    // 绑定当前线程到 cpus，失败记录错误日志并返回 false
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    // 解析内核 cpulist 格式，例如 "0-3,8,10-11"
+    static std::vector<int> parseCpuList(const std::string& list);
+};
+
+}// namespace reactor
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "poller.h"
+#include <sys/epoll.h>
+#include <vector>
+
+namespace reactor
+{
+
+// EPollPoller 基于 epoll 的 Poller 实现（默认后端）
+// - 每个 Channel 注册一次，关心的事件变化时 epoll_ctl MOD
+// - epoll_wait 返回的事件列表满了就翻倍扩容
+// - 已注册的 Channel 登记在按 fd 下标的数组里：fd 是从小到大复用的密集整数，
+//   登记和注销都是 O(1)，不为每个连接分配哈希表节点
+class EPollPoller : public Poller
+{
+public:
+    EPollPoller();
+    ~EPollPoller() override;
+
+    void poll(int timeoutMs, ChannelList* activeChannels) override;
+    void updateChannel(Channel* channel) override;
+    void removeChannel(Channel* channel) override;
+
+private:
+    void fillActiveChannels(int numEvents, ChannelList& activeChannels) const;
+    Channel* findChannel(int fd) const
+    {
+        return static_cast<size_t>(fd) < m_channels.size() ? m_channels[static_cast<size_t>(fd)] : nullptr;
+    }
+    void addChannel(int fd, Channel* channel);
+
+    int m_epollfd; // epoll文件描述符
+
+    using EventList = std::vector<struct epoll_event>;
+    EventList m_events; // epoll事件列表
+
+    // 管理所有的Channel
+    // 下标: 文件描述符, 值: Channel*（未登记为 nullptr），容量不足时按2倍扩容
+    using ChannelTable = std::vector<Channel*>;
+    ChannelTable m_channels;
+};
+
+}// namespace reactor
@@ -4,15 +4,23 @@
 #include "currentthread.h"
 #include "timerid.h"
 #include "callbacks.h"
+#include "eventloopoptions.h"
+#include "mpscqueue.h"
+#include "loopmetrics.h"
+#include "monotime.h"
 #include <memory>
 #include <vector>
 #include <atomic>
-#include <mutex>
+#include <type_traits>
 
 namespace reactor {
 
 class Channel;
 class Poller;
+class IoUringPoller;
+class PipePool;
+class FramePool;
+class ComputePool;
 class TimerQueue;
 class Timestamp;
 
@@ -29,7 +37,7 @@ class Timestamp;
 class EventLoop : private NonCopyable
 {
 public:
-    explicit EventLoop();
+    explicit EventLoop(const EventLoopOptions& options = EventLoopOptions());
     ~EventLoop();
 
     void loop(); // 启动事件循环
@@ -37,14 +45,24 @@ public:
     void updateChannel(Channel* channel); // 更新 Channel
     void removeChannel(Channel* channel); // 移除 Channel
 
+    // 定时器容差：回调可以在到期后 slack 之内的任意时刻执行（不会提前），
+    // 到期时间相近的定时器因此合并为一次唤醒、一次 timerfd_settime
+    // kDefaultTimerSlack 表示使用 EventLoopOptions::timerSlackMicroseconds
+    static constexpr Nanoseconds kDefaultTimerSlack = Nanoseconds(-1);
+
     // 新增：在指定时间运行回调
+    // 定时器基于单调时钟；传入墙上时间时按调用时刻与当前墙上时间的差值换算，
+    // 之后系统时间的跳变不影响到期时间
+    TimerId runAt(MonoTime time, TimerCallback cb, Nanoseconds slack = kDefaultTimerSlack);
     TimerId runAt(Timestamp time, TimerCallback cb);
     
-    // 新增：在delay秒后运行回调
-    TimerId runAfter(double delay, TimerCallback cb);
+    // 新增：在delay后运行回调
+    TimerId runAfter(Nanoseconds delay, TimerCallback cb, Nanoseconds slack = kDefaultTimerSlack);
+    TimerId runAfter(double delaySeconds, TimerCallback cb) { return runAfter(secondsToDuration(delaySeconds), std::move(cb)); }
     
-    // 新增：每隔interval秒运行回调
-    TimerId runEvery(double interval, TimerCallback cb);
+    // 新增：每隔interval运行回调
+    TimerId runEvery(Nanoseconds interval, TimerCallback cb, Nanoseconds slack = kDefaultTimerSlack);
+    TimerId runEvery(double intervalSeconds, TimerCallback cb) { return runEvery(secondsToDuration(intervalSeconds), std::move(cb)); }
     
     // 新增：取消定时器
     void cancel(TimerId timerId);
@@ -52,10 +70,32 @@ public:
     // 新增：在Loop线程执行回调（跨线程调用安全）
     // 如果在Loop线程调用，直接执行
     // 如果在其他线程调用，加入队列
+    // 队列是无锁的；只有Loop正在（或即将）阻塞在 epoll_wait 时才会写 eventfd，
+    // 并发的多次投递只会触发一次写
     void runInLoop(Functor cb);
     void queueInLoop(Functor cb);
+    // 一次加入一组任务：只有一次成功的 CAS、最多一次 eventfd 写，按给定顺序执行
+    void queueInLoopBatch(std::vector<Functor> tasks);
     void wakeup();
 
+    // 计算卸载：work 在 ComputePool 的线程中执行，continuation(work()) 经 queueInLoop 回到本 Loop 执行
+    // （work 返回 void 时调用 continuation()），Loop 不会被几毫秒的计算阻塞
+    // 没有设置 ComputePool 时 work 在调用线程直接执行，continuation 仍然经 queueInLoop
+    // 任意线程可调用；continuation 执行完之前本 Loop 不能销毁（pendingOffloads() 计入，
+    // EventLoopThreadPool 退役 Loop 时会等它归零）
+    template<typename Work, typename Continuation>
+    void offload(Work work, Continuation continuation);
+    // 设置卸载使用的 ComputePool（EventLoopThreadPool::setComputePool 会设置到全部 Loop）
+    void setComputePool(ComputePool* pool) { m_computePool.store(pool, std::memory_order_release); }
+    ComputePool* computePool() const { return m_computePool.load(std::memory_order_acquire); }
+
+    // 在本轮事件和 pending 任务都处理完之后、下一次 poll 之前执行（只能在 Loop 线程调用）
+    // 用于把本轮产生的多次输出合并成一次系统调用（TcpConnection 的延迟发送）；
+    // 执行期间再加入的回调同一轮执行
+    void runAfterDispatch(Functor cb);
+    // 是否正在处理本轮的事件或 pending 任务，此时 runAfterDispatch 的回调一定会在本轮执行
+    bool dispatching() const { return m_dispatching; }
+
     // 判断当前线程是否是Loop线程
     bool isInLoopThread() const
     {
@@ -70,28 +110,133 @@ public:
         }
     }
 
+    // 本轮 poll 返回时读取的单调时间，只能在 Loop 线程读取
+    // 回调中需要当前时间时用它代替再次读时钟；比真实时间晚本轮已经执行的回调耗时
+    MonoTime now() const { return m_now; }
+
+    // 当前使用的 Poller（只读，用于统计）
+    const Poller* poller() const { return m_poller.get(); }
+    // 定时器队列（只读，用于统计 timerfd 的设置和唤醒次数）
+    const TimerQueue* timerQueue() const { return m_timerQueue.get(); }
+
+    // io_uring 后端的完成式读写接口，epoll 后端（或 io_uring 不可用回退）时为 nullptr
+    // 只能在 Loop 线程使用
+    IoUringPoller* ioUring() const { return m_ioUring; }
+
+    // splice 转发使用的中转管道缓存，第一次使用时创建，只能在 Loop 线程使用
+    PipePool* pipePool();
+
+    // 协程帧缓存（reactor/coroutine.h），第一次使用时创建，只能在 Loop 线程使用
+    FramePool* framePool();
+
+    // 负载指标（任意线程可读，近似值），供 EventLoopThreadPool 选择 Loop
+    // 已注册到 Poller 的 Channel 数（包括内部的 wakeup/timerfd）
+    size_t numChannels() const { return m_numChannels.load(std::memory_order_relaxed); }
+    // 已投递还没执行的任务数
+    size_t pendingTasks() const;
+    // 已经 offload() 但 continuation 还没执行完的数量
+    size_t pendingOffloads() const { return m_offloadsInFlight.load(std::memory_order_acquire); }
+    // 最近一个统计窗口（约100ms）中处理事件和任务的时间占比，0~1
+    double utilization() const;
+
+    // 运行时指标（EventLoopOptions::enableMetrics 为 false 时为 nullptr）
+    // 只能在 Loop 线程记录；任意线程可以调用 metricsSnapshot()
+    LoopMetrics* metrics() const { return m_metrics.get(); }
+    LoopMetricsSnapshot metricsSnapshot() const;
+
     // 获取当前线程的EventLoop指针
     // 如果当前线程没有EventLoop，返回nullptr
     static EventLoop* getEventLoopOfCurrentThread();
 
 private:
+    // pending任务节点，侵入式链接在 MpscQueue 中
+    struct PendingTask
+    {
+        std::atomic<PendingTask*> next{nullptr};
+        Functor fn;
+        int64_t enqueueNs = 0; // 投递时间，只在开启指标且被采样时记录，0表示未采样
+        bool remote = false; // 由其他线程分配，执行完归还给生产者
+    };
+    struct TaskCache; // 生产者线程私有的空闲节点链表
+
     void abortNotInLoopThread();
+    void submitCompute(Functor task);
     void handleReadForWakeupFd(); //处理wakeupfd读事件
     void doPendingFunctors();
+    void doAfterDispatch();
+    void updateUtilization(int64_t nowNs, int64_t busyNs);
+    bool busyPoll(int64_t beginNs);
+    PendingTask* allocTask();
+    void recycleTask(PendingTask* task);
+    static TaskCache& producerTaskCache();
 
     using ChannelList = std::vector<Channel*>;
 
     std::atomic<bool> m_isLooping; // 是否正在循环中
     std::atomic<bool> m_quit; // 是否退出循环
-    std::atomic<bool> m_callingPendingFunctors;
+    std::atomic<bool> m_sleeping; // Loop 正在或即将阻塞在 epoll_wait 中
+    std::atomic<bool> m_wakeupPending; // 本轮已有生产者写过 eventfd，其他生产者无需再写
+    bool m_dispatching; // 正在处理本轮的事件和 pending 任务（Loop 线程私有）
+
+    // 负载计数（Loop 线程或生产者写，任意线程读）
+    // 必须在 m_timerQueue 之前初始化：TimerQueue 构造时就会注册 timerfd
+    std::atomic<size_t> m_numChannels;
+    std::atomic<size_t> m_tasksQueued; // 累计投递的任务数（生产者递增）
+    std::atomic<size_t> m_tasksDone; // 累计执行的任务数（Loop 线程写）
+    std::atomic<uint32_t> m_utilizationPermille; // 最近窗口的利用率，千分比
+    std::atomic<int64_t> m_pollBeginNs; // 本次 poll 开始的时间（steady clock）
+    int64_t m_windowBeginNs; // 当前统计窗口开始时间（Loop 线程私有）
+    int64_t m_windowBusyNs; // 当前窗口内的忙碌时间（Loop 线程私有）
+    std::unique_ptr<LoopMetrics> m_metrics; // 必须在 m_timerQueue 之前初始化
+    MonoTime m_now; // 本轮 poll 返回的时间（Loop 线程私有）
+    const Nanoseconds m_timerSlack; // 默认定时器容差
+    const int64_t m_busyPollNs; // 忙轮询预算，0表示关闭
+    const bool m_busyPollYield;
     const pid_t m_threadId; // 创建 EventLoop 的线程 ID
     std::unique_ptr<Poller> m_poller; // Poller 实例
+    IoUringPoller* const m_ioUring; // m_poller 是 io_uring 后端时指向它
     std::unique_ptr<TimerQueue> m_timerQueue; // TimerQueue 实例
-    ChannelList m_activeChannels; // 活跃的 Channel 列表
+    ChannelList m_activeChannels; // 活跃的 Channel 列表（跨迭代复用容量）
+    std::vector<Functor> m_afterDispatch; // 本轮结束时执行的回调（跨迭代复用容量）
+    std::vector<Functor> m_runningAfterDispatch; // 正在执行的一批
     int m_wakeupFd; //eventfd
     std::unique_ptr<Channel> m_wakeupChannle;
-    std::mutex m_mtx;
-    std::vector<Functor> m_pendingFactors;
+    MpscQueue<PendingTask> m_pendingTasks; // 跨线程投递的任务
+    std::unique_ptr<PipePool> m_pipePool; // 按需创建
+    std::unique_ptr<FramePool> m_framePool; // 按需创建
+    std::atomic<ComputePool*> m_computePool; // offload() 使用，不拥有
+    std::atomic<size_t> m_offloadsInFlight; // submitCompute 递增，continuation 执行完后递减
+
+    // Loop 线程私有的空闲任务节点链表
+    // 执行完的节点放回这里，Loop 线程内的 queueInLoop 直接复用，不需要分配
+    PendingTask* m_freeTasks;
+    size_t m_freeTaskCount;
+    // 其他线程投递的节点执行完后压入这个栈（只有 Loop 线程 push），
+    // 生产者本地缓存用完时用一次 exchange 整个取走，不存在 ABA
+    std::atomic<PendingTask*> m_remoteFreeTasks;
+    size_t m_remoteFreeCount; // 栈中节点数的上界（Loop 线程私有）
 };
 
-}
\ No newline at end of file
+template<typename Work, typename Continuation>
+void EventLoop::offload(Work work, Continuation continuation)
+{
+    submitCompute([this, work = std::move(work), continuation = std::move(continuation)]() mutable {
+        if constexpr (std::is_void<decltype(work())>::value)
+        {
+            work();
+            queueInLoop([this, continuation = std::move(continuation)]() mutable {
+                continuation();
+                m_offloadsInFlight.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        else
+        {
+            queueInLoop([this, continuation = std::move(continuation), result = work()]() mutable {
+                continuation(std::move(result));
+                m_offloadsInFlight.fetch_sub(1, std::memory_order_release);
+            });
+        }
+    });
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace reactor
+{
+
+// 定时器后端
+enum class TimerBackend
+{
+    kOrderedSet,  // 有序集合（红黑树）：精确到微秒，插入/取消 O(log n)
+    kTimingWheel, // 分层时间轮：按 tick 粒度到期，插入/取消 O(1)，适合海量超时定时器
+};
+
+// IO 多路复用后端
+enum class PollerBackend
+{
+    kEpoll,   // epoll：默认，所有内核可用
+    kIoUring, // io_uring：批量提交关心事件的变化，并提供完成式读写；不可用时回退到 epoll
+};
+
+// EventLoop 的构造参数
+// 由 EventLoopThread / EventLoopThreadPool 透传给工作线程中的 EventLoop
+struct EventLoopOptions
+{
+    TimerBackend timerBackend = TimerBackend::kOrderedSet;
+    int64_t timingWheelTickMicroseconds = 1000; // 时间轮 tick 粒度，默认1毫秒
+    // 定时器默认容差：允许晚于到期时间多久触发，用于合并相近的唤醒（有序集合后端），0表示尽量准时
+    int64_t timerSlackMicroseconds = 0;
+    PollerBackend pollerBackend = PollerBackend::kEpoll;
+    unsigned ioUringEntries = 256; // io_uring 提交队列长度
+    // 忙轮询：阻塞等待之前，先用非阻塞 poll 和任务队列检查空转这么久（微秒），0表示关闭
+    // 省掉休眠/唤醒的开销，代价是空闲时占满一个 CPU，适合绑核的低延迟 Loop
+    int64_t busyPollMicroseconds = 0;
+    bool busyPollYield = true; // 空转时定期 sched_yield()，与其他线程共享 CPU 时需要
+    // 记录 LoopMetrics 直方图：每轮多读几次时钟，每16个投递的任务采样一次排队延迟（投递方多读一次时钟）
+    bool enableMetrics = false;
+};
+
+}// namespace reactor
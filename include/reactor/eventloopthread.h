@@ -1,10 +1,12 @@
 #pragma once
 
 #include "noncopyable.h"
+#include "eventloopoptions.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <string>
+#include <vector>
 
 namespace reactor 
 {
@@ -25,9 +27,13 @@ class EventLoop;
 class EventLoopThread : private NonCopyable
 {
 public:
-    explicit EventLoopThread();
+    explicit EventLoopThread(const EventLoopOptions& options = EventLoopOptions());
     ~EventLoopThread();
 
+    // 绑定线程到指定 CPU（必须在startLoop()前调用），空表示不绑定
+    // 在新线程中创建 EventLoop 之前绑定，Loop 的内存都分配在绑定后的 CPU 上
+    void setCpuAffinity(std::vector<int> cpus) { m_cpus = std::move(cpus); }
+
     // 启动线程，返回EventLoop指针
     // 会阻塞直到EventLoop创建完成
     EventLoop* startLoop();
@@ -37,6 +43,8 @@ private:
 
 private:
     EventLoop* m_loop;
+    const EventLoopOptions m_options; // 传给线程中创建的 EventLoop
+    std::vector<int> m_cpus; // 绑定的 CPU
     std::thread m_thread;
     std::mutex m_mtx;
     std::condition_variable m_cond;
@@ -1,21 +1,59 @@
 #pragma once
 
 #include "noncopyable.h"
+#include "eventloopoptions.h"
+#include "cputopology.h"
+#include "loopmetrics.h"
+#include "callbacks.h"
+#include "countdownlatch.h"
+#include "monotime.h"
+#include "timerid.h"
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <utility>
 
 namespace reactor 
 {
 
 class EventLoop;
 class EventLoopThread;
+class ComputePool;
+
+// getNextLoop() 的选择策略
+// 负载指标由各个 EventLoop 以原子计数发布（numChannels/pendingTasks/utilization），读取是近似的
+enum class LoadBalance
+{
+    kRoundRobin,         // 轮询（默认）
+    kLeastChannels,      // 注册 Channel 最少（适合长连接数均衡）
+    kShortestQueue,      // 待执行任务最少
+    kLowestUtilization,  // 最近利用率最低
+    kPowerOfTwoChoices,  // 随机选两个，取利用率较低者（相同时取 Channel 较少者），O(1)
+};
+
+// 按 Loop 利用率自动扩缩容的参数（EventLoopThreadPool::enableAutoscale）
+// 每个 interval 计算一次工作 Loop 的平均利用率（EventLoop::utilization()）：
+// - 连续 stableIntervals 次高于 scaleUpUtilization 且未到 maxThreads：加一个 Loop
+// - 连续 stableIntervals 次低于 scaleDownUtilization、高于 minThreads、没有正在退役的 Loop，
+//   并且退役后剩余 Loop 的预计利用率仍低于 scaleUpUtilization：退役 Channel 最少的 Loop
+struct AutoscaleOptions
+{
+    int minThreads = 1;
+    int maxThreads = 8;
+    double scaleUpUtilization = 0.75;
+    double scaleDownUtilization = 0.25;
+    Nanoseconds interval = std::chrono::seconds(1);
+    int stableIntervals = 3;
+};
 
 // EventLoopThreadPool 管理一组EventLoopThread
 // 职责：
 // 1. 创建和管理多个工作线程
-// 2. 提供负载均衡（Round-Robin）
+// 2. 提供负载均衡（默认 Round-Robin，可选按负载选择，或按 key 哈希保持会话亲和）
 // 3. 统一启动和停止
+// 4. 运行时增加、退役工作 Loop，可选按利用率自动扩缩容
 
 //EventLoopThreadPool要和baseloop在一个线程中使用
 // 使用示例：
@@ -33,20 +71,115 @@ public:
     explicit EventLoopThreadPool(EventLoop* baseloop);
     ~EventLoopThreadPool();
 
+    // setThreadNum(kAutoThreadNum)：按 cgroup CPU 配额和亲和性掩码自动决定线程数
+    // （NUMA 放置时不超过节点的 CPU 数）
+    static constexpr int kAutoThreadNum = -1;
+
      // 设置线程数（必须在start()前调用）
     void setThreadNum(int nums) { m_threadNums = nums; }
+    // 设置工作线程的 CPU 放置策略（必须在start()前调用），线程在进入 loop() 之前绑定
+    void setCpuPlacement(const CpuPlacementPolicy& policy) { m_placement = policy; }
+    // 设置工作线程 EventLoop 的构造参数（必须在start()前调用）
+    void setLoopOptions(const EventLoopOptions& options) { m_loopOptions = options; }
+    // 只对第 index 个工作线程使用另外的参数，例如只让部分 Loop 忙轮询（必须在start()前调用）
+    void setLoopOptions(int index, const EventLoopOptions& options);
+    // 设置 EventLoop::offload 使用的计算线程池，start() 时设置到 baseLoop 和全部工作 Loop（不拥有）
+    void setComputePool(ComputePool* pool) { m_computePool = pool; }
     void start();
-    EventLoop* getNextLoop();  //TODO实现负载均衡
+    // 选择策略（必须在start()前调用）
+    void setLoadBalance(LoadBalance strategy) { m_strategy = strategy; }
+    LoadBalance loadBalance() const { return m_strategy; }
+
+    // 按策略选择下一个Loop（不会选中正在退役的 Loop）
+    EventLoop* getNextLoop();
+    // 同一个 key 总是得到同一个 Loop（会话亲和），与策略无关
+    // Loop 数变化后映射会改变
+    EventLoop* getLoopForHash(uint64_t hashCode);
+    // 可以分配新工作的 Loop（不含正在退役的）
     std::vector<EventLoop*> getAllLoops();
     bool started() const { return m_started; }
 
+    // 运行时扩缩容（start() 之后，只能在 baseLoop 线程调用）
+    // 增加一个工作 Loop 并立即参与 getNextLoop() 的选择
+    // 线程的 CPU 放置和 Loop 参数按最小的空闲下标取，退役后再加入的线程沿用原来的 CPU
+    EventLoop* addLoop();
+    // 开始退役 loop（nullptr 表示最后加入的 Loop），返回 false 表示不是可退役的工作 Loop
+    // 1. 立即不再被 getNextLoop()/getLoopForHash() 选中
+    // 2. 在该 Loop 线程调用 setRetiringCallback() 设置的回调，由使用者关闭或迁走上面的连接
+    // 3. 等它的 Channel 数回到刚启动时的基线、没有待执行的任务和未完成的 offload()（每 kDrainCheckInterval 检查一次），
+    //    之后不再接收 broadcast，已投递的任务全部执行完后调用 setRetiredCallback() 设置的回调并退出线程
+    // Loop 退出后 EventLoop* 失效，使用者不能再向它投递任务
+    bool retireLoop(EventLoop* loop = nullptr);
+    using LoopCallback = std::function<void(EventLoop*)>;
+    void setRetiringCallback(LoopCallback cb) { m_retiringCallback = std::move(cb); }
+    void setRetiredCallback(LoopCallback cb) { m_retiredCallback = std::move(cb); }
+    // 参与选择的 Loop 数 / 正在退役的 Loop 数
+    int numLoops() const { return static_cast<int>(m_loops.size()); }
+    int numRetiring() const { return static_cast<int>(m_workers.size() - m_loops.size()); }
+
+    // 按利用率自动扩缩容（只能在 baseLoop 线程调用，start() 之前调用时在 start() 中开始）
+    void enableAutoscale(const AutoscaleOptions& options);
+    void disableAutoscale();
+
+    static constexpr Nanoseconds kDrainCheckInterval = std::chrono::milliseconds(100);
+
+    // 把任务投递到每个工作 Loop，包括正在退役但还没排空的（没有工作线程时投递到 baseLoop），
+    // 每个 Loop 最多一次唤醒；投递到的 Loop 一定会在退出前执行它
+    // start() 之后任意线程可调用；fn 会被复制到每个 Loop
+    void broadcast(const SharedFunctor& fn);
+    // 同上，一组任务在每个 Loop 中按顺序执行，每个 Loop 只入队一次（queueInLoopBatch）
+    void broadcastBatch(const std::vector<SharedFunctor>& tasks);
+    // 同 broadcast()，返回的屏障在所有 Loop 都执行完 fn 后打开
+    // 不要在工作 Loop 线程中等待它，否则会死锁
+    std::shared_ptr<CountDownLatch> broadcastWithBarrier(const SharedFunctor& fn);
+
+    // 各工作 Loop 的指标快照及合并结果，start() 之后任意线程可调用
+    // （没有工作线程时返回 baseLoop 的指标）
+    PoolMetricsSnapshot metricsSnapshot() const;
+
 private:
+    // 一个工作线程，包括正在退役的
+    struct Worker
+    {
+        std::unique_ptr<EventLoopThread> thread;
+        EventLoop* loop;
+        int slot; // CPU 放置和 Loop 参数使用的下标
+        size_t idleChannels; // 刚启动时的 Channel 数（wakeupfd、timerfd 等内部 Channel）
+        bool retiring;
+        bool closed; // 已排空，不再接收 broadcast，等已投递的任务执行完后销毁
+    };
+
+    EventLoop* pickByLoad(double (*score)(const EventLoop*));
+    EventLoop* pickPowerOfTwo();
+    void checkRetiring(); // baseLoop 线程，定时检查正在退役的 Loop 是否已经排空
+    void autoscaleTick(); // baseLoop 线程
+    std::vector<EventLoop*> openLoopsLocked() const; // 还接收 broadcast 的工作 Loop，调用者持有 m_mutex
+
     EventLoop* m_baseloop;
     bool m_started;
     int m_threadNums;
+    CpuPlacementPolicy m_placement;
     int m_next;
-    std::vector<std::unique_ptr<EventLoopThread>> m_pool;
-    std::vector<EventLoop*> m_loops;
+    LoadBalance m_strategy;
+    uint64_t m_randomState; // power-of-two-choices 的 xorshift 状态
+    EventLoopOptions m_loopOptions;
+    std::vector<std::pair<int, EventLoopOptions>> m_loopOptionsOverrides; // (线程下标, 参数)
+    ComputePool* m_computePool;
+    LoopCallback m_retiringCallback;
+    LoopCallback m_retiredCallback;
+    TimerId m_drainTimer;
+    bool m_autoscaleEnabled;
+    AutoscaleOptions m_autoscale;
+    TimerId m_autoscaleTimer;
+    int m_aboveCount; // 连续高于扩容阈值的次数
+    int m_belowCount; // 连续低于缩容阈值的次数
+
+    // 只在 baseLoop 线程修改；其他线程（broadcast、metricsSnapshot）读取时持有 m_mutex，
+    // baseLoop 线程修改时持有 m_mutex，读取时不需要
+    // broadcast、metricsSnapshot 在持有 m_mutex 期间使用 EventLoop*，checkRetiring 持锁移除后才销毁 Loop
+    mutable std::mutex m_mutex;
+    std::vector<Worker> m_workers;
+    std::vector<EventLoop*> m_loops; // 参与选择的 Loop
 };
 
 }
\ No newline at end of file
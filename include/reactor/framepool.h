@@ -0,0 +1,58 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <cstddef>
+
+namespace reactor
+{
+
+// FramePool 是每个 EventLoop 的协程帧缓存（reactor/coroutine.h 的 Task 使用）
+// 职责：
+// 1. 按64字节分级缓存释放的内存块，Loop 上反复创建的短命协程不再每次 new/delete
+// 2. 每级最多缓存 maxIdlePerClass 块，超过的直接释放；大于 kMaxPooledSize 的不缓存
+//
+// 实现细节：
+// - 块总是按所在级别的大小分配，所以一个 Loop 分配的帧可以在另一个 Loop 上释放
+//   （co_await resumeOn 之后在别的线程结束），进入那个 Loop 的缓存
+// - allocateFrame/deallocateFrame 使用当前线程 Loop 的缓存，当前线程没有 Loop 时直接走堆
+// - 只能在所属 Loop 线程使用
+class FramePool : private NonCopyable
+{
+public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxPooledSize = 1024;
+    static constexpr size_t kNumClasses = kMaxPooledSize / kGranularity;
+    static constexpr size_t kDefaultMaxIdlePerClass = 256;
+
+    explicit FramePool(size_t maxIdlePerClass = kDefaultMaxIdlePerClass);
+    ~FramePool();
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+    size_t idle() const; // 缓存中的空闲块数
+    size_t hits() const { return m_hits; } // 从缓存取到的次数
+    size_t misses() const { return m_misses; } // 缓存为空、从堆分配的次数
+
+    // 协程 promise 的 operator new/delete 调用
+    static void* allocateFrame(size_t size);
+    static void deallocateFrame(void* p, size_t size);
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // 大小对应的级别，kNumClasses 表示不缓存
+    static size_t classOf(size_t size);
+    static size_t roundUp(size_t size);
+
+    const size_t m_maxIdlePerClass;
+    FreeBlock* m_free[kNumClasses];
+    size_t m_idle[kNumClasses];
+    size_t m_hits;
+    size_t m_misses;
+};
+
+}// namespace reactor
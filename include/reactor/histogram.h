@@ -0,0 +1,80 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace reactor
+{
+
+// HistogramSnapshot 是 Histogram 某一时刻的拷贝，可以合并、计算分位数
+struct HistogramSnapshot
+{
+    std::vector<uint64_t> counts; // 空表示没有任何样本
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+
+    double mean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count); }
+    // p 取 [0, 1]，返回所在桶的上界（相对误差不超过 1/16）
+    uint64_t percentile(double p) const;
+    void merge(const HistogramSnapshot& other);
+};
+
+// Histogram 是对数-线性分桶的直方图（HDR 风格）
+// - 每个2的幂区间再等分16个子桶，相对误差约6%，覆盖 uint64 全范围，共 976 个桶
+// - 单写者：record() 只能由一个线程调用（所属 Loop 线程），不使用原子读改写指令
+// - 任意线程可以 snapshot()，得到的是近似一致的拷贝
+class Histogram : private NonCopyable
+{
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    Histogram();
+
+    void record(uint64_t value)
+    {
+        bump(m_counts[bucketOf(value)], 1);
+        bump(m_count, 1);
+        bump(m_sum, value);
+        if(value < m_min.load(std::memory_order_relaxed)) m_min.store(value, std::memory_order_relaxed);
+        if(value > m_max.load(std::memory_order_relaxed)) m_max.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    HistogramSnapshot snapshot() const;
+
+    static int bucketOf(uint64_t value);
+    // 桶内最大值
+    static uint64_t bucketUpperBound(int bucket);
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_counts[kNumBuckets];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+inline int Histogram::bucketOf(uint64_t value)
+{
+    if(value < static_cast<uint64_t>(kSubBuckets))
+    {
+        return static_cast<int>(value);
+    }
+    int exponent = 63 - __builtin_clzll(value); // >= kSubBucketBits
+    int sub = static_cast<int>((value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+}// namespace reactor
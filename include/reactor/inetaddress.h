@@ -0,0 +1,45 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <cstdint>
+#include <string>
+
+namespace reactor
+{
+
+// InetAddress 封装 IPv4/IPv6 socket 地址
+// - 内部以 sockaddr_in / sockaddr_in6 联合体保存，按 family 区分
+// - 端口和地址以网络字节序保存，可以直接传给 bind/connect
+class InetAddress
+{
+public:
+    // 监听地址：loopbackOnly 为 true 时只监听回环地址
+    explicit InetAddress(uint16_t port = 0, bool loopbackOnly = false, bool ipv6 = false);
+
+    // ip 是点分十进制（IPv4）或冒号十六进制（IPv6）字符串，格式错误时记录错误日志
+    InetAddress(const std::string& ip, uint16_t port, bool ipv6 = false);
+
+    explicit InetAddress(const struct sockaddr_in& addr) : m_addr(addr) {}
+    explicit InetAddress(const struct sockaddr_in6& addr) : m_addr6(addr) {}
+
+    sa_family_t family() const { return m_addr.sin_family; }
+    std::string toIp() const;
+    std::string toIpPort() const;
+    uint16_t port() const;
+
+    const struct sockaddr* getSockAddr() const { return reinterpret_cast<const struct sockaddr*>(&m_addr6); }
+    socklen_t getSockAddrLen() const
+    {
+        return family() == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    }
+    void setSockAddrInet6(const struct sockaddr_in6& addr6) { m_addr6 = addr6; }
+
+private:
+    union
+    {
+        struct sockaddr_in m_addr;
+        struct sockaddr_in6 m_addr6;
+    };
+};
+
+}// namespace reactor
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "poller.h"
+#include "callbacks.h"
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace reactor
+{
+
+// IoUringPoller 基于 io_uring 的 Poller 实现（直接使用系统调用，不依赖 liburing）
+// 职责：
+// 1. 就绪通知：为每个关心事件的 Channel 提交一个单次 POLL_ADD，
+//    触发后在下一次 poll() 时重新提交，保持与 epoll 水平触发相同的语义
+// 2. 关心事件的变化只记录下来，在下一次 poll() 时和等待合并为一次 io_uring_enter
+// 3. 完成式读写：submitRead/submitWrite（可使用注册的固定缓冲区），完成后在 poll() 中回调
+//
+// 实现细节：
+// - user_data 编码（类型, 代数, fd/操作下标），Channel 被移除或重新注册后代数递增，
+//   旧请求迟到的完成事件直接丢弃
+// - 边沿触发的 Channel 在这里按关心的事件水平触发：读写到 EAGAIN 的回调行为不受影响
+// - 单次触发的 Channel 通知后不再提交 POLL_ADD，直到 rearm()
+// - 超时通过 IORING_ENTER_EXT_ARG 传入，需要 5.11 以上内核
+class IoUringPoller : public Poller
+{
+public:
+    // 创建失败（内核不支持、被 seccomp/sysctl 禁用等）返回 nullptr
+    static std::unique_ptr<IoUringPoller> create(unsigned entries);
+    ~IoUringPoller() override;
+
+    void poll(int timeoutMs, ChannelList* activeChannels) override;
+    void updateChannel(Channel* channel) override;
+    void removeChannel(Channel* channel) override;
+
+    // 注册固定缓冲区（整个 ring 只能注册一组），成功返回 true
+    bool registerBuffers(const struct iovec* iovecs, unsigned count);
+    void unregisterBuffers();
+
+    // 完成式读写，回调在 Loop 线程的 poll() 中执行，参数为字节数或 -errno
+    // 请求在下一次 poll() 时和其他请求一起提交；缓冲区在回调之前必须保持有效
+    void submitRead(int fd, void* buf, size_t len, IoCompletionCallback cb);
+    void submitWrite(int fd, const void* buf, size_t len, IoCompletionCallback cb);
+    // 使用 registerBuffers 注册的第 bufIndex 个缓冲区（buf 必须落在其中）
+    void submitReadFixed(int fd, void* buf, size_t len, int bufIndex, IoCompletionCallback cb);
+    void submitWriteFixed(int fd, const void* buf, size_t len, int bufIndex, IoCompletionCallback cb);
+
+private:
+    // 每个 fd 的就绪请求状态
+    struct PollEntry
+    {
+        Channel* channel = nullptr;
+        uint32_t generation = 0; // 每次取消/移除递增
+        uint32_t armedEvents = 0; // 正在等待的 POLL_ADD 的事件，0表示没有
+        bool fired = false; // 单次触发模式已通知，等待 rearm
+        bool dirty = false; // 已加入 m_dirty
+    };
+
+    // 完成式读写请求
+    struct IoOp
+    {
+        IoCompletionCallback callback;
+        uint32_t generation = 0;
+        uint32_t nextFree = 0;
+    };
+
+    IoUringPoller();
+    bool setup(unsigned entries);
+
+    struct io_uring_sqe* getSqe();
+    int enter(unsigned toSubmit, unsigned minComplete, int timeoutMs);
+    void markDirty(int fd);
+    void syncEntry(int fd);
+    void cancelPoll(int fd);
+    void handleCompletion(uint64_t userData, int res, ChannelList* activeChannels);
+    void submitOp(uint8_t opcode, int fd, const void* buf, size_t len, int bufIndex, IoCompletionCallback cb);
+    uint32_t allocOp();
+
+    int m_ringfd;
+    void* m_ringMem; // SQ/CQ 环（IORING_FEAT_SINGLE_MMAP）
+    size_t m_ringMemSize;
+    struct io_uring_sqe* m_sqes;
+    size_t m_sqesSize;
+
+    unsigned* m_sqHead;
+    unsigned* m_sqTail;
+    unsigned m_sqMask;
+    unsigned m_sqEntries;
+    unsigned m_sqLocalTail; // 本地已填写的尾部，io_uring_enter 之前发布
+    unsigned m_toSubmit; // 已填写未提交的 SQE 数
+
+    unsigned* m_cqHead;
+    unsigned* m_cqTail;
+    unsigned m_cqMask;
+    struct io_uring_cqe* m_cqes;
+
+    std::vector<PollEntry> m_entries; // 以 fd 为下标
+    std::vector<int> m_dirty; // 等待同步到内核的 fd
+
+    std::vector<IoOp> m_ops;
+    uint32_t m_freeOp; // 空闲链表头
+    bool m_buffersRegistered;
+};
+
+}// namespace reactor
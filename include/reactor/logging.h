@@ -0,0 +1,128 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace reactor
+{
+
+// 编译期最低日志级别，低于该级别的日志语句会被编译器整体消除
+// 0=TRACE 1=DEBUG 2=INFO 3=WARN 4=ERROR 5=FATAL
+// 可以通过 -DREACTOR_MIN_LOG_LEVEL=N 覆盖
+#ifndef REACTOR_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define REACTOR_MIN_LOG_LEVEL 2
+#else
+#define REACTOR_MIN_LOG_LEVEL 0
+#endif
+#endif
+
+// LogStream 把一行日志格式化到定长缓冲区中
+// - 不做任何堆分配
+// - 超出长度的部分直接截断，但始终为行尾的'\n'保留一个字节
+class LogStream : private NonCopyable
+{
+public:
+    static constexpr size_t kBufferSize = 512;
+
+    LogStream() : m_len(0) {}
+
+    LogStream& operator<<(bool v);
+    LogStream& operator<<(char v);
+    LogStream& operator<<(short v);
+    LogStream& operator<<(unsigned short v);
+    LogStream& operator<<(int v);
+    LogStream& operator<<(unsigned int v);
+    LogStream& operator<<(long v);
+    LogStream& operator<<(unsigned long v);
+    LogStream& operator<<(long long v);
+    LogStream& operator<<(unsigned long long v);
+    LogStream& operator<<(double v);
+    LogStream& operator<<(const void* p);
+    LogStream& operator<<(const char* str);
+    LogStream& operator<<(const std::string& str);
+
+    void append(const char* data, size_t len);
+    // 追加行尾换行符（使用保留的最后一个字节，总能成功）
+    void finishLine() { m_buf[m_len++] = '\n'; }
+
+    const char* data() const { return m_buf; }
+    size_t length() const { return m_len; }
+    size_t avail() const { return kBufferSize - 1 - m_len; }
+
+private:
+    template<typename T>
+    void formatInteger(T v);
+
+    char m_buf[kBufferSize];
+    size_t m_len;
+};
+
+// Logger 是一条日志记录的生命周期对象
+// 构造时写入前缀（时间、线程ID、级别），析构时把整行提交给后端
+//
+// 后端实现：
+// - 每个线程一个无锁 SPSC 环形缓冲区，写日志只是一次 memcpy
+// - 后台线程负责把所有缓冲区的内容批量 writev 到输出 fd
+// - 缓冲区满时丢弃日志（不阻塞热路径），丢弃数量由后台线程汇报
+// - FATAL 日志会同步刷出所有缓冲区后 abort()
+class Logger : private NonCopyable
+{
+public:
+    enum LogLevel
+    {
+        TRACE,
+        DEBUG,
+        INFO,
+        WARN,
+        ERROR,
+        FATAL,
+        NUM_LOG_LEVELS,
+    };
+
+    Logger(const char* file, int line, LogLevel level, const char* func);
+    // LOG_SYSERR / LOG_SYSFATAL：额外输出 errno 描述
+    Logger(const char* file, int line, bool toAbort);
+    ~Logger();
+
+    LogStream& stream() { return m_stream; }
+
+    static LogLevel logLevel() { return static_cast<LogLevel>(s_logLevel.load(std::memory_order_relaxed)); }
+    static void setLogLevel(LogLevel level) { s_logLevel.store(level, std::memory_order_relaxed); }
+
+    // 设置日志输出的文件描述符（默认 STDOUT_FILENO）
+    static void setOutputFd(int fd);
+
+    // 阻塞直到调用前已提交的日志全部写出
+    static void flush();
+
+private:
+    void formatPrefix(LogLevel level);
+
+    LogStream m_stream;
+    LogLevel m_level;
+    const char* m_file;
+    int m_line;
+    int m_savedErrno;
+
+    static std::atomic<int> s_logLevel;
+};
+
+const char* strerror_tl(int savedErrno);
+
+}// namespace reactor
+
+// 级别低于 REACTOR_MIN_LOG_LEVEL 时条件恒为假，整条语句（包括参数求值）被消除
+#define LOG_TRACE if (REACTOR_MIN_LOG_LEVEL <= 0 && ::reactor::Logger::logLevel() <= ::reactor::Logger::TRACE) \
+    ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::TRACE, __func__).stream()
+#define LOG_DEBUG if (REACTOR_MIN_LOG_LEVEL <= 1 && ::reactor::Logger::logLevel() <= ::reactor::Logger::DEBUG) \
+    ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::DEBUG, __func__).stream()
+#define LOG_INFO if (REACTOR_MIN_LOG_LEVEL <= 2 && ::reactor::Logger::logLevel() <= ::reactor::Logger::INFO) \
+    ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::INFO, __func__).stream()
+#define LOG_WARN ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::WARN, __func__).stream()
+#define LOG_ERROR ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::ERROR, __func__).stream()
+#define LOG_FATAL ::reactor::Logger(__FILE__, __LINE__, ::reactor::Logger::FATAL, __func__).stream()
+#define LOG_SYSERR ::reactor::Logger(__FILE__, __LINE__, false).stream()
+#define LOG_SYSFATAL ::reactor::Logger(__FILE__, __LINE__, true).stream()
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "histogram.h"
+#include <sys/types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace reactor
+{
+
+// LoopMetricsSnapshot 是某个 EventLoop（或多个 Loop 合并后）的指标拷贝
+// 时间单位都是纳秒
+struct LoopMetricsSnapshot
+{
+    pid_t threadId = 0; // 合并后的快照为0
+
+    HistogramSnapshot iterationNs; // 每轮循环耗时
+    HistogramSnapshot pollWaitNs; // 每轮阻塞在 poll 中的时间
+    HistogramSnapshot callbackNs; // 每轮处理事件、任务的时间
+    HistogramSnapshot eventsPerPoll; // 每次 poll 返回的活跃 Channel 数
+    HistogramSnapshot pendingDepth; // 每轮取出的 pending 任务数（只统计非空的轮次）
+    HistogramSnapshot taskLatencyNs; // queueInLoop 到任务开始执行的延迟
+    HistogramSnapshot timerLatenessNs; // 定时器实际执行时间 - 预定到期时间
+
+    uint64_t iterations() const { return iterationNs.count; }
+
+    void merge(const LoopMetricsSnapshot& other);
+
+    // 多行文本摘要：每个直方图一行 count/mean/p50/p99/max
+    std::string toString() const;
+};
+
+// EventLoopThreadPool 的指标：每个工作 Loop 一份，以及全部合并后的总计
+struct PoolMetricsSnapshot
+{
+    std::vector<LoopMetricsSnapshot> loops;
+    LoopMetricsSnapshot total;
+};
+
+// LoopMetrics 由 EventLoop 持有，只在 Loop 线程记录，任意线程 snapshot()
+class LoopMetrics : private NonCopyable
+{
+public:
+    Histogram iterationNs;
+    Histogram pollWaitNs;
+    Histogram callbackNs;
+    Histogram eventsPerPoll;
+    Histogram pendingDepth;
+    Histogram taskLatencyNs;
+    Histogram timerLatenessNs;
+
+    LoopMetricsSnapshot snapshot(pid_t threadId) const;
+};
+
+}// namespace reactor
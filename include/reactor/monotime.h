@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <type_traits>
+
+namespace reactor
+{
+
+// 定时器使用的时间基准
+// - MonoClock 是 std::chrono::steady_clock，libstdc++ 在 Linux 上用 CLOCK_MONOTONIC 实现，
+//   与 timerfd 使用同一个时钟，不受 NTP 调整和系统时间跳变影响
+// - 时间点和间隔都是整数纳秒，不经过浮点秒
+// - Timestamp（墙上时间）只用于日志和格式化输出
+using MonoClock = std::chrono::steady_clock;
+using MonoTime = MonoClock::time_point;
+using Nanoseconds = std::chrono::nanoseconds;
+
+static_assert(std::is_same<MonoClock::duration, Nanoseconds>::value, "steady_clock must tick in nanoseconds");
+
+// 表示“没有到期时间”，比任何真实时间都晚
+constexpr MonoTime kNoExpiration = MonoTime::max();
+
+inline int64_t toNanoseconds(MonoTime time)
+{
+    return time.time_since_epoch().count();
+}
+
+// 兼容以 double 秒为单位的接口，四舍五入到纳秒
+inline Nanoseconds secondsToDuration(double seconds)
+{
+    return Nanoseconds(std::llround(seconds * 1e9));
+}
+
+// CLOCK_MONOTONIC 的绝对时间，用于 timerfd_settime(TFD_TIMER_ABSTIME)
+inline struct timespec toTimespec(MonoTime time)
+{
+    int64_t ns = toNanoseconds(time);
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    return ts;
+}
+
+}// namespace reactor
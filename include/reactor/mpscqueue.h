@@ -0,0 +1,62 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <atomic>
+
+namespace reactor
+{
+
+// MpscQueue 侵入式无锁多生产者单消费者队列
+// 职责：
+// 1. 任意线程并发 push()，不加锁
+// 2. 消费者一次 takeAll() 取走当前全部节点，按 push 顺序返回
+//
+// 实现细节：
+// - 生产者用 CAS 把节点压到栈顶（Treiber 栈），消费者用一次 exchange 取走整个栈再反转
+// - 取走的是一个快照：执行过程中新加入的节点留到下一轮，天然避免任务自我重投导致的饥饿
+// - 节点类型 T 必须包含 std::atomic<T*> next 成员，队列不负责分配和释放节点
+// - push 使用 seq_cst，保证与消费者"先声明休眠、再检查 empty()"之间的 StoreLoad 顺序
+template<typename T>
+class MpscQueue : private NonCopyable
+{
+public:
+    MpscQueue() : m_head(nullptr) {}
+
+    // 加入单个节点（任意线程）
+    void push(T* node) { pushChain(node, node); }
+
+    // 一次性加入一条链（任意线程），只需一次成功的 CAS
+    // 链通过 next 从 newest 指向 oldest，消费时 oldest 先执行
+    void pushChain(T* newest, T* oldest)
+    {
+        T* head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            oldest->next.store(head, std::memory_order_relaxed);
+        } while (!m_head.compare_exchange_weak(head, newest,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed));
+    }
+
+    // 取走全部节点（只能由消费者调用），返回按 push 顺序排列的链表
+    T* takeAll()
+    {
+        T* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        T* reversed = nullptr;
+        while (node)
+        {
+            T* next = node->next.load(std::memory_order_relaxed);
+            node->next.store(reversed, std::memory_order_relaxed);
+            reversed = node;
+            node = next;
+        }
+        return reversed;
+    }
+
+    bool empty() const { return m_head.load(std::memory_order_seq_cst) == nullptr; }
+
+private:
+    std::atomic<T*> m_head; // 栈顶，最近一次 push 的节点
+};
+
+}// namespace reactor
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <cstddef>
+#include <vector>
+
+namespace reactor
+{
+
+// 一对非阻塞管道 fd，用作 splice 的内核中转缓冲区
+struct Pipe
+{
+    int readFd = -1;
+    int writeFd = -1;
+
+    bool valid() const { return readFd >= 0; }
+};
+
+// PipePool 是每个 EventLoop 的管道缓存
+// 职责：
+// 1. 为 splice 转发提供中转管道（TcpConnection::forwardTo），避免每条连接创建、关闭一次管道
+// 2. 归还的空管道留在空闲列表中复用，超过 maxIdle 的直接关闭
+//
+// 实现细节：
+// - 管道带 O_NONBLOCK | O_CLOEXEC 创建，容量使用内核默认值（通常 64KB）
+// - 归还时管道里还有数据（连接异常关闭）的不能复用，直接关闭
+// - 只能在所属 Loop 线程使用
+class PipePool : private NonCopyable
+{
+public:
+    static constexpr size_t kDefaultMaxIdle = 64;
+
+    explicit PipePool(size_t maxIdle = kDefaultMaxIdle) : m_maxIdle(maxIdle), m_created(0) {}
+    ~PipePool();
+
+    // 取一个空管道；创建失败（fd 耗尽）时返回无效的 Pipe
+    Pipe acquire();
+    // 归还管道，empty 表示管道中没有残留数据
+    void release(Pipe pipe, bool empty);
+
+    size_t idle() const { return m_idle.size(); }
+    size_t created() const { return m_created; } // 累计创建的管道数
+
+private:
+    static void closePipe(Pipe pipe);
+
+    const size_t m_maxIdle;
+    size_t m_created;
+    std::vector<Pipe> m_idle;
+};
+
+}// namespace reactor
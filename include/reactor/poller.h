@@ -1,43 +1,52 @@
 #pragma once
 
 #include "noncopyable.h"
-#include <sys/epoll.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
-#include <unordered_map>
 
 namespace reactor
 {
 
 class Channel;
-
+struct EventLoopOptions;
+
+// Poller 是 IO 多路复用的抽象接口，每个 EventLoop 持有一个
+// 实现：
+// - EPollPoller   基于 epoll（默认）
+// - IoUringPoller 基于 io_uring 的 POLL_ADD，另外提供完成式读写
+//
+// 所有接口只能在 Loop 线程调用
 class Poller : private NonCopyable
 {
 public:
     using ChannelList = std::vector<Channel*>;
 
     Poller();
-    ~Poller();
+    virtual ~Poller();
 
     // 等待事件发生
     // timeout: 超时时间（毫秒），-1表示永久阻塞
-    // 返回：活跃的Channel列表
-    ChannelList poll(int timeoutMs = -1);
+    // activeChannels: 由调用者持有并复用的输出列表（追加活跃Channel，不会清空）
+    virtual void poll(int timeoutMs, ChannelList* activeChannels) = 0;
+
+    virtual void updateChannel(Channel* channel) = 0;
+    virtual void removeChannel(Channel* channel) = 0;
 
-    void updateChannel(Channel* channel);
-    void removeChannel(Channel* channel);
-    
-private:
-    void fillActiveChannels(int numEvents, ChannelList& activeChannels) const;
+    // 累计的多路复用相关系统调用次数（epoll_wait/epoll_ctl 或 io_uring_enter）
+    uint64_t syscalls() const { return m_syscalls; }
 
-    int m_epollfd; // epoll文件描述符
+    // 按 options.pollerBackend 创建 Poller
+    // io_uring 不可用（内核太旧、被禁用）时打印警告并回退到 epoll
+    static std::unique_ptr<Poller> newPoller(const EventLoopOptions& options);
 
-    using EventList = std::vector<struct epoll_event>;
-    EventList m_events; // epoll事件列表
+protected:
+    // Channel 在 Poller 中的状态（Channel::index()）
+    static constexpr int kNew = -1;     // Channel未添加到Poller
+    static constexpr int kAdded = 1;    // Channel已添加到Poller
+    static constexpr int kDeleted = 2;  // Channel已从Poller删除（不再关心任何事件）
 
-    // 管理所有的Channel
-    // key: 文件描述符, value: Channel*
-    using ChannelMap = std::unordered_map<int, Channel*>;
-    ChannelMap m_channels; // 管理Channel的映射表
+    uint64_t m_syscalls;
 };
 
-}
\ No newline at end of file
+}// namespace reactor
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "noncopyable.h"
+#include <sys/socket.h>
+
+namespace reactor
+{
+
+class InetAddress;
+
+// Socket 持有一个 socket fd（RAII，析构时关闭）
+// 只封装服务端用到的操作，出错时按严重程度记录日志：
+// bind/listen 失败直接终止，其余返回错误由调用者处理
+class Socket : private NonCopyable
+{
+public:
+    explicit Socket(int sockfd) : m_sockfd(sockfd) {}
+    ~Socket();
+
+    int fd() const { return m_sockfd; }
+
+    void bindAddress(const InetAddress& localAddr);
+    void listen();
+
+    // 成功返回非阻塞、close-on-exec 的连接 fd，并填写对端地址；失败返回 -1，errno 保留
+    int accept(InetAddress* peerAddr);
+
+    void shutdownWrite();
+
+    void setTcpNoDelay(bool on);
+    void setReuseAddr(bool on);
+    void setReusePort(bool on);
+    void setKeepAlive(bool on);
+
+    // 创建非阻塞 TCP socket，失败时终止
+    static int createNonblockingOrDie(sa_family_t family);
+    // 读取并清除 SO_ERROR
+    static int getSocketError(int sockfd);
+    static InetAddress getLocalAddr(int sockfd);
+    static InetAddress getPeerAddr(int sockfd);
+
+private:
+    const int m_sockfd;
+};
+
+}// namespace reactor
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "callbacks.h"
+#include "buffer.h"
+#include "inetaddress.h"
+#include "pipepool.h"
+#include <sys/types.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace reactor
+{
+
+class Channel;
+class EventLoop;
+class Socket;
+
+// TcpConnection 表示一条已建立的 TCP 连接
+// 职责：
+// 1. 持有连接 socket 和对应的 Channel，读写都在所属 ioLoop 中进行
+// 2. 输入缓冲区：可读时一次 readv 读入，交给 MessageCallback
+// 3. 输出缓冲区：send() 先尝试直接写，写不完的部分缓存起来，可写时继续发送
+// 4. 零拷贝输出：sendFile() 用 sendfile 发送文件区间，forwardTo() 用 splice 把收到的数据转发给另一条连接，
+//    数据不经过用户态；与 send() 的数据按调用顺序发送
+// 5. 延迟发送：在 ioLoop 处理事件和任务期间调用 send() 时只追加到输出缓冲区，
+//    本轮结束时（EventLoop::runAfterDispatch）一次写出，同一轮的多个小响应只需一次系统调用；
+//    内核发送缓冲区满时才关注可写事件
+//
+// 生命周期：
+// - 由 TcpServer 创建并以 shared_ptr 持有，Channel 通过 tie() 在事件处理期间保活
+// - 连接关闭时先回调 CloseCallback 让 TcpServer 移除，最后在 ioLoop 中 connectDestroyed()
+//
+// 线程安全：
+// - send()/shutdown()/forceClose() 可以在任意线程调用，通过 runInLoop 转到 ioLoop
+// - 其余接口只能在 ioLoop 中调用
+class TcpConnection : private NonCopyable, public std::enable_shared_from_this<TcpConnection>
+{
+public:
+    TcpConnection(EventLoop* loop, std::string name, int sockfd,
+                  const InetAddress& localAddr, const InetAddress& peerAddr);
+    ~TcpConnection();
+
+    EventLoop* getLoop() const { return m_loop; }
+    const std::string& name() const { return m_name; }
+    const InetAddress& localAddress() const { return m_localAddr; }
+    const InetAddress& peerAddress() const { return m_peerAddr; }
+    bool connected() const { return m_state == kConnected; }
+    bool disconnected() const { return m_state == kDisconnected; }
+
+    // 发送数据（任意线程）
+    void send(const void* data, size_t len);
+    void send(const std::string& message);
+    void send(Buffer* buf); // 发送后清空 buf
+
+    // 零拷贝发送文件的 [offset, offset + length) 区间（任意线程）
+    // 排在之前 send() 的数据之后；发送缓冲区满时等可写事件继续，不阻塞 Loop
+    // fd 在内部 dup，调用者可以随即关闭；文件比 length 短时发到文件末尾为止
+    void sendFile(int fd, off_t offset, size_t length);
+
+    // 把本连接收到的数据用 splice 经内核管道直接转发给 dst（代理场景，只能在 ioLoop 线程调用）
+    // - 两条连接必须属于同一个 ioLoop，中转管道取自该 Loop 的 PipePool
+    // - 转发期间不再回调 MessageCallback；dst 还有排队的输出时暂停读本连接，dst 写空后恢复
+    // - 本连接读到 EOF 时关闭 dst 的写端（dst->shutdown()），dst 已断开时关闭本连接
+    void forwardTo(const TcpConnectionPtr& dst);
+    void stopForwarding();
+    bool forwarding() const { return !m_forwardTarget.expired(); }
+
+    // 排队等待发送的字节数：输出缓冲区 + 待发送的文件 + 中转管道中的数据（只能在 ioLoop 线程调用）
+    size_t outputBytes() const;
+    // 累计的写系统调用次数（send/sendfile/splice 写出），用于统计
+    uint64_t writeSyscalls() const { return m_writeSyscalls; }
+
+    // 发送完输出缓冲区后关闭写端（任意线程）
+    void shutdown();
+    // 立即关闭连接，丢弃未发送的数据（任意线程）
+    void forceClose();
+
+    void setTcpNoDelay(bool on);
+    // 是否启用延迟发送（默认启用），关闭后每次 send() 都立即尝试写
+    void setDeferredSend(bool on) { m_deferredSend = on; }
+
+    void setConnectionCallback(ConnectionCallback cb) { m_connectionCallback = std::move(cb); }
+    void setMessageCallback(MessageCallback cb) { m_messageCallback = std::move(cb); }
+    void setWriteCompleteCallback(WriteCompleteCallback cb) { m_writeCompleteCallback = std::move(cb); }
+    void setHighWaterMarkCallback(HighWaterMarkCallback cb, size_t highWaterMark)
+    {
+        m_highWaterMarkCallback = std::move(cb);
+        m_highWaterMark = highWaterMark;
+    }
+    void setCloseCallback(CloseCallback cb) { m_closeCallback = std::move(cb); }
+
+    Buffer* inputBuffer() { return &m_inputBuffer; }
+    Buffer* outputBuffer() { return &m_outputBuffer; }
+
+    // 由 TcpServer 调用
+    void connectEstablished(); // 连接加入 ioLoop 后调用一次
+    void connectDestroyed(); // 从 TcpServer 移除后调用一次
+
+private:
+    enum State { kDisconnected, kConnecting, kConnected, kDisconnecting };
+
+    void handleRead();
+    void handleWrite();
+    void handleClose();
+    void handleError();
+
+    void sendInLoop(const void* data, size_t len);
+    void sendFileInLoop(int fd, off_t offset, size_t length);
+    bool drainOutput();
+    void flushDeferred();
+    void handleForwardRead(const TcpConnectionPtr& dst);
+    void resumeForwardSource();
+    void releaseSplicePipe();
+    void shutdownInLoop();
+    void forceCloseInLoop();
+    const char* stateToString() const;
+
+    EventLoop* m_loop; // 所属 ioLoop
+    const std::string m_name;
+    std::atomic<State> m_state; // send() 等接口会在其他线程读取
+    std::unique_ptr<Socket> m_socket;
+    std::unique_ptr<Channel> m_channel;
+    const InetAddress m_localAddr;
+    const InetAddress m_peerAddr;
+
+    ConnectionCallback m_connectionCallback;
+    MessageCallback m_messageCallback;
+    WriteCompleteCallback m_writeCompleteCallback;
+    HighWaterMarkCallback m_highWaterMarkCallback;
+    CloseCallback m_closeCallback;
+    size_t m_highWaterMark;
+    bool m_deferredSend;
+    bool m_flushScheduled; // 已注册本轮结束时的 flushDeferred()
+    uint64_t m_writeSyscalls;
+
+    // sendFile() 排队的文件区间，after 是之后 send() 的数据，文件发完后再发送
+    struct PendingFile
+    {
+        int fd;
+        off_t offset;
+        size_t remaining;
+        Buffer after;
+    };
+
+    Buffer m_inputBuffer;
+    Buffer m_outputBuffer; // 第一个排队文件之前的数据
+    std::deque<PendingFile> m_pendingFiles;
+
+    // splice 转发：源连接记录目标；目标连接持有中转管道，并记录源以便写空后恢复读源
+    // 管道中的数据先于目标的输出缓冲区发送（只有目标没有排队的输出时才会继续往管道转发）
+    std::weak_ptr<TcpConnection> m_forwardTarget;
+    std::weak_ptr<TcpConnection> m_forwardSource;
+    Pipe m_splicePipe;
+    size_t m_pipeBytes; // 中转管道中尚未写出的字节数
+};
+
+}// namespace reactor
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "callbacks.h"
+#include "eventloopoptions.h"
+#include "inetaddress.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace reactor
+{
+
+class Acceptor;
+class EventLoop;
+class EventLoopThreadPool;
+
+// TcpServer 多 Reactor TCP 服务器
+// 职责：
+// 1. 主 Loop（baseLoop）上的 Acceptor 接受新连接
+// 2. 通过 EventLoopThreadPool::getNextLoop() 把连接分配给某个 ioLoop
+// 3. 持有所有 TcpConnection，连接关闭时移除
+//
+// 使用示例：
+//   EventLoop loop;
+//   TcpServer server(&loop, InetAddress(8000), "echo");
+//   server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf) { conn->send(buf); });
+//   server.setThreadNum(4);
+//   server.start();
+//   loop.loop();
+//
+// 线程模型：
+// - 构造、设置回调、start() 和析构都在 baseLoop 线程
+// - 连接回调和消息回调在连接所属的 ioLoop 线程执行
+class TcpServer : private NonCopyable
+{
+public:
+    TcpServer(EventLoop* loop, const InetAddress& listenAddr, std::string name, bool reusePort = false);
+    ~TcpServer();
+
+    const std::string& name() const { return m_name; }
+    EventLoop* getLoop() const { return m_loop; }
+
+    // 实际监听的地址（端口为0时由内核分配）
+    InetAddress listenAddress() const;
+
+    // ioLoop 线程数，0 表示所有连接都在 baseLoop 中处理，
+    // EventLoopThreadPool::kAutoThreadNum 表示按可用 CPU 自动决定（必须在 start() 前调用）
+    void setThreadNum(int numThreads);
+    // ioLoop 的构造参数（必须在 start() 前调用）
+    void setLoopOptions(const EventLoopOptions& options);
+    EventLoopThreadPool* threadPool() { return m_threadPool.get(); }
+
+    // 启动线程池并开始监听，多次调用是安全的
+    void start();
+
+    void setConnectionCallback(ConnectionCallback cb) { m_connectionCallback = std::move(cb); }
+    void setMessageCallback(MessageCallback cb) { m_messageCallback = std::move(cb); }
+    void setWriteCompleteCallback(WriteCompleteCallback cb) { m_writeCompleteCallback = std::move(cb); }
+
+private:
+    void newConnection(int sockfd, const InetAddress& peerAddr); // baseLoop 线程
+    void removeConnection(const TcpConnectionPtr& conn); // 任意 ioLoop 线程
+    void removeConnectionInLoop(const TcpConnectionPtr& conn); // baseLoop 线程
+
+    using ConnectionMap = std::map<std::string, TcpConnectionPtr>;
+
+    EventLoop* m_loop; // baseLoop
+    const std::string m_ipPort;
+    const std::string m_name;
+    std::unique_ptr<Acceptor> m_acceptor;
+    std::unique_ptr<EventLoopThreadPool> m_threadPool;
+    ConnectionCallback m_connectionCallback;
+    MessageCallback m_messageCallback;
+    WriteCompleteCallback m_writeCompleteCallback;
+    std::atomic<bool> m_started;
+    int m_nextConnId;
+    ConnectionMap m_connections;
+};
+
+}// namespace reactor
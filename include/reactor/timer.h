@@ -1,9 +1,9 @@
 #pragma once
 
-#include "timestamp.h"
+#include "monotime.h"
 #include "callbacks.h"
 #include "noncopyable.h"
-#include <atomic>
+#include <cstdint>
 
 namespace reactor
 {
@@ -11,16 +11,35 @@ namespace reactor
 // 职责：
 // 1. 存储到期时间和回调函数
 // 2. 支持重复定时器（interval > 0）
-// 3. 提供序列号用于唯一标识
+// 3. 可选的容差（slack）：允许在 [expiration, expiration + slack] 内的任意时刻触发，
+//    TimerQueue 据此把到期时间相近的定时器合并到同一次唤醒
+// 4. 记录在 TimerPool 中的槽位下标和代数，用于生成/校验 TimerId
+//
+// Timer 对象由 TimerPool 统一分配和复用，不单独 new/delete
 class Timer : private NonCopyable
 {
 public:
-    explicit Timer(TimerCallback cb, Timestamp expiration, double interval)
-        : m_callback(std::move(cb)),
-          m_expiration(expiration),
-          m_interval(interval),
-          m_repeat(interval > 0.0),
-          m_sequence(s_sequence.fetch_add(1)) {}
+    // 定时器在 TimerQueue 中的状态
+    enum State
+    {
+        kFree,      // 在 TimerPool 的空闲链表中
+        kPending,   // 已分配，等待到期（在集合或时间轮中，或者正在加入的路上）
+        kExpired,   // 已到期，位于本轮待执行列表中
+        kCancelled, // 已到期但在执行前/执行中被取消
+    };
+
+    Timer()
+        : m_expiration(),
+          m_interval(0),
+          m_slack(0),
+          m_repeat(false),
+          m_state(kFree),
+          m_index(0),
+          m_generation(1),
+          m_nextFree(0),
+          m_wheelPrev(nullptr),
+          m_wheelNext(nullptr),
+          m_wheelSlot(-1) {}
 
     void run() const
     {
@@ -30,21 +49,40 @@ public:
         }
     }
 
-    Timestamp expiration() const { return m_expiration; }
+    MonoTime expiration() const { return m_expiration; }
+    // 最晚触发时间
+    MonoTime latest() const { return m_expiration + m_slack; }
     bool repeat() const { return m_repeat; }
-    int64_t sequence() const { return m_sequence; }
-    void restart(Timestamp now);
+    void restart(MonoTime now);
+
+    State state() const { return m_state; }
+    void setState(State state) { m_state = state; }
 
-    static int64_t sequenceNumber() { return s_sequence.load(); }
+    uint32_t index() const { return m_index; }
+    uint32_t generation() const { return m_generation; }
+
+    // 是否挂在时间轮中（到期摘下后为 false）
+    bool inWheel() const { return m_wheelSlot >= 0; }
 
 private:
-    const TimerCallback m_callback; // 定时器回调函数
-    Timestamp m_expiration; // 到期时间
-    const double m_interval; // 间隔时间，0表示单次定时器
-    const bool m_repeat; // 是否重复
-    const int64_t m_sequence; // 定时器序列号，用于唯一标识
+    TimerCallback m_callback; // 定时器回调函数
+    MonoTime m_expiration; // 到期时间（单调时钟）
+    Nanoseconds m_interval; // 间隔时间，0表示单次定时器
+    Nanoseconds m_slack; // 容差，0表示尽量准时
+    bool m_repeat; // 是否重复
+    State m_state;
+
+    // 对象池信息，只由 TimerPool 维护
+    friend class TimerPool;
+    uint32_t m_index; // 在对象池中的下标
+    uint32_t m_generation; // 槽位代数，每次释放时递增
+    uint32_t m_nextFree; // 空闲链表中的下一个槽位
 
-    static std::atomic<int64_t> s_sequence; // 静态序列号生成器
+    // 时间轮的侵入式链表节点，只由 TimingWheel 维护
+    friend class TimingWheel;
+    Timer* m_wheelPrev;
+    Timer* m_wheelNext;
+    int m_wheelSlot; // 所在槽位，-1 表示不在时间轮中
 };
 
-}
\ No newline at end of file
+}
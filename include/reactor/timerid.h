@@ -5,29 +5,31 @@
 namespace reactor
 {
 
-class Timer;
-
 // TimerId 是定时器的句柄（类似文件描述符）
 // 用途：
 // 1. 作为 runAfter/runEvery 的返回值
 // 2. 传递给 cancel() 取消定时器
 //
 // 设计：
-// - Timer* + sequence 的组合确保唯一性
-// - 即使Timer对象被删除后指针被重用，sequence也不同
+// - 定时器在所属 TimerQueue 的对象池中的下标 + 槽位代数
+// - 定时器到期或被取消后槽位代数递增，旧的 TimerId 自动失效，
+//   对失效的 TimerId 调用 cancel() 是安全的空操作
 class TimerId
 {
 public:
-    TimerId() : m_timer(nullptr), m_sequence(0) {}
-    TimerId(Timer* timer, int64_t sequence)
-        : m_timer(timer), m_sequence(sequence) {}
-    
-    Timer* timer() const { return m_timer; }
-    int64_t sequence() const { return m_sequence; }
-        
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    TimerId() : m_index(kInvalidIndex), m_generation(0) {}
+    TimerId(uint32_t index, uint32_t generation)
+        : m_index(index), m_generation(generation) {}
+
+    uint32_t index() const { return m_index; }
+    uint32_t generation() const { return m_generation; }
+    bool valid() const { return m_index != kInvalidIndex; }
+
 private:
-    Timer* m_timer; // 指向定时器对象的指针
-    int64_t m_sequence; // 定时器序列号，用于唯一标识
+    uint32_t m_index; // 定时器在对象池中的下标
+    uint32_t m_generation; // 槽位代数，用于识别过期的句柄
 };
 
-}
\ No newline at end of file
+}
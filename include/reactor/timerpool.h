@@ -0,0 +1,60 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "monotime.h"
+#include "callbacks.h"
+#include "timerid.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace reactor
+{
+
+class Timer;
+
+// TimerPool 是每个 TimerQueue 私有的定时器对象池
+// 职责：
+// 1. 按块分配 Timer，块一旦分配就不会移动或释放，Timer* 在 TimerQueue 生命周期内始终有效
+// 2. 空闲槽位组成链表，分配/释放 O(1)，稳定状态下没有 malloc/free
+// 3. 每个槽位带代数，释放时递增，用 TimerId(下标, 代数) 校验句柄是否过期
+//
+// 线程安全：
+// - alloc() 可以在任意线程调用（addTimer 允许跨线程），空闲链表由互斥锁保护
+// - free() / get() 只能在 Loop 线程调用；get() 只读代数，不读可能被 alloc() 并发写入的状态
+// - 块表是定长数组，新块用 release 语义发布，get() 查找时无需加锁
+class TimerPool : private NonCopyable
+{
+public:
+    TimerPool();
+    ~TimerPool();
+
+    // 分配并初始化一个定时器，状态为 kPending
+    Timer* alloc(TimerCallback cb, MonoTime when, Nanoseconds interval, Nanoseconds slack);
+
+    // 释放定时器：销毁回调、递增代数、放回空闲链表
+    void free(Timer* timer);
+
+    // 句柄仍然有效时返回对应的定时器，否则返回 nullptr（已到期或已取消）
+    Timer* get(TimerId timerId) const;
+
+    // 当前已分配（未释放）的定时器数量
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kChunkBits = 10;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits; // 每块1024个定时器
+    static constexpr uint32_t kMaxChunks = 4096; // 每个 TimerQueue 最多约400万个定时器
+    static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+    Timer* slot(uint32_t index) const;
+    void grow(); // 调用者必须持有 m_mtx
+
+    std::atomic<Timer*> m_chunks[kMaxChunks];
+    uint32_t m_numChunks;
+    uint32_t m_freeHead; // 空闲链表头
+    std::atomic<size_t> m_size;
+    std::mutex m_mtx;
+};
+
+}// namespace reactor
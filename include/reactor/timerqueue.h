@@ -1,8 +1,10 @@
 #pragma once
 
 #include "noncopyable.h"
-#include "timestamp.h"
+#include "monotime.h"
 #include "callbacks.h"
+#include "eventloopoptions.h"
+#include "timerpool.h"
 #include <set>
 #include <vector>
 #include <memory>
@@ -11,8 +13,8 @@ namespace reactor
 {
 class EventLoop;
 class Timer;
-class TimerId;
 class Channel;
+class TimingWheel;
 
 // TimerQueue 管理所有定时器
 // 职责：
@@ -22,40 +24,72 @@ class Channel;
 // 4. 支持定时器的添加和取消
 //
 // 实现细节：
-// - 使用 std::set 存储定时器（红黑树，自动排序）
+// - 两种后端（构造时选择）：
+//   kOrderedSet  使用 std::set 存储定时器（红黑树，自动排序），精确到期
+//   kTimingWheel 使用分层时间轮，O(1) 添加/取消，按 tick 粒度到期
+// - Timer 对象来自每个 TimerQueue 私有的 TimerPool，TimerId 为(下标, 代数)，
+//   取消已失效的 TimerId 是安全的空操作
 // - 使用 timerfd 将定时器转换为可epoll的文件描述符
 // - 最近的定时器到期时，timerfd 变为可读，触发回调
+// - 到期时间是 CLOCK_MONOTONIC 上的整数纳秒，timerfd 以绝对时间（TFD_TIMER_ABSTIME）设置，
+//   设置时不需要再读一次时钟；判断到期使用 EventLoop 本轮缓存的 now()
+// - 定时器可以带容差（slack）：timerfd 设置为所有定时器最晚触发时间中的最小值，
+//   新定时器只有在它的最晚触发时间早于已设置的时间时才重新设置 timerfd；
+//   唤醒时把已经到期的定时器一起执行，到期时间相近的定时器因此合并为一次唤醒
+//   （时间轮后端按 tick 合并，不使用 slack）
 class TimerQueue : private NonCopyable
 {
 public:
-    explicit TimerQueue(EventLoop* loop);
+    explicit TimerQueue(EventLoop* loop,
+                        TimerBackend backend = TimerBackend::kOrderedSet,
+                        int64_t wheelTickMicroseconds = 1000);
     ~TimerQueue();
     
-    // 添加定时器
-    TimerId addTimer(TimerCallback cb, Timestamp when, double interval);
+    // 添加定时器，定时器会在 [when, when + slack] 内触发
+    TimerId addTimer(TimerCallback cb, MonoTime when, Nanoseconds interval, Nanoseconds slack = Nanoseconds::zero());
 
     // 取消定时器
     void cancel(TimerId timerId);
 
+    // 统计（Loop 线程读取）：timerfd_settime 调用次数、timerfd 唤醒次数
+    uint64_t syscalls() const { return m_syscalls; }
+    uint64_t wakeups() const { return m_wakeups; }
+
 private:
-    using Entry = std::pair<Timestamp, Timer*>;
+    using Entry = std::pair<MonoTime, Timer*>;
     using TimerSet = std::set<Entry>;
 
     void addTimerInLoop(Timer* timer);
     void cancelInLoop(TimerId timerId);
     void handleRead(); // 处理 timerfd 可读事件
-    std::vector<Entry> getExpired(Timestamp now); // 获取到期的定时器
-    void reset(const std::vector<Entry>& expired, Timestamp now); // 重置到期的定时器
-    bool insert(Timer* timer); // 插入定时器到集合
+    void getExpired(MonoTime now); // 把到期的定时器摘到 m_expired
+    void reset(MonoTime now); // 重置到期的定时器
+    void insert(Timer* timer); // 插入定时器到集合
+    void recycleNode(TimerSet::node_type node); // 回收 set 节点供 insert 复用
+    void rearmWheel(); // 时间轮下一次推进时间提前时重新设置 timerfd
+    void arm(MonoTime deadline); // 设置 timerfd 并记录到 m_armed
 
     EventLoop* m_loop; // 所属的 EventLoop
+    const TimerBackend m_backend;
     const int m_timerfd; // timerfd 文件描述符
+    TimerPool m_pool; // 定时器对象池
     TimerSet m_timers; // 定时器集合，按到期时间排序
-    std::unique_ptr<Channel> m_timerfdChannel; // timerfd 的 Channel
 
-    //在回调中取消其他同时到期的定时器
-    //防止重复定时器被重新插入
-    std::set<Timer*> m_cancellingTimers;
+    // 本轮到期的定时器（两种后端共用，跨轮复用容量）
+    std::vector<Timer*> m_expired;
+
+    // 到期/取消后通过 set::extract 摘下的空闲节点，插入定时器时复用，
+    // 避免 set 节点的 malloc/free（重复定时器插回时也走这里）
+    static constexpr size_t kMaxSpareNodes = 4096;
+    static constexpr size_t kInitialListCapacity = 64;
+    std::vector<TimerSet::node_type> m_spareNodes;
+
+    // 时间轮后端
+    std::unique_ptr<TimingWheel> m_wheel;
+    MonoTime m_armed; // timerfd 当前设置的到期时间，kNoExpiration 表示未设置
+    uint64_t m_syscalls;
+    uint64_t m_wakeups;
+    std::unique_ptr<Channel> m_timerfdChannel; // timerfd 的 Channel
 
 };
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "monotime.h"
+#include <cstdint>
+#include <vector>
+
+namespace reactor
+{
+
+class Timer;
+
+// TimingWheel 分层时间轮
+// 职责：
+// 1. 以固定 tick 粒度管理大量定时器
+// 2. 添加/取消 O(1)，不分配内存（链表节点嵌在 Timer 中）
+// 3. 推进时间时把到期的定时器交给 TimerQueue 执行
+//
+// 实现细节：
+// - 4 层时间轮：第0层256个槽，第1~3层各64个槽，共覆盖 2^26 个 tick
+//   （1ms 粒度下约18.6小时），更远的定时器先放在最高层，级联时重新计算
+// - 第0层每个槽对应一个 tick；高层的槽在低层转完一圈时级联到下一层
+// - 定时器在到期时间所在 tick 结束后才触发，最多晚一个 tick，不会提前
+// - 每层用位图记录非空槽，用于快速计算下一次需要唤醒的时间
+class TimingWheel : private NonCopyable
+{
+public:
+    TimingWheel(Nanoseconds tick, MonoTime start);
+    ~TimingWheel();
+
+    // 添加定时器（已经到期的定时器会在下一个 tick 触发）
+    void add(Timer* timer);
+
+    // 移除仍在时间轮中的定时器
+    void remove(Timer* timer);
+
+    // 推进到 now，把所有到期的定时器追加到 expired
+    void advance(MonoTime now, std::vector<Timer*>* expired);
+
+    // 下一次需要推进时间轮的时刻（有定时器到期或需要级联）
+    // 时间轮为空时返回 kNoExpiration
+    MonoTime nextExpiration() const;
+
+    // 取出所有定时器（用于析构时释放）
+    void takeAll(std::vector<Timer*>* timers);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    Nanoseconds tick() const { return Nanoseconds(m_tickNs); }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kLevel0Bits = 8;
+    static constexpr int kLevelBits = 6;
+    static constexpr int kLevel0Slots = 1 << kLevel0Bits;
+    static constexpr int kLevelSlots = 1 << kLevelBits;
+    static constexpr int kTotalSlots = kLevel0Slots + (kLevels - 1) * kLevelSlots;
+    static constexpr int64_t kMaxTicks = int64_t(1) << (kLevel0Bits + (kLevels - 1) * kLevelBits);
+
+    int64_t tickOf(MonoTime when) const; // 向上取整到 tick
+    MonoTime timeOf(int64_t tick) const;
+
+    void place(Timer* timer, int64_t expireTick); // 按剩余 tick 数放入对应层
+    void link(int slot, Timer* timer);
+    void unlink(Timer* timer);
+    void cascade(int level); // 把第 level 层当前槽的定时器重新放置
+    int findLevel0Slot(int start) const; // 从 start 开始环形查找第0层的非空槽
+
+    const int64_t m_tickNs;
+    const MonoTime m_start; // tick 0 对应的时间
+    int64_t m_currentTick; // 已经处理到的 tick
+    size_t m_size;
+    size_t m_levelSize[kLevels]; // 每层的定时器数量
+
+    Timer* m_slots[kTotalSlots]; // 每个槽是一个侵入式双向链表
+    uint64_t m_occupied[(kTotalSlots + 63) / 64]; // 非空槽位图
+};
+
+}// namespace reactor
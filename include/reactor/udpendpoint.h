@@ -0,0 +1,140 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "inetaddress.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace reactor
+{
+
+class Channel;
+class EventLoop;
+class Socket;
+
+// UdpEndpoint 的构造参数
+struct UdpOptions
+{
+    int batchSize = 32; // 每次 recvmmsg/sendmmsg 的最大消息数，1 表示逐个收发
+    size_t maxDatagramSize = 2048; // 每个接收缓冲区的大小；超过的数据报被截断并丢弃
+    // UDP_GRO：内核把同一流的多个数据报合并成一个大缓冲区上交，接收缓冲区自动扩大到 64KB
+    bool enableGro = false;
+    // UDP_SEGMENT：发往同一地址、长度相同的连续数据报合并为一条消息，由内核（或网卡）分段
+    bool enableGso = false;
+    int socketBufferBytes = 0; // SO_RCVBUF/SO_SNDBUF，0 表示使用系统默认值
+    size_t maxQueuedDatagrams = 4096; // 发送队列上限，超过的数据报直接丢弃并计数
+    bool reusePort = false;
+};
+
+// UdpEndpoint 是基于 Channel 的 UDP 收发端点
+// 职责：
+// 1. 可读时用 recvmmsg 把数据报批量读入预先分配的缓冲区，逐个回调 DatagramCallback，直到 EAGAIN
+// 2. sendTo() 把数据报加入发送队列，本轮事件处理完后（EventLoop::runAfterDispatch）用 sendmmsg 批量发出；
+//    内核发送缓冲区满时关注可写事件，可写后继续
+// 3. 可选 UDP_GRO/UDP_SEGMENT，让一次系统调用搬运更多数据报
+//
+// 实现细节：
+// - 接收缓冲区、mmsghdr/iovec/地址/控制消息数组在构造时按 batchSize 一次分配，收包路径不分配内存
+// - GRO 上交的缓冲区按控制消息中的分段大小拆回原来的数据报再回调
+// - 发送数据复制到连续的发送缓冲区，GSO 合并的一组数据报正好是其中连续的一段
+// - 内核不支持 GSO/GRO 时打印警告并回退到普通批量收发
+//
+// 所有接口只能在 Loop 线程调用
+class UdpEndpoint : private NonCopyable
+{
+public:
+    // data 只在回调期间有效
+    using DatagramCallback = std::function<void(const char* data, size_t len, const InetAddress& peer)>;
+
+    UdpEndpoint(EventLoop* loop, const InetAddress& bindAddr, std::string name,
+                const UdpOptions& options = UdpOptions());
+    ~UdpEndpoint();
+
+    const std::string& name() const { return m_name; }
+    EventLoop* getLoop() const { return m_loop; }
+    // 实际绑定的地址（端口为0时由内核分配）
+    InetAddress localAddress() const;
+
+    void setDatagramCallback(DatagramCallback cb) { m_datagramCallback = std::move(cb); }
+
+    // 开始接收
+    void start();
+
+    // 加入发送队列；Loop 正在处理事件时在本轮结束时发出，否则立即发出
+    // 队列满时丢弃并返回 false
+    bool sendTo(const void* data, size_t len, const InetAddress& peer);
+    // 立即尝试发出队列中的数据报
+    void flush();
+
+    bool groEnabled() const { return m_gro; }
+    bool gsoEnabled() const { return m_gso; }
+
+    // 统计
+    uint64_t datagramsReceived() const { return m_datagramsReceived; }
+    uint64_t datagramsSent() const { return m_datagramsSent; }
+    uint64_t datagramsDropped() const { return m_datagramsDropped; } // 发送队列满、发送失败或接收时被截断
+    uint64_t recvSyscalls() const { return m_recvSyscalls; }
+    uint64_t sendSyscalls() const { return m_sendSyscalls; }
+
+private:
+    // 发送队列中的一个数据报：数据在 m_sendBuffer 的 [offset, offset + len)
+    struct OutgoingDatagram
+    {
+        size_t offset;
+        size_t len;
+        struct sockaddr_in6 peer;
+        socklen_t peerLen;
+    };
+
+    void handleRead();
+    void handleWrite();
+    void deliver(const char* data, size_t len, int segmentSize, const InetAddress& peer);
+    // 发送队列全部发出返回 true，内核发送缓冲区满返回 false
+    bool sendQueued();
+    // 从发送队列的 first 开始组装最多 batchSize 条消息，返回消息数
+    // 每条消息包含的数据报数记录在 m_sendMsgDatagrams
+    int buildSendBatch(size_t first);
+    // 丢掉发送队列中已发出的前缀（超过一半时），offset 相应平移
+    void compactSendQueue();
+
+    EventLoop* m_loop;
+    const std::string m_name;
+    const UdpOptions m_options;
+    std::unique_ptr<Socket> m_socket;
+    std::unique_ptr<Channel> m_channel;
+    DatagramCallback m_datagramCallback;
+    bool m_gro;
+    bool m_gso;
+
+    // 接收批次（构造时分配，之后复用）
+    size_t m_recvSlotSize;
+    std::vector<char> m_recvBuffers;
+    std::vector<struct mmsghdr> m_recvMsgs;
+    std::vector<struct iovec> m_recvIovecs;
+    std::vector<struct sockaddr_in6> m_recvAddrs;
+    std::vector<char> m_recvControl;
+
+    // 发送队列和批次
+    std::vector<char> m_sendBuffer;
+    std::vector<OutgoingDatagram> m_sendQueue;
+    size_t m_sendHead; // 已发出的数据报数
+    bool m_flushScheduled;
+    std::shared_ptr<UdpEndpoint*> m_lifeToken; // 本轮结束的 flush 回调通过 weak_ptr 判断端点是否还在
+    std::vector<struct mmsghdr> m_sendMsgs;
+    std::vector<struct iovec> m_sendIovecs;
+    std::vector<size_t> m_sendMsgDatagrams;
+    std::vector<char> m_sendControl;
+
+    uint64_t m_datagramsReceived;
+    uint64_t m_datagramsSent;
+    uint64_t m_datagramsDropped;
+    uint64_t m_recvSyscalls;
+    uint64_t m_sendSyscalls;
+};
+
+}// namespace reactor
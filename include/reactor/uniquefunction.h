@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace reactor
+{
+
+template<typename Signature>
+class UniqueFunction;
+
+// UniqueFunction 是只能移动的可调用对象包装（类似 C++23 std::move_only_function）
+// 职责：
+// 1. 代替 std::function 作为 Functor/EventCallback/TimerCallback：
+//    内部缓冲区 kInlineSize = 56 字节（对象共64字节，一个 cache line），
+//    常见的捕获（几个指针、shared_ptr + std::string）都放在对象内部，不分配内存
+// 2. 可以保存只能移动的捕获，例如 std::unique_ptr
+//
+// 实现细节：
+// - 每种被包装类型对应一张静态操作表（调用/移动/析构），对象里只存表指针，没有虚函数
+// - 放不下、对齐要求超过 max_align_t、或者移动构造可能抛异常的类型放到堆上，缓冲区里存指针
+// - 与 std::function 一样，operator() 是 const 的，被包装对象按非 const 调用
+// - 空对象调用是编程错误（assert），不抛 bad_function_call
+template<typename R, typename... Args>
+class UniqueFunction<R(Args...)>
+{
+public:
+    static constexpr size_t kInlineSize = 64 - sizeof(void*);
+
+    UniqueFunction() noexcept : m_ops(nullptr) {}
+    UniqueFunction(std::nullptr_t) noexcept : m_ops(nullptr) {}
+
+    template<typename F,
+             typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same<D, UniqueFunction>::value &&
+                                         std::is_invocable_r<R, D&, Args...>::value>>
+    UniqueFunction(F&& f) : m_ops(nullptr)
+    {
+        if(isNull(f)) return;
+        if constexpr (storedInline<D>())
+        {
+            ::new (static_cast<void*>(m_storage)) D(std::forward<F>(f));
+            m_ops = &InlineOps<D>::kOps;
+        }
+        else
+        {
+            D* p = new D(std::forward<F>(f));
+            ::new (static_cast<void*>(m_storage)) D*(p);
+            m_ops = &HeapOps<D>::kOps;
+        }
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept : m_ops(other.m_ops)
+    {
+        if(m_ops)
+        {
+            m_ops->move(m_storage, other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            if(other.m_ops)
+            {
+                other.m_ops->move(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+                other.m_ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    UniqueFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template<typename F,
+             typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same<D, UniqueFunction>::value &&
+                                         std::is_invocable_r<R, D&, Args...>::value>>
+    UniqueFunction& operator=(F&& f)
+    {
+        UniqueFunction tmp(std::forward<F>(f));
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    ~UniqueFunction() { reset(); }
+
+    R operator()(Args... args) const
+    {
+        assert(m_ops != nullptr);
+        return m_ops->invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    // 被包装对象是否放在内部缓冲区（用于测试和基准）
+    bool isInline() const noexcept { return m_ops != nullptr && m_ops->isInline; }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* dst, void* src) noexcept; // 移动到 dst 并析构 src
+        void (*destroy)(void* storage) noexcept;
+        bool isInline;
+    };
+
+    template<typename D>
+    static constexpr bool storedInline()
+    {
+        return sizeof(D) <= kInlineSize && alignof(D) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<D>::value;
+    }
+
+    template<typename F>
+    static bool isNull(const F& f)
+    {
+        if constexpr (std::is_pointer<std::decay_t<F>>::value ||
+                      std::is_member_pointer<std::decay_t<F>>::value)
+            return f == nullptr;
+        else if constexpr (std::is_same<std::decay_t<F>, std::function<R(Args...)>>::value)
+            return !f;
+        else
+            return false;
+    }
+
+    template<typename D>
+    struct InlineOps
+    {
+        static R invoke(void* storage, Args&&... args)
+        {
+            return std::invoke(*static_cast<D*>(storage), std::forward<Args>(args)...);
+        }
+        static void move(void* dst, void* src) noexcept
+        {
+            D* from = static_cast<D*>(src);
+            ::new (dst) D(std::move(*from));
+            from->~D();
+        }
+        static void destroy(void* storage) noexcept { static_cast<D*>(storage)->~D(); }
+        static constexpr Ops kOps = {&invoke, &move, &destroy, true};
+    };
+
+    template<typename D>
+    struct HeapOps
+    {
+        static D*& target(void* storage) { return *static_cast<D**>(storage); }
+        static R invoke(void* storage, Args&&... args)
+        {
+            return std::invoke(*target(storage), std::forward<Args>(args)...);
+        }
+        static void move(void* dst, void* src) noexcept { ::new (dst) D*(target(src)); }
+        static void destroy(void* storage) noexcept { delete target(storage); }
+        static constexpr Ops kOps = {&invoke, &move, &destroy, false};
+    };
+
+    void reset() noexcept
+    {
+        if(m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[kInlineSize];
+    const Ops* m_ops;
+};
+
+}// namespace reactor
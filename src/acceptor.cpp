@@ -0,0 +1,88 @@
+#include "reactor/acceptor.h"
+#include "reactor/eventloop.h"
+#include "reactor/inetaddress.h"
+#include "reactor/logging.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace reactor
+{
+
+Acceptor::Acceptor(EventLoop* loop, const InetAddress& listenAddr, bool reusePort)
+    : m_loop(loop),
+      m_acceptSocket(Socket::createNonblockingOrDie(listenAddr.family())),
+      m_acceptChannel(loop, m_acceptSocket.fd()),
+      m_listening(false),
+      m_idleFd(::open("/dev/null", O_RDONLY | O_CLOEXEC))
+{
+    if(m_idleFd < 0)
+    {
+        LOG_SYSFATAL << "Acceptor::Acceptor() open /dev/null failed";
+    }
+    m_acceptSocket.setReuseAddr(true);
+    m_acceptSocket.setReusePort(reusePort);
+    m_acceptSocket.bindAddress(listenAddr);
+    m_acceptChannel.setReadCallback([this]() { handleRead(); });
+}
+
+Acceptor::~Acceptor()
+{
+    if(m_listening)
+    {
+        m_acceptChannel.disableAll();
+        m_acceptChannel.remove();
+    }
+    ::close(m_idleFd);
+}
+
+void Acceptor::listen()
+{
+    m_loop->assertInLoopThread();
+    m_listening = true;
+    m_acceptSocket.listen();
+    m_acceptChannel.enableReading();
+}
+
+InetAddress Acceptor::listenAddress() const
+{
+    return Socket::getLocalAddr(m_acceptSocket.fd());
+}
+
+void Acceptor::handleRead()
+{
+    m_loop->assertInLoopThread();
+    InetAddress peerAddr;
+    int connfd = m_acceptSocket.accept(&peerAddr);
+    if(connfd >= 0)
+    {
+        LOG_TRACE << "Acceptor accepted fd=" << connfd << " from " << peerAddr.toIpPort();
+        if(m_newConnectionCallback)
+        {
+            m_newConnectionCallback(connfd, peerAddr);
+        }
+        else
+        {
+            ::close(connfd);
+        }
+        return;
+    }
+
+    int savedErrno = errno;
+    if(savedErrno == EAGAIN || savedErrno == EINTR || savedErrno == ECONNABORTED)
+    {
+        return; // 对端在 accept 之前已经断开，或者被其他线程抢先 accept
+    }
+
+    LOG_SYSERR << "Acceptor::handleRead() accept failed";
+    if(savedErrno == EMFILE || savedErrno == ENFILE)
+    {
+        // 腾出预留 fd 接受并立即关闭这个连接，否则监听 socket 一直可读
+        ::close(m_idleFd);
+        m_idleFd = ::accept(m_acceptSocket.fd(), nullptr, nullptr);
+        if(m_idleFd >= 0) ::close(m_idleFd);
+        m_idleFd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+}
+
+}// namespace reactor
@@ -0,0 +1,96 @@
+#include "reactor/buffer.h"
+#include <arpa/inet.h>
+#include <sys/uio.h>
+#include <cerrno>
+
+namespace reactor
+{
+
+const char Buffer::kCRLF[] = "\r\n";
+
+// 栈上的额外读缓冲区：socket 里的数据超过剩余写空间时先读到这里，再追加到 Buffer
+constexpr size_t kExtraBufferSize = 65536;
+
+void Buffer::appendInt32(int32_t x)
+{
+    int32_t be32 = static_cast<int32_t>(htonl(static_cast<uint32_t>(x)));
+    append(&be32, sizeof be32);
+}
+
+void Buffer::prependInt32(int32_t x)
+{
+    int32_t be32 = static_cast<int32_t>(htonl(static_cast<uint32_t>(x)));
+    prepend(&be32, sizeof be32);
+}
+
+int32_t Buffer::peekInt32() const
+{
+    assert(readableBytes() >= sizeof(int32_t));
+    uint32_t be32;
+    std::memcpy(&be32, peek(), sizeof be32);
+    return static_cast<int32_t>(ntohl(be32));
+}
+
+int32_t Buffer::readInt32()
+{
+    int32_t result = peekInt32();
+    retrieve(sizeof result);
+    return result;
+}
+
+void Buffer::shrink(size_t reserve)
+{
+    Buffer other(readableBytes() + reserve);
+    other.append(peek(), readableBytes());
+    swap(other);
+}
+
+void Buffer::makeSpace(size_t len)
+{
+    if(writableBytes() + prependableBytes() < len + kCheapPrepend)
+    {
+        // 整理后也放不下，只能扩容
+        m_buffer.resize(m_writerIndex + len);
+    }
+    else
+    {
+        // 把可读数据搬到预留区之后，复用前面已经读过的空间
+        assert(kCheapPrepend < m_readerIndex);
+        size_t readable = readableBytes();
+        std::memmove(begin() + kCheapPrepend, begin() + m_readerIndex, readable);
+        m_readerIndex = kCheapPrepend;
+        m_writerIndex = m_readerIndex + readable;
+        assert(readable == readableBytes());
+    }
+}
+
+ssize_t Buffer::readFd(int fd, int* savedErrno)
+{
+    char extrabuf[kExtraBufferSize];
+    struct iovec vec[2];
+    const size_t writable = writableBytes();
+    vec[0].iov_base = begin() + m_writerIndex;
+    vec[0].iov_len = writable;
+    vec[1].iov_base = extrabuf;
+    vec[1].iov_len = sizeof extrabuf;
+
+    // 剩余空间已经不小于额外缓冲区时，只读到 Buffer 里
+    const int iovcnt = writable < sizeof extrabuf ? 2 : 1;
+    const ssize_t n = ::readv(fd, vec, iovcnt);
+    if(n < 0)
+    {
+        *savedErrno = errno;
+    }
+    else if(static_cast<size_t>(n) <= writable)
+    {
+        m_writerIndex += static_cast<size_t>(n);
+    }
+    else
+    {
+        m_writerIndex = m_buffer.size();
+        append(extrabuf, static_cast<size_t>(n) - writable);
+    }
+    return n;
+}
+
+}// namespace reactor
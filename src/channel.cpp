@@ -1,8 +1,8 @@
 #include "reactor/channel.h"
 #include "reactor/eventloop.h"
 #include <sys/epoll.h>
+#include "reactor/logging.h"
 #include <cassert>
-#include <iostream>
 
 namespace reactor 
 {
@@ -11,8 +11,13 @@ const uint32_t Channel::kNoneEvent = 0;
 const uint32_t Channel::kReadEvent = EPOLLIN | EPOLLPRI;  // 可读 + 紧急数据
 const uint32_t Channel::kWriteEvent = EPOLLOUT;
 
+const uint32_t Channel::kEdgeTriggered = EPOLLET;
+const uint32_t Channel::kOneShot = EPOLLONESHOT;
+const uint32_t Channel::kWatchPeerClose = EPOLLRDHUP;
+
 Channel::Channel(EventLoop* loop, int fd)
-    : m_loop(loop), m_fd(fd), m_events(0), m_revents(0), m_index(-1), m_eventHandling(false)
+    : m_loop(loop), m_fd(fd), m_events(0), m_revents(0), m_mode(0), m_registeredEvents(0),
+      m_missedEvents(0), m_index(-1), m_eventHandling(false), m_tied(false)
 {
     assert(loop != nullptr);
     assert(fd >= 0);
@@ -23,6 +28,37 @@ Channel::~Channel()
     assert(!m_eventHandling); // 确保在销毁前没有事件正在处理
 }
 
+uint32_t Channel::pollEvents() const
+{
+    if(isNoneEvent()) return kNoneEvent;
+
+    // 边沿触发时读写事件一次性注册，开关写事件不需要修改 epoll
+    uint32_t events = (m_mode & kEdgeTriggered) ? (kReadEvent | kWriteEvent) : m_events;
+    return events | m_mode;
+}
+
+void Channel::setMode(uint32_t flag, bool on)
+{
+    uint32_t mode = on ? (m_mode | flag) : (m_mode & ~flag);
+    if(mode == m_mode) return;
+    m_mode = mode;
+    // 已经注册过的 fd 需要用新模式重新注册
+    if(!isNoneEvent()) update();
+}
+
+void Channel::enableEvents(uint32_t events)
+{
+    if(m_missedEvents & events)
+    {
+        // 边沿触发：关闭期间的边沿已被 handleEvent 丢弃，注册的事件没有变化时 Poller 不会重新注册，
+        // 清掉记录的注册状态强制一次 MOD，内核会重新报告当前的就绪状态
+        m_missedEvents &= ~events;
+        m_registeredEvents = 0;
+    }
+    m_events |= events;
+    update();
+}
+
 void Channel::update()
 {
     m_loop->updateChannel(this);
@@ -34,7 +70,29 @@ void Channel::remove()
     m_loop->removeChannel(this);
 }
 
+void Channel::tie(const std::shared_ptr<void>& owner)
+{
+    m_tie = owner;
+    m_tied = true;
+}
+
 void Channel::handleEvent()
+{
+    if(m_tied)
+    {
+        std::shared_ptr<void> guard = m_tie.lock();
+        if(guard)
+        {
+            handleEventWithGuard();
+        }
+    }
+    else
+    {
+        handleEventWithGuard();
+    }
+}
+
+void Channel::handleEventWithGuard()
 {
     m_eventHandling = true;
 
@@ -47,7 +105,7 @@ void Channel::handleEvent()
         //发生挂起但没有读事件，调用关闭回调
         if(m_closeCallback)
         {
-            std::cout << "Channel::handleEvent() EPOLLHUP, calling close callback" << std::endl;
+            LOG_TRACE << "fd=" << m_fd << " EPOLLHUP, calling close callback";
             m_closeCallback();
         }
     }
@@ -57,30 +115,40 @@ void Channel::handleEvent()
         //发生错误，调用错误回调
         if(m_errorCallback)
         {
-            std::cout << "Channel::handleEvent() EPOLLERR, calling error callback" << std::endl;
+            LOG_TRACE << "fd=" << m_fd << " EPOLLERR, calling error callback";
             m_errorCallback();
         }
     }
 
-    if(m_revents & (EPOLLIN | EPOLLPRI | EPOLLRDHUP))
+    // 边沿触发模式下读写事件总是一起注册，只分发用户关心的事件；
+    // 不关心的边沿记录下来，重新开启时补发（见 enableEvents）
+    if((m_revents & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) && isReading())
     {
         //发生可读或紧急数据事件，调用读回调
         if(m_readCallback)
         {
-            std::cout << "Channel::handleEvent() EPOLLIN or EPOLLPRI, calling read callback" << std::endl;
+            LOG_TRACE << "fd=" << m_fd << " EPOLLIN or EPOLLPRI, calling read callback";
             m_readCallback();
         }
     }
+    else if((m_revents & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) && isEdgeTriggered())
+    {
+        m_missedEvents |= kReadEvent;
+    }
 
-    if(m_revents & EPOLLOUT)
+    if((m_revents & EPOLLOUT) && isWriting())
     {
         //发生可写事件，调用写回调
         if(m_writeCallback)
         {
-            std::cout << "Channel::handleEvent() EPOLLOUT, calling write callback" << std::endl;
+            LOG_TRACE << "fd=" << m_fd << " EPOLLOUT, calling write callback";
             m_writeCallback();
         }
     }
+    else if((m_revents & EPOLLOUT) && isEdgeTriggered())
+    {
+        m_missedEvents |= kWriteEvent;
+    }
 
     m_eventHandling = false; // 事件处理完成
 
@@ -0,0 +1,176 @@
+#include "reactor/computepool.h"
+#include "reactor/cputopology.h"
+#include "reactor/logging.h"
+#include <cassert>
+
+namespace reactor
+{
+
+namespace
+{
+// 当前线程所属的 ComputePool 和下标，用于把工作线程中提交的任务放进自己的队列
+thread_local const ComputePool* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+}
+
+ComputePool::ComputePool(std::string name)
+    : m_name(std::move(name)),
+      m_threadNum(kAutoThreadNum),
+      m_started(false),
+      m_stopping(false),
+      m_queued(0),
+      m_next(0),
+      m_sleepers(0)
+{}
+
+ComputePool::~ComputePool()
+{
+    stop();
+}
+
+void ComputePool::start()
+{
+    assert(!m_started);
+    m_started = true;
+    if(m_threadNum == kAutoThreadNum)
+    {
+        m_threadNum = CpuTopology::availableCpus();
+        LOG_INFO << "ComputePool " << m_name << " auto thread num: " << m_threadNum;
+    }
+    if(m_threadNum < 1) m_threadNum = 1;
+
+    // 先创建全部 Worker 再启动线程，窃取时可以无锁遍历 m_workers
+    for(int i = 0; i < m_threadNum; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for(size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i]->thread = std::thread(&ComputePool::workerFunc, this, i);
+    }
+}
+
+void ComputePool::stop()
+{
+    if(!m_started || m_stopping.exchange(true)) return;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCond.notify_all();
+    for(auto& worker : m_workers)
+    {
+        if(worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+void ComputePool::submit(Functor task)
+{
+    assert(m_started && !m_stopping.load(std::memory_order_relaxed));
+    size_t index;
+    if(t_pool == this)
+    {
+        index = t_workerIndex;
+    }
+    else
+    {
+        index = m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    }
+    push(index, std::move(task));
+
+    // m_queued 的递增（push 中，seq_cst）与休眠者先登记 m_sleepers 再检查 m_queued 配对：
+    // 两边至少有一方能看到对方，不会丢失唤醒
+    if(m_sleepers.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_sleepCond.notify_one();
+    }
+}
+
+void ComputePool::push(size_t index, Functor task)
+{
+    // 先计数再入队：m_queued 不会因为任务先被取走而下溢，
+    // 工作线程看到计数但还没看到任务时只是多试一次
+    m_queued.fetch_add(1);
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mtx);
+    worker.tasks.push_back(std::move(task));
+}
+
+bool ComputePool::popLocal(size_t index, Functor* task)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mtx);
+    if(worker.tasks.empty()) return false;
+    *task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+bool ComputePool::steal(size_t thief, Functor* task)
+{
+    const size_t n = m_workers.size();
+    for(size_t i = 1; i < n; ++i)
+    {
+        Worker& victim = *m_workers[(thief + i) % n];
+        std::unique_lock<std::mutex> lock(victim.mtx, std::try_to_lock);
+        if(!lock.owns_lock() || victim.tasks.empty()) continue;
+        *task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        m_workers[thief]->stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ComputePool::workerFunc(size_t index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+    Worker& self = *m_workers[index];
+
+    Functor task;
+    while(true)
+    {
+        if(popLocal(index, &task) || steal(index, &task))
+        {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr; // 及时释放任务捕获的资源
+            self.executed.store(self.executed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // try_lock 窃取可能因为竞争漏掉任务，休眠前以 m_queued 为准
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepers.fetch_add(1);
+        m_sleepCond.wait(lock, [this] { return m_queued.load() > 0 || m_stopping.load(); });
+        m_sleepers.fetch_sub(1);
+        if(m_queued.load() == 0 && m_stopping.load()) break;
+    }
+
+    t_pool = nullptr;
+}
+
+uint64_t ComputePool::executedTasks() const
+{
+    uint64_t n = 0;
+    for(const auto& worker : m_workers)
+    {
+        n += worker->executed.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+uint64_t ComputePool::stolenTasks() const
+{
+    uint64_t n = 0;
+    for(const auto& worker : m_workers)
+    {
+        n += worker->stolen.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+}// namespace reactor
@@ -0,0 +1,33 @@
+#include "reactor/countdownlatch.h"
+
+namespace reactor
+{
+
+void CountDownLatch::countDown()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if(m_count > 0 && --m_count == 0)
+    {
+        m_cond.notify_all();
+    }
+}
+
+void CountDownLatch::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cond.wait(lock, [this]() { return m_count == 0; });
+}
+
+bool CountDownLatch::waitFor(Nanoseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    return m_cond.wait_for(lock, timeout, [this]() { return m_count == 0; });
+}
+
+int CountDownLatch::count() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_count;
+}
+
+}// namespace reactor
@@ -0,0 +1,275 @@
+#include "reactor/cputopology.h"
+#include "reactor/logging.h"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <utility>
+
+namespace reactor
+{
+
+namespace details
+{
+
+bool readFirstLine(const std::string& path, std::string* line)
+{
+    std::ifstream in(path);
+    if(!in) return false;
+    return static_cast<bool>(std::getline(in, *line));
+}
+
+// 解析整数，允许前后空白；内容不是合法整数或溢出时返回 false
+bool parseLong(const std::string& text, long* value)
+{
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    errno = 0;
+    long result = std::strtol(begin, &end, 10);
+    if(end == begin || errno == ERANGE) return false;
+    while(*end == ' ' || *end == '\t' || *end == '\n') ++end;
+    if(*end != '\0') return false;
+    *value = result;
+    return true;
+}
+
+std::vector<int> intersect(const std::vector<int>& cpus, const std::vector<int>& allowed)
+{
+    std::vector<int> result;
+    for(int cpu : cpus)
+    {
+        if(std::binary_search(allowed.begin(), allowed.end(), cpu)) result.push_back(cpu);
+    }
+    return result;
+}
+
+// 在 /proc/self/cgroup 中查找控制器对应的路径；v2 统一层级的行是 "0::/path"
+std::string cgroupPath(const std::string& controller)
+{
+    std::ifstream in("/proc/self/cgroup");
+    std::string line;
+    while(std::getline(in, line))
+    {
+        size_t first = line.find(':');
+        size_t second = line.find(':', first + 1);
+        if(first == std::string::npos || second == std::string::npos) continue;
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        if(controller.empty() ? controllers.empty() : ("," + controllers + ",").find("," + controller + ",") != std::string::npos)
+        {
+            return path == "/" ? "" : path;
+        }
+    }
+    return "";
+}
+
+// 返回 {quota, period}，quota <= 0 表示不限制，文件不存在时返回 {-1, 0}
+std::pair<long, long> cgroupV2Quota()
+{
+    std::string line;
+    std::string path = "/sys/fs/cgroup" + cgroupPath("") + "/cpu.max";
+    if(!readFirstLine(path, &line) && !readFirstLine("/sys/fs/cgroup/cpu.max", &line))
+    {
+        return {-1, 0};
+    }
+    std::istringstream iss(line);
+    std::string quota;
+    long period = 0;
+    iss >> quota >> period;
+    if(quota == "max" || period <= 0) return {0, 0};
+    long value = 0;
+    if(!parseLong(quota, &value))
+    {
+        LOG_WARN << "unexpected cpu.max content: " << line;
+        return {0, 0};
+    }
+    return {value, period};
+}
+
+std::pair<long, long> cgroupV1Quota()
+{
+    std::string path = cgroupPath("cpu");
+    const std::string roots[] = {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"};
+    for(const std::string& root : roots)
+    {
+        std::string quota;
+        std::string period;
+        if((readFirstLine(root + path + "/cpu.cfs_quota_us", &quota) &&
+            readFirstLine(root + path + "/cpu.cfs_period_us", &period)) ||
+           (readFirstLine(root + "/cpu.cfs_quota_us", &quota) &&
+            readFirstLine(root + "/cpu.cfs_period_us", &period)))
+        {
+            long quotaUs = 0;
+            long periodUs = 0;
+            if(!parseLong(quota, &quotaUs) || !parseLong(period, &periodUs))
+            {
+                LOG_WARN << "unexpected cpu.cfs_quota_us/cpu.cfs_period_us content: " << quota << " " << period;
+                return {0, 0};
+            }
+            return {quotaUs, periodUs};
+        }
+    }
+    return {-1, 0};
+}
+
+}// namespace details
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::istringstream iss(list);
+    std::string range;
+    while(std::getline(iss, range, ','))
+    {
+        int first = 0;
+        int last = 0;
+        int n = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+        if(n == 1)
+        {
+            cpus.push_back(first);
+        }
+        else if(n == 2)
+        {
+            for(int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+std::vector<int> CpuTopology::allowedCpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(::sched_getaffinity(0, sizeof set, &set) < 0)
+    {
+        LOG_SYSERR << "sched_getaffinity failed";
+        return cpus;
+    }
+    for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if(CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::vector<int> CpuTopology::physicalCores()
+{
+    std::vector<int> allowed = allowedCpus();
+    std::vector<int> cores;
+    std::set<std::pair<int, int>> seen; // (package, core_id)
+    for(int cpu : allowed)
+    {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::string packageText;
+        std::string coreText;
+        long package = 0;
+        long core = 0;
+        if(!details::readFirstLine(base + "physical_package_id", &packageText) ||
+           !details::readFirstLine(base + "core_id", &coreText))
+        {
+            // 没有拓扑信息时把每个逻辑 CPU 当作一个物理核
+            cores.push_back(cpu);
+            continue;
+        }
+        if(!details::parseLong(packageText, &package) || !details::parseLong(coreText, &core))
+        {
+            LOG_WARN << "unexpected topology content for cpu" << cpu << ": " << packageText << " " << coreText;
+            cores.push_back(cpu);
+            continue;
+        }
+        if(seen.insert({static_cast<int>(package), static_cast<int>(core)}).second)
+        {
+            cores.push_back(cpu);
+        }
+    }
+    return cores;
+}
+
+std::vector<int> CpuTopology::numaNodeCpus(int node)
+{
+    std::string list;
+    std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+    if(!details::readFirstLine(path, &list))
+    {
+        LOG_WARN << "NUMA node " << node << " not found: " << path;
+        return {};
+    }
+    return details::intersect(parseCpuList(list), allowedCpus());
+}
+
+int CpuTopology::cgroupCpuLimit()
+{
+    std::pair<long, long> quota = details::cgroupV2Quota();
+    if(quota.first < 0)
+    {
+        quota = details::cgroupV1Quota();
+    }
+    if(quota.first <= 0 || quota.second <= 0)
+    {
+        return 0;
+    }
+    return static_cast<int>((quota.first + quota.second - 1) / quota.second);
+}
+
+int CpuTopology::availableCpus()
+{
+    int count = static_cast<int>(allowedCpus().size());
+    int limit = cgroupCpuLimit();
+    if(limit > 0 && (count == 0 || limit < count))
+    {
+        count = limit;
+    }
+    return count > 0 ? count : 1;
+}
+
+std::vector<int> CpuTopology::cpusForThread(const CpuPlacementPolicy& policy, int index)
+{
+    std::vector<int> candidates;
+    switch(policy.mode)
+    {
+        case CpuPlacement::kNone:
+            return {};
+        case CpuPlacement::kExplicit:
+            candidates = policy.cpus;
+            break;
+        case CpuPlacement::kPhysicalCores:
+            candidates = physicalCores();
+            break;
+        case CpuPlacement::kNumaNode:
+            return numaNodeCpus(policy.numaNode);
+    }
+    if(candidates.empty())
+    {
+        return {};
+    }
+    return {candidates[static_cast<size_t>(index) % candidates.size()]};
+}
+
+bool CpuTopology::pinCurrentThread(const std::vector<int>& cpus)
+{
+    if(cpus.empty()) return true;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int cpu : cpus)
+    {
+        if(cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    int err = ::pthread_setaffinity_np(::pthread_self(), sizeof set, &set);
+    if(err != 0)
+    {
+        LOG_ERROR << "pthread_setaffinity_np failed: " << strerror_tl(err);
+        return false;
+    }
+    return true;
+}
+
+}// namespace reactor
@@ -0,0 +1,195 @@
+#include "reactor/epollpoller.h"
+#include "reactor/channel.h"
+#include "reactor/logging.h"
+#include <unistd.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace reactor
+{
+
+const int initialEventCount = 64;
+const size_t initialChannelCount = 64;
+
+EPollPoller::EPollPoller()
+    :m_epollfd(epoll_create1(EPOLL_CLOEXEC)),
+     m_events(initialEventCount),
+     m_channels(initialChannelCount, nullptr)
+{
+    if(m_epollfd < 0)
+    {
+        LOG_SYSFATAL << "Failed to create epoll file descriptor";
+    }
+}
+
+EPollPoller::~EPollPoller()
+{
+    if(close(m_epollfd) < 0)
+    {
+        LOG_SYSERR << "Failed to close epoll file descriptor";
+    }
+}
+
+void EPollPoller::poll(int timeoutMs, ChannelList* activeChannels)
+{
+    ++m_syscalls;
+    int numEvents = epoll_wait(m_epollfd, m_events.data(), static_cast<int>(m_events.size()), timeoutMs);
+
+    if(numEvents > 0)
+    {
+        LOG_TRACE << numEvents << " events happened";
+        fillActiveChannels(numEvents, *activeChannels);
+
+        // 如果活跃的事件数量超过当前事件列表的大小，扩展事件列表
+        if(static_cast<size_t>(numEvents) == m_events.size())
+        {
+            m_events.resize(m_events.size() * 2);
+        }
+    }
+    else if(numEvents == 0)
+    {
+        // 超时，没有事件发生
+        LOG_TRACE << "epoll_wait timeout";
+    }
+    else
+    {
+        if(errno != EINTR)
+        {
+            // 发生错误，输出错误信息
+            LOG_SYSERR << "epoll_wait error";
+        }
+    }
+}
+
+void EPollPoller::fillActiveChannels(int numEvents, ChannelList& activeChannels) const
+{
+    for(int i = 0; i < numEvents; ++i)
+    {
+        Channel* channel = static_cast<Channel*>(m_events[i].data.ptr);
+        assert(channel != nullptr);
+
+        // 设置实际发生的事件
+        channel->setRevents(m_events[i].events);
+        // 单次触发的 fd 通知后被内核禁用，需要 rearm() 才会再次通知
+        if(channel->registeredEvents() & EPOLLONESHOT)
+        {
+            channel->setRegisteredEvents(0);
+        }
+        activeChannels.push_back(channel);
+    }
+}
+
+void EPollPoller::addChannel(int fd, Channel* channel)
+{
+    assert(fd >= 0);
+    const size_t slot = static_cast<size_t>(fd);
+    if(slot >= m_channels.size())
+    {
+        m_channels.resize(std::max(slot + 1, m_channels.size() * 2), nullptr);
+    }
+    assert(m_channels[slot] == nullptr);
+    m_channels[slot] = channel;
+}
+
+void EPollPoller::updateChannel(Channel* channel)
+{
+    const int index = channel->index();
+    const int fd = channel->fd();
+    const uint32_t events = channel->pollEvents();
+    LOG_TRACE << "fd=" << fd << " events=" << events;
+
+    // 获取该Channel在epoll中的状态
+
+    if (index == kNew || index == kDeleted)
+    {
+        // 新Channel或已删除的Channel，需要添加到epoll
+        if (index == kNew) 
+        {
+            addChannel(fd, channel);
+        } 
+        else 
+        {
+            // kDeleted
+            assert(findChannel(fd) == channel);
+        }
+
+        channel->setIndex(kAdded); // 设置为已添加状态
+
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.ptr = channel;
+
+        ++m_syscalls;
+        if (::epoll_ctl(m_epollfd, EPOLL_CTL_ADD, fd, &event) < 0) 
+        {
+            LOG_SYSFATAL << "EPollPoller::updateChannel() epoll_ctl ADD failed, fd=" << fd;
+        }
+        channel->setRegisteredEvents(events);
+    } 
+    else 
+    {
+        // kAdded，已在epoll中
+        assert(index == kAdded);
+        assert(findChannel(fd) == channel);
+
+        if (channel->isNoneEvent()) 
+        {
+            // 没有关心任何事件，从epoll中删除
+            ++m_syscalls;
+            if (::epoll_ctl(m_epollfd, EPOLL_CTL_DEL, fd, nullptr) < 0) 
+            {
+                LOG_SYSFATAL << "EPollPoller::updateChannel() epoll_ctl DEL failed, fd=" << fd;
+            }
+            channel->setIndex(kDeleted);  // 标记为已删除
+            channel->setRegisteredEvents(0);
+        } 
+        else if (events == channel->registeredEvents())
+        {
+            // 注册的事件没有变化（边沿触发下开关写事件、已启用的单次触发 rearm），不需要系统调用
+        }
+        else 
+        {
+            // 修改事件
+            struct epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = events;
+            event.data.ptr = channel;
+
+            ++m_syscalls;
+            if (::epoll_ctl(m_epollfd, EPOLL_CTL_MOD, fd, &event) < 0) {
+                LOG_SYSFATAL << "EPollPoller::updateChannel() epoll_ctl MOD failed, fd=" << fd;
+            }
+            channel->setRegisteredEvents(events);
+        }
+    }
+}
+
+void EPollPoller::removeChannel(Channel* channel)
+{
+    const int fd = channel->fd();
+    const int index = channel->index();
+    LOG_TRACE << "fd = " << fd;
+
+    assert(findChannel(fd) == channel);
+    assert(channel->isNoneEvent());
+    assert(index == kAdded || index == kDeleted);
+
+    m_channels[static_cast<size_t>(fd)] = nullptr;
+
+    // 只有在kAdded状态才需要从epoll删除
+    // 如果是kDeleted，说明已经通过disableAll()删除过了
+    if (index == kAdded) 
+    {
+        ++m_syscalls;
+        if (::epoll_ctl(m_epollfd, EPOLL_CTL_DEL, fd, nullptr) < 0) 
+        {
+            LOG_SYSFATAL << "EPollPoller::removeChannel() epoll_ctl DEL failed, fd=" << fd;
+        }
+    }
+    channel->setIndex(kNew); // 设置为新状态
+    channel->setRegisteredEvents(0);
+}
+
+}
\ No newline at end of file
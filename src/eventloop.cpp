@@ -1,9 +1,16 @@
 #include "reactor/eventloop.h"
 #include "reactor/channel.h"
 #include "reactor/poller.h"
+#include "reactor/iouringpoller.h"
+#include "reactor/pipepool.h"
+#include "reactor/framepool.h"
+#include "reactor/computepool.h"
 #include "reactor/timerqueue.h"
+#include "reactor/timestamp.h"
+#include "reactor/logging.h"
 #include <cassert>
-#include <iostream>
+#include <chrono>
+#include <sched.h>
 #include <sys/eventfd.h>
 
 namespace reactor
@@ -15,28 +22,80 @@ thread_local EventLoop* loopInThisThread = nullptr;
 //epoll wait timeout
 constexpr int kPollTimeoutMs = 10000; // 10秒
 
+// 活跃Channel列表的初始容量
+// 预留足够空间，避免稳定状态下偶发的突发流量触发扩容
+constexpr size_t kInitialListCapacity = 64;
+
+// Loop 线程缓存的空闲任务节点上限（本线程节点和归还给生产者的节点各自计算）
+constexpr size_t kMaxFreeTasks = 1024;
+
+// 开启指标时每 kTaskLatencySampleMask + 1 个任务采样一次排队延迟，投递方不必每次都读时钟
+constexpr size_t kTaskLatencySampleMask = 15;
+
+// 利用率统计窗口
+constexpr int64_t kUtilizationWindowNs = 100 * 1000 * 1000;
+
+// 忙轮询时每空转这么多次让出一次 CPU
+constexpr int kSpinsPerYield = 64;
+
+// 自旋等待提示：降低功耗，并让出流水线给同一物理核上的超线程
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+static int64_t steadyNowNs()
+{
+    return toNanoseconds(MonoClock::now());
+}
+
 static int createEventFd()
 {
     int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     if(fd < 0)
     {
-        std::cerr << "Failed in eventfd" << std::endl;
-        abort();
+        LOG_SYSFATAL << "Failed in eventfd";
     }
     return fd;
 }
 
-EventLoop::EventLoop()
+EventLoop::EventLoop(const EventLoopOptions& options)
     :m_isLooping(false),
      m_quit(false),
-     m_callingPendingFunctors(false),
+     m_sleeping(false),
+     m_wakeupPending(false),
+     m_dispatching(false),
+     m_numChannels(0),
+     m_tasksQueued(0),
+     m_tasksDone(0),
+     m_utilizationPermille(0),
+     m_pollBeginNs(0),
+     m_windowBeginNs(0),
+     m_windowBusyNs(0),
+     m_metrics(options.enableMetrics ? std::make_unique<LoopMetrics>() : nullptr),
+     m_now(MonoClock::now()),
+     m_timerSlack(std::chrono::microseconds(options.timerSlackMicroseconds)),
+     m_busyPollNs(options.busyPollMicroseconds > 0 ? options.busyPollMicroseconds * 1000 : 0),
+     m_busyPollYield(options.busyPollYield),
      m_threadId(tid()),
-     m_poller(std::make_unique<Poller>()),
-     m_timerQueue(std::make_unique<TimerQueue>(this)), // 初始化 TimerQueue
+     m_poller(Poller::newPoller(options)),
+     m_ioUring(dynamic_cast<IoUringPoller*>(m_poller.get())),
+     m_timerQueue(std::make_unique<TimerQueue>(this, options.timerBackend, options.timingWheelTickMicroseconds)), // 初始化 TimerQueue
      m_wakeupFd(createEventFd()),
-     m_wakeupChannle(std::make_unique<Channel>(this, m_wakeupFd))
+     m_wakeupChannle(std::make_unique<Channel>(this, m_wakeupFd)),
+     m_pendingTasks(),
+     m_computePool(nullptr),
+     m_offloadsInFlight(0),
+     m_freeTasks(nullptr),
+     m_freeTaskCount(0),
+     m_remoteFreeTasks(nullptr),
+     m_remoteFreeCount(0)
 {
-    std::cout << "EventLoop created " << this << " in thread " << m_threadId << std::endl;
+    LOG_DEBUG << "EventLoop created " << this << " in thread " << m_threadId;
 
     // 检查当前线程是否已经有 EventLoop
     if(loopInThisThread)
@@ -48,6 +107,10 @@ EventLoop::EventLoop()
         loopInThisThread = this; // 设置当前线程的 EventLoop
     }   
 
+    m_activeChannels.reserve(kInitialListCapacity);
+    m_afterDispatch.reserve(kInitialListCapacity);
+    m_runningAfterDispatch.reserve(kInitialListCapacity);
+
     //设置wakepfd
     m_wakeupChannle->setReadCallback(std::bind(&EventLoop::handleReadForWakeupFd, this));
     m_wakeupChannle->enableReading();
@@ -55,13 +118,35 @@ EventLoop::EventLoop()
 
 EventLoop::~EventLoop()
 {
-    std::cout << "EventLoop destroyed " << this << " in thread " << m_threadId << std::endl;
+    LOG_DEBUG << "EventLoop destroyed " << this << " in thread " << m_threadId;
 
     m_wakeupChannle->disableAll();
     m_wakeupChannle->remove();
     close(m_wakeupFd);
     assert(!m_isLooping);
     loopInThisThread = nullptr; // 清除当前线程的 EventLoop
+
+    // 释放未执行的任务和空闲节点
+    PendingTask* task = m_pendingTasks.takeAll();
+    while(task)
+    {
+        PendingTask* next = task->next.load(std::memory_order_relaxed);
+        delete task;
+        task = next;
+    }
+    while(m_freeTasks)
+    {
+        PendingTask* next = m_freeTasks->next.load(std::memory_order_relaxed);
+        delete m_freeTasks;
+        m_freeTasks = next;
+    }
+    task = m_remoteFreeTasks.exchange(nullptr, std::memory_order_acquire);
+    while(task)
+    {
+        PendingTask* next = task->next.load(std::memory_order_relaxed);
+        delete task;
+        task = next;
+    }
 }
 
 void EventLoop::loop()
@@ -69,13 +154,51 @@ void EventLoop::loop()
     assert(!m_isLooping);
     assertInLoopThread();
 
+    // m_quit 不在这里清零：EventLoopThread::startLoop() 返回时线程可能还没进入 loop()，
+    // 此时的 quit() 不能丢失（运行时退役刚加入的 Loop）
     m_isLooping = true;
-    m_quit = false;
+
+    m_windowBeginNs = steadyNowNs();
+    m_windowBusyNs = 0;
+    int64_t busyBeginNs = m_windowBeginNs;
+    int64_t lastPollBeginNs = -1;
+    LoopMetrics* metrics = m_metrics.get();
 
     while (!m_quit)
     {
-        m_activeChannels = m_poller->poll(kPollTimeoutMs);
+        m_activeChannels.clear();
+
+        // 上一次 poll 返回到这次 poll 开始之间是忙碌时间
+        int64_t pollBeginNs = steadyNowNs();
+        updateUtilization(pollBeginNs, pollBeginNs - busyBeginNs);
+        if(metrics && lastPollBeginNs >= 0)
+        {
+            metrics->callbackNs.record(static_cast<uint64_t>(pollBeginNs - busyBeginNs));
+            metrics->iterationNs.record(static_cast<uint64_t>(pollBeginNs - lastPollBeginNs));
+        }
+        lastPollBeginNs = pollBeginNs;
 
+        // 忙轮询期间等到了事件或任务就不再阻塞
+        if(m_busyPollNs == 0 || !busyPoll(pollBeginNs))
+        {
+            // 先声明即将休眠，再检查任务队列（两者都是 seq_cst）：
+            // - 生产者在此之前加入的任务，这里一定能看到，于是不阻塞
+            // - 之后加入的任务，生产者一定能看到 m_sleeping == true，负责写 eventfd
+            m_sleeping.store(true);
+            int timeoutMs = m_pendingTasks.empty() ? kPollTimeoutMs : 0;
+            m_poller->poll(timeoutMs, &m_activeChannels);
+            m_sleeping.store(false);
+            m_wakeupPending.store(false);
+        }
+        m_now = MonoClock::now();
+        busyBeginNs = toNanoseconds(m_now);
+        if(metrics)
+        {
+            metrics->pollWaitNs.record(static_cast<uint64_t>(busyBeginNs - pollBeginNs));
+            metrics->eventsPerPoll.record(m_activeChannels.size());
+        }
+
+        m_dispatching = true;
         for (Channel* channel : m_activeChannels)
         {
             channel->handleEvent(); // 处理每个活跃的 Channel 事件
@@ -83,12 +206,84 @@ void EventLoop::loop()
 
         // 处理pending任务
         doPendingFunctors();
+
+        // 本轮产生的输出合并发送
+        doAfterDispatch();
     }
 
-    std::cout << "EventLoop " << this << " stop looping" << std::endl;
+    LOG_DEBUG << "EventLoop " << this << " stop looping";
+    m_quit = false; // 允许再次 loop()
     m_isLooping = false;
 }
 
+bool EventLoop::busyPoll(int64_t beginNs)
+{
+    // 空转期间 m_sleeping 为 false，跨线程 queueInLoop 不写 eventfd，这里直接检查队列
+    const int64_t deadline = beginNs + m_busyPollNs;
+    int spins = 0;
+    while(!m_quit)
+    {
+        if(!m_pendingTasks.empty()) return true;
+        m_poller->poll(0, &m_activeChannels);
+        if(!m_activeChannels.empty()) return true;
+        if(steadyNowNs() >= deadline) return false;
+
+        if(m_busyPollYield && ++spins == kSpinsPerYield)
+        {
+            spins = 0;
+            ::sched_yield();
+        }
+        else
+        {
+            cpuRelax();
+        }
+    }
+    return true;
+}
+
+void EventLoop::updateUtilization(int64_t nowNs, int64_t busyNs)
+{
+    m_pollBeginNs.store(nowNs, std::memory_order_relaxed);
+    m_windowBusyNs += busyNs;
+    int64_t elapsed = nowNs - m_windowBeginNs;
+    if(elapsed >= kUtilizationWindowNs)
+    {
+        m_utilizationPermille.store(static_cast<uint32_t>(m_windowBusyNs * 1000 / elapsed),
+                                    std::memory_order_relaxed);
+        m_windowBeginNs = nowNs;
+        m_windowBusyNs = 0;
+    }
+}
+
+size_t EventLoop::pendingTasks() const
+{
+    size_t done = m_tasksDone.load(std::memory_order_relaxed);
+    size_t queued = m_tasksQueued.load(std::memory_order_relaxed);
+    return queued > done ? queued - done : 0;
+}
+
+LoopMetricsSnapshot EventLoop::metricsSnapshot() const
+{
+    if(!m_metrics)
+    {
+        LoopMetricsSnapshot snap;
+        snap.threadId = m_threadId;
+        return snap;
+    }
+    return m_metrics->snapshot(m_threadId);
+}
+
+double EventLoop::utilization() const
+{
+    // 长时间阻塞在 poll 中时窗口不会更新，视为空闲
+    if(m_sleeping.load(std::memory_order_relaxed) &&
+       steadyNowNs() - m_pollBeginNs.load(std::memory_order_relaxed) >= kUtilizationWindowNs)
+    {
+        return 0.0;
+    }
+    return m_utilizationPermille.load(std::memory_order_relaxed) / 1000.0;
+}
+
 void EventLoop::quit()
 {
     m_quit = true;
@@ -99,7 +294,12 @@ void EventLoop::updateChannel(Channel* channel)
 {
     assertInLoopThread();
     assert(channel->ownerLoop() == this);
+    const bool isNew = channel->index() < 0; // 还没加入 Poller
     m_poller->updateChannel(channel); // 更新 Poller 中的 Channel
+    if(isNew)
+    {
+        m_numChannels.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 void EventLoop::removeChannel(Channel* channel)
@@ -107,6 +307,42 @@ void EventLoop::removeChannel(Channel* channel)
     assertInLoopThread();
     assert(channel->ownerLoop() == this);
     m_poller->removeChannel(channel); // 从 Poller 中移除 Channel
+    m_numChannels.fetch_sub(1, std::memory_order_relaxed);
+}
+
+PipePool* EventLoop::pipePool()
+{
+    assertInLoopThread();
+    if(!m_pipePool)
+    {
+        m_pipePool = std::make_unique<PipePool>();
+    }
+    return m_pipePool.get();
+}
+
+FramePool* EventLoop::framePool()
+{
+    assertInLoopThread();
+    if(!m_framePool)
+    {
+        m_framePool = std::make_unique<FramePool>();
+    }
+    return m_framePool.get();
+}
+
+void EventLoop::submitCompute(Functor task)
+{
+    // 在提交之前计数：之后 ComputePool 线程还会回调本 Loop 的 queueInLoop
+    m_offloadsInFlight.fetch_add(1, std::memory_order_relaxed);
+    ComputePool* pool = computePool();
+    if(pool)
+    {
+        pool->submit(std::move(task));
+    }
+    else
+    {
+        task();
+    }
 }
 
 EventLoop* EventLoop::getEventLoopOfCurrentThread()
@@ -116,27 +352,34 @@ EventLoop* EventLoop::getEventLoopOfCurrentThread()
 
 void EventLoop::abortNotInLoopThread()
 {
-    std::cerr << "EventLoop::abortNotInLoopThread() - EventLoop " << this
+    LOG_FATAL << "EventLoop::abortNotInLoopThread() - EventLoop " << this
               << " was created in thread " << m_threadId
-              << ", but called in thread " << tid() << std::endl;
-    abort();
+              << ", but called in thread " << tid();
+}
+
+TimerId EventLoop::runAt(MonoTime time, TimerCallback cb, Nanoseconds slack)
+{
+    if(slack < Nanoseconds::zero()) slack = m_timerSlack;
+    return m_timerQueue->addTimer(std::move(cb), time, Nanoseconds::zero(), slack); // 添加单次定时器
 }
 
 TimerId EventLoop::runAt(Timestamp time, TimerCallback cb)
 {
-    return m_timerQueue->addTimer(std::move(cb), time, 0.0); // 添加单次定时器
+    int64_t delayUs = time.microSecondsSinceEpoch() - Timestamp::now().microSecondsSinceEpoch();
+    return runAfter(std::chrono::microseconds(delayUs), std::move(cb));
 }
 
-TimerId EventLoop::runAfter(double delay, TimerCallback cb)
+// 延时从调用时刻算起，而不是缓存的 m_now：
+// 其他线程不能读 m_now，Loop 线程中 m_now 可能已经落后于本轮前面回调的耗时
+TimerId EventLoop::runAfter(Nanoseconds delay, TimerCallback cb, Nanoseconds slack)
 {
-    Timestamp time(addTime(Timestamp::now(), delay));
-    return runAt(time, std::move(cb)); // 添加延时定时器
+    return runAt(MonoClock::now() + delay, std::move(cb), slack); // 添加延时定时器
 }
 
-TimerId EventLoop::runEvery(double interval, TimerCallback cb)
+TimerId EventLoop::runEvery(Nanoseconds interval, TimerCallback cb, Nanoseconds slack)
 {
-    Timestamp time(addTime(Timestamp::now(), interval));
-    return m_timerQueue->addTimer(std::move(cb), time, interval); // 添加重复定时器
+    if(slack < Nanoseconds::zero()) slack = m_timerSlack;
+    return m_timerQueue->addTimer(std::move(cb), MonoClock::now() + interval, interval, slack); // 添加重复定时器
 }
 
 void EventLoop::cancel(TimerId timerId)
@@ -158,17 +401,132 @@ void EventLoop::runInLoop(Functor cb)
 
 void EventLoop::queueInLoop(Functor cb)
 {
+    PendingTask* task = allocTask();
+    task->fn = std::move(cb);
+    size_t seq = m_tasksQueued.fetch_add(1, std::memory_order_relaxed);
+    task->enqueueNs = m_metrics && (seq & kTaskLatencySampleMask) == 0 ? steadyNowNs() : 0;
+    m_pendingTasks.push(task);
+
+    // 在Loop线程调用：Loop 阻塞前会检查队列，不需要唤醒
+    // 在其他线程调用：只有Loop正在/即将阻塞时才需要唤醒，
+    //   并且同一轮中只有第一个生产者真正写 eventfd
+    if(!isInLoopThread() && m_sleeping.load() && !m_wakeupPending.exchange(true))
+    {
+        wakeup();
+    }
+}
+
+void EventLoop::queueInLoopBatch(std::vector<Functor> tasks)
+{
+    if(tasks.empty()) return;
+
+    // 先在本线程把节点串成链（newest -> ... -> oldest），再整条挂到队列上
+    // 开启指标时每批只采样第一个任务
+    int64_t enqueueNs = m_metrics ? steadyNowNs() : 0;
+    PendingTask* oldest = nullptr;
+    PendingTask* newest = nullptr;
+    for(Functor& fn : tasks)
+    {
+        PendingTask* task = allocTask();
+        task->fn = std::move(fn);
+        task->enqueueNs = enqueueNs;
+        enqueueNs = 0;
+        task->next.store(newest, std::memory_order_relaxed);
+        newest = task;
+        if(oldest == nullptr) oldest = task;
+    }
+    m_tasksQueued.fetch_add(tasks.size(), std::memory_order_relaxed);
+    m_pendingTasks.pushChain(newest, oldest);
+
+    if(!isInLoopThread() && m_sleeping.load() && !m_wakeupPending.exchange(true))
+    {
+        wakeup();
+    }
+}
+
+// 生产者线程的空闲节点：从目标 Loop 的归还栈整批取得，线程退出时释放
+// 节点不属于某个 Loop，向多个 Loop 投递的线程共用一个缓存
+struct EventLoop::TaskCache
+{
+    PendingTask* head = nullptr;
+
+    ~TaskCache()
+    {
+        while(head)
+        {
+            PendingTask* next = head->next.load(std::memory_order_relaxed);
+            delete head;
+            head = next;
+        }
+    }
+};
+
+EventLoop::TaskCache& EventLoop::producerTaskCache()
+{
+    thread_local TaskCache cache;
+    return cache;
+}
+
+EventLoop::PendingTask* EventLoop::allocTask()
+{
+    PendingTask* task;
+    if(isInLoopThread())
     {
-        std::lock_guard<std::mutex> lock(m_mtx);
-        m_pendingFactors.push_back(std::move(cb));
+        // 空闲链表只在Loop线程访问
+        if(m_freeTasks == nullptr) return new PendingTask;
+        task = m_freeTasks;
+        m_freeTasks = task->next.load(std::memory_order_relaxed);
+        --m_freeTaskCount;
+        return task;
     }
-    // 情况1：在其他线程调用
-    // → 必须唤醒，否则Loop可能阻塞在poll中
 
-    // 情况2：在Loop线程，但正在执行pending任务
-    // → 也要唤醒，因为当前循环的poll已经返回了
-    //   如果不唤醒，新任务要等下次poll超时才执行
-    if(!isInLoopThread() || m_callingPendingFunctors) wakeup();
+    // 其他线程：先用本地缓存，缓存空了再取走本 Loop 归还的全部节点
+    TaskCache& cache = producerTaskCache();
+    if(cache.head == nullptr)
+    {
+        cache.head = m_remoteFreeTasks.exchange(nullptr, std::memory_order_acquire);
+    }
+    if(cache.head == nullptr)
+    {
+        task = new PendingTask;
+    }
+    else
+    {
+        task = cache.head;
+        cache.head = task->next.load(std::memory_order_relaxed);
+    }
+    task->remote = true;
+    return task;
+}
+
+void EventLoop::recycleTask(PendingTask* task)
+{
+    task->fn = nullptr; // 及时释放回调捕获的资源
+    if(!task->remote)
+    {
+        if(m_freeTaskCount < kMaxFreeTasks)
+        {
+            task->next.store(m_freeTasks, std::memory_order_relaxed);
+            m_freeTasks = task;
+            ++m_freeTaskCount;
+            return;
+        }
+    }
+    else if(m_remoteFreeCount < kMaxFreeTasks ||
+            m_remoteFreeTasks.load(std::memory_order_relaxed) == nullptr)
+    {
+        // 只有 Loop 线程 push；CAS 成功时的旧栈顶为空说明生产者已经整批取走，计数从头开始
+        PendingTask* head = m_remoteFreeTasks.load(std::memory_order_relaxed);
+        do
+        {
+            task->next.store(head, std::memory_order_relaxed);
+        } while(!m_remoteFreeTasks.compare_exchange_weak(head, task,
+                                                         std::memory_order_release,
+                                                         std::memory_order_relaxed));
+        m_remoteFreeCount = head == nullptr ? 1 : m_remoteFreeCount + 1;
+        return;
+    }
+    delete task;
 }
 
 void EventLoop::wakeup()
@@ -177,7 +535,7 @@ void EventLoop::wakeup()
     ssize_t n = write(m_wakeupFd, &one, sizeof one);
     if (n != sizeof one) 
     {
-        std::cerr << "EventLoop::wakeup() writes " << n << " bytes instead of 8" << std::endl;
+        LOG_ERROR << "EventLoop::wakeup() writes " << n << " bytes instead of 8";
     }
 }
 
@@ -187,23 +545,58 @@ void EventLoop::handleReadForWakeupFd()
     ssize_t n = read(m_wakeupFd, &one, sizeof one);
     if (n != sizeof one) 
     {
-        std::cerr << "EventLoop::wakeup() writes " << n << " bytes instead of 8" << std::endl;
+        LOG_ERROR << "EventLoop::handleReadForWakeupFd() reads " << n << " bytes instead of 8";
     }
 }
 
-void EventLoop::doPendingFunctors()
+void EventLoop::runAfterDispatch(Functor cb)
 {
-    std::vector<Functor> functors;
-    m_callingPendingFunctors = true;
+    assertInLoopThread();
+    m_afterDispatch.push_back(std::move(cb));
+}
+
+void EventLoop::doAfterDispatch()
+{
+    m_dispatching = false;
+    // 交换到 m_runningAfterDispatch 再执行，回调中可以继续 runAfterDispatch
+    while(!m_afterDispatch.empty())
     {
-        std::lock_guard<std::mutex> lock(m_mtx);
-        functors.swap(m_pendingFactors);
+        m_runningAfterDispatch.swap(m_afterDispatch);
+        for(Functor& cb : m_runningAfterDispatch)
+        {
+            cb();
+        }
+        m_runningAfterDispatch.clear();
     }
+}
 
-    for(const Functor& f : functors) f();
-
-    m_callingPendingFunctors = false;
-
+void EventLoop::doPendingFunctors()
+{
+    // 一次取走当前全部任务（快照），执行期间新加入的任务留到下一轮
+    PendingTask* task = m_pendingTasks.takeAll();
+    LoopMetrics* metrics = m_metrics.get();
+    int64_t startNs = 0;
+    size_t count = 0;
+    while(task)
+    {
+        PendingTask* next = task->next.load(std::memory_order_relaxed);
+        if(metrics && task->enqueueNs != 0)
+        {
+            // 只对采样的任务记录；每批最多读一次时钟，同批任务的排队时间按第一个采样任务开始执行时计算
+            if(startNs == 0) startNs = steadyNowNs();
+            int64_t waitedNs = startNs - task->enqueueNs;
+            metrics->taskLatencyNs.record(waitedNs > 0 ? static_cast<uint64_t>(waitedNs) : 0);
+        }
+        task->fn();
+        recycleTask(task);
+        task = next;
+        ++count;
+    }
+    if(count > 0)
+    {
+        if(metrics) metrics->pendingDepth.record(count);
+        m_tasksDone.store(m_tasksDone.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
 }
 
 }
\ No newline at end of file
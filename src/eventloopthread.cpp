@@ -1,11 +1,13 @@
 #include "reactor/eventloopthread.h"
 #include "reactor/eventloop.h"
+#include "reactor/cputopology.h"
 
 namespace reactor 
 {
 
-EventLoopThread::EventLoopThread()
-    : m_loop(nullptr)
+EventLoopThread::EventLoopThread(const EventLoopOptions& options)
+    : m_loop(nullptr),
+      m_options(options)
 {}
 
 EventLoopThread::~EventLoopThread()
@@ -30,7 +32,9 @@ EventLoop* EventLoopThread::startLoop()
 
 void EventLoopThread::threadFunc()
 {
-    EventLoop loop;
+    CpuTopology::pinCurrentThread(m_cpus);
+
+    EventLoop loop(m_options);
     {
         std::unique_lock<std::mutex> lock(m_mtx);
         m_loop = &loop;
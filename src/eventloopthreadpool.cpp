@@ -1,6 +1,8 @@
 #include "reactor/eventloopthreadpool.h"
 #include "reactor/eventloop.h"
 #include "reactor/eventloopthread.h"
+#include "reactor/logging.h"
+#include <algorithm>
 #include <cassert>
 
 namespace reactor 
@@ -9,12 +11,38 @@ EventLoopThreadPool::EventLoopThreadPool(EventLoop* baseloop)
     : m_baseloop(baseloop),
       m_started(false),
       m_threadNums(0),
-      m_next(0)
+      m_next(0),
+      m_strategy(LoadBalance::kRoundRobin),
+      m_randomState(0x9E3779B97F4A7C15ull),
+      m_loopOptions(),
+      m_computePool(nullptr),
+      m_autoscaleEnabled(false),
+      m_aboveCount(0),
+      m_belowCount(0)
 {}
 
 EventLoopThreadPool::~EventLoopThreadPool()
 {
-    
+    // 定时器回调引用 this
+    if(m_started)
+    {
+        m_baseloop->cancel(m_drainTimer);
+        m_baseloop->cancel(m_autoscaleTimer);
+    }
+}
+
+void EventLoopThreadPool::setLoopOptions(int index, const EventLoopOptions& options)
+{
+    assert(!m_started);
+    for(auto& entry : m_loopOptionsOverrides)
+    {
+        if(entry.first == index)
+        {
+            entry.second = options;
+            return;
+        }
+    }
+    m_loopOptionsOverrides.emplace_back(index, options);
 }
 
 void EventLoopThreadPool::start()
@@ -24,32 +52,315 @@ void EventLoopThreadPool::start()
     m_baseloop->assertInLoopThread();
 
     m_started = true;
+    if(m_threadNums == kAutoThreadNum)
+    {
+        m_threadNums = CpuTopology::availableCpus();
+        if(m_placement.mode == CpuPlacement::kNumaNode)
+        {
+            int nodeCpus = static_cast<int>(CpuTopology::numaNodeCpus(m_placement.numaNode).size());
+            if(nodeCpus > 0 && nodeCpus < m_threadNums) m_threadNums = nodeCpus;
+        }
+        LOG_INFO << "EventLoopThreadPool auto thread num: " << m_threadNums;
+    }
+
     for(int i = 0; i < m_threadNums; ++i)
     {
-        auto thread = std::make_unique<EventLoopThread>();
-        m_loops.push_back(thread->startLoop());
-        m_pool.push_back(std::move(thread));
+        addLoop();
+    }
+    if(m_computePool)
+    {
+        m_baseloop->setComputePool(m_computePool);
+    }
+    if(m_autoscaleEnabled)
+    {
+        enableAutoscale(m_autoscale);
     }
     // 如果m_threadNums == 0，loops为空
     // getNextLoop()会返回baseLoop
 }
 
+EventLoop* EventLoopThreadPool::addLoop()
+{
+    assert(m_started);
+    m_baseloop->assertInLoopThread();
+
+    // 最小的空闲下标：退役后再加入的线程沿用原来的 CPU 和参数
+    int slot = 0;
+    while(std::any_of(m_workers.begin(), m_workers.end(), [slot](const Worker& w) { return w.slot == slot; }))
+    {
+        ++slot;
+    }
+
+    const EventLoopOptions* options = &m_loopOptions;
+    for(const auto& entry : m_loopOptionsOverrides)
+    {
+        if(entry.first == slot) options = &entry.second;
+    }
+    auto thread = std::make_unique<EventLoopThread>(*options);
+    std::vector<int> cpus = CpuTopology::cpusForThread(m_placement, slot);
+    if(m_placement.mode != CpuPlacement::kNone && cpus.empty())
+    {
+        LOG_WARN << "EventLoopThreadPool no cpu for thread " << slot << ", not pinned";
+    }
+    thread->setCpuAffinity(std::move(cpus));
+    EventLoop* loop = thread->startLoop();
+    loop->setComputePool(m_computePool);
+
+    Worker worker;
+    worker.thread = std::move(thread);
+    worker.loop = loop;
+    worker.slot = slot;
+    worker.idleChannels = loop->numChannels();
+    worker.retiring = false;
+    worker.closed = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workers.push_back(std::move(worker));
+        m_loops.push_back(loop);
+    }
+    LOG_DEBUG << "EventLoopThreadPool added loop " << loop << " slot " << slot
+              << ", " << m_loops.size() << " active";
+    return loop;
+}
+
+bool EventLoopThreadPool::retireLoop(EventLoop* loop)
+{
+    assert(m_started);
+    m_baseloop->assertInLoopThread();
+
+    if(loop == nullptr)
+    {
+        if(m_loops.empty()) return false;
+        loop = m_loops.back();
+    }
+    auto active = std::find(m_loops.begin(), m_loops.end(), loop);
+    if(active == m_loops.end()) return false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loops.erase(active);
+        for(Worker& worker : m_workers)
+        {
+            if(worker.loop == loop) worker.retiring = true;
+        }
+    }
+    m_next = m_loops.empty() ? 0 : m_next % static_cast<int>(m_loops.size());
+    LOG_DEBUG << "EventLoopThreadPool retiring loop " << loop << ", " << m_loops.size() << " active";
+
+    if(m_retiringCallback)
+    {
+        LoopCallback cb = m_retiringCallback;
+        loop->queueInLoop([cb, loop]() { cb(loop); });
+    }
+    if(!m_drainTimer.valid())
+    {
+        m_drainTimer = m_baseloop->runEvery(kDrainCheckInterval, [this]() { checkRetiring(); });
+    }
+    return true;
+}
+
+void EventLoopThreadPool::checkRetiring()
+{
+    for(size_t i = 0; i < m_workers.size();)
+    {
+        Worker& worker = m_workers[i];
+        EventLoop* loop = worker.loop;
+        // 还有 offload 在计算的 Loop 也不能关闭：ComputePool 线程之后会向它投递 continuation
+        if(!worker.retiring || loop->numChannels() > worker.idleChannels || loop->pendingTasks() > 0 ||
+           loop->pendingOffloads() > 0)
+        {
+            ++i;
+            continue;
+        }
+
+        // 先持锁关闭：之后的 broadcast 不会再投递到这个 Loop；
+        // 关闭前的投递已在锁内计入 pendingTasks()，等它们执行完（下次检查）再销毁
+        if(!worker.closed)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                worker.closed = true;
+            }
+            if(loop->pendingTasks() > 0 || loop->pendingOffloads() > 0)
+            {
+                ++i;
+                continue;
+            }
+        }
+
+        if(m_retiredCallback) m_retiredCallback(loop);
+        std::unique_ptr<EventLoopThread> thread;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            thread = std::move(worker.thread);
+            m_workers.erase(m_workers.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        thread.reset(); // quit 并等待线程退出
+        LOG_DEBUG << "EventLoopThreadPool retired loop " << loop;
+    }
+
+    if(numRetiring() == 0)
+    {
+        m_baseloop->cancel(m_drainTimer);
+        m_drainTimer = TimerId();
+    }
+}
+
+void EventLoopThreadPool::enableAutoscale(const AutoscaleOptions& options)
+{
+    m_autoscale = options;
+    m_autoscaleEnabled = true;
+    if(!m_started) return;
+
+    m_baseloop->assertInLoopThread();
+    m_baseloop->cancel(m_autoscaleTimer);
+    m_aboveCount = 0;
+    m_belowCount = 0;
+    m_autoscaleTimer = m_baseloop->runEvery(options.interval, [this]() { autoscaleTick(); });
+}
+
+void EventLoopThreadPool::disableAutoscale()
+{
+    m_autoscaleEnabled = false;
+    if(m_started)
+    {
+        m_baseloop->assertInLoopThread();
+        m_baseloop->cancel(m_autoscaleTimer);
+        m_autoscaleTimer = TimerId();
+    }
+}
+
+void EventLoopThreadPool::autoscaleTick()
+{
+    const AutoscaleOptions& opt = m_autoscale;
+    const int n = numLoops();
+    if(n < opt.minThreads)
+    {
+        addLoop();
+        return;
+    }
+
+    double total = 0.0;
+    for(const EventLoop* loop : m_loops)
+    {
+        total += loop->utilization();
+    }
+    const double average = n > 0 ? total / n : 1.0;
+
+    m_aboveCount = average > opt.scaleUpUtilization ? m_aboveCount + 1 : 0;
+    m_belowCount = average < opt.scaleDownUtilization ? m_belowCount + 1 : 0;
+
+    if(m_aboveCount >= opt.stableIntervals && n < opt.maxThreads)
+    {
+        LOG_INFO << "EventLoopThreadPool autoscale up: utilization " << average << ", " << n + 1 << " loops";
+        addLoop();
+        m_aboveCount = 0;
+    }
+    else if(m_belowCount >= opt.stableIntervals && n > opt.minThreads && numRetiring() == 0 &&
+            total / (n - 1) < opt.scaleUpUtilization)
+    {
+        // 退役 Channel 最少的 Loop，需要关闭或迁移的连接最少
+        EventLoop* victim = *std::min_element(m_loops.begin(), m_loops.end(),
+            [](const EventLoop* a, const EventLoop* b) { return a->numChannels() < b->numChannels(); });
+        LOG_INFO << "EventLoopThreadPool autoscale down: utilization " << average << ", " << n - 1 << " loops";
+        retireLoop(victim);
+        m_belowCount = 0;
+    }
+}
+
+std::vector<EventLoop*> EventLoopThreadPool::openLoopsLocked() const
+{
+    std::vector<EventLoop*> loops;
+    loops.reserve(m_workers.size());
+    for(const Worker& worker : m_workers)
+    {
+        if(!worker.closed) loops.push_back(worker.loop);
+    }
+    return loops;
+}
+
 EventLoop* EventLoopThreadPool::getNextLoop()
 {
     assert(m_started);
     assert(m_baseloop != nullptr);
     m_baseloop->assertInLoopThread();
 
-    EventLoop* loop = m_baseloop;
-    if(!m_loops.empty())
+    if(m_loops.empty())
     {
-        loop = m_loops[m_next];
-        m_next = (m_next + 1) % m_loops.size();
+        return m_baseloop;
     }
-    
+
+    switch(m_strategy)
+    {
+        case LoadBalance::kLeastChannels:
+            return pickByLoad([](const EventLoop* loop) { return static_cast<double>(loop->numChannels()); });
+        case LoadBalance::kShortestQueue:
+            return pickByLoad([](const EventLoop* loop) { return static_cast<double>(loop->pendingTasks()); });
+        case LoadBalance::kLowestUtilization:
+            return pickByLoad([](const EventLoop* loop) { return loop->utilization(); });
+        case LoadBalance::kPowerOfTwoChoices:
+            return pickPowerOfTwo();
+        case LoadBalance::kRoundRobin:
+            break;
+    }
+
+    EventLoop* loop = m_loops[m_next];
+    m_next = (m_next + 1) % m_loops.size();
     return loop;
 }
 
+EventLoop* EventLoopThreadPool::pickByLoad(double (*score)(const EventLoop*))
+{
+    // 从轮询位置开始扫描，负载相同时依次轮换，避免总是挑中第一个
+    const size_t n = m_loops.size();
+    size_t best = static_cast<size_t>(m_next);
+    double bestScore = score(m_loops[best]);
+    for(size_t i = 1; i < n && bestScore > 0.0; ++i)
+    {
+        size_t idx = (static_cast<size_t>(m_next) + i) % n;
+        double s = score(m_loops[idx]);
+        if(s < bestScore)
+        {
+            best = idx;
+            bestScore = s;
+        }
+    }
+    m_next = static_cast<int>((best + 1) % n);
+    return m_loops[best];
+}
+
+EventLoop* EventLoopThreadPool::pickPowerOfTwo()
+{
+    const size_t n = m_loops.size();
+    if(n == 1) return m_loops[0];
+
+    // xorshift64
+    m_randomState ^= m_randomState << 13;
+    m_randomState ^= m_randomState >> 7;
+    m_randomState ^= m_randomState << 17;
+    size_t a = static_cast<size_t>(m_randomState % n);
+    size_t b = static_cast<size_t>((m_randomState >> 32) % (n - 1));
+    if(b >= a) ++b; // 保证两个候选不同
+
+    EventLoop* first = m_loops[a];
+    EventLoop* second = m_loops[b];
+    double u1 = first->utilization();
+    double u2 = second->utilization();
+    if(u1 != u2) return u1 < u2 ? first : second;
+    return first->numChannels() <= second->numChannels() ? first : second;
+}
+
+EventLoop* EventLoopThreadPool::getLoopForHash(uint64_t hashCode)
+{
+    assert(m_started);
+    m_baseloop->assertInLoopThread();
+
+    if(m_loops.empty())
+    {
+        return m_baseloop;
+    }
+    return m_loops[hashCode % m_loops.size()];
+}
+
 std::vector<EventLoop*> EventLoopThreadPool::getAllLoops()
 {
     assert(m_started);
@@ -62,4 +373,89 @@ std::vector<EventLoop*> EventLoopThreadPool::getAllLoops()
         return m_loops;
 }
 
-}//reactor
\ No newline at end of file
+// 以下投递和读取都在持有 m_mutex 时进行：Loop 不会在使用期间被 checkRetiring() 销毁，
+// 投递也不会落在已关闭、即将退出的 Loop 上
+void EventLoopThreadPool::broadcast(const SharedFunctor& fn)
+{
+    assert(m_started);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EventLoop*> loops = openLoopsLocked();
+    if(loops.empty())
+    {
+        m_baseloop->queueInLoop(fn);
+        return;
+    }
+    for(EventLoop* loop : loops)
+    {
+        loop->queueInLoop(fn);
+    }
+}
+
+void EventLoopThreadPool::broadcastBatch(const std::vector<SharedFunctor>& tasks)
+{
+    assert(m_started);
+    std::vector<Functor> batch;
+    auto post = [&](EventLoop* loop) {
+        batch.clear();
+        batch.reserve(tasks.size());
+        for(const SharedFunctor& task : tasks) batch.emplace_back(task);
+        loop->queueInLoopBatch(std::move(batch));
+    };
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EventLoop*> loops = openLoopsLocked();
+    if(loops.empty())
+    {
+        post(m_baseloop);
+        return;
+    }
+    for(EventLoop* loop : loops)
+    {
+        post(loop);
+    }
+}
+
+std::shared_ptr<CountDownLatch> EventLoopThreadPool::broadcastWithBarrier(const SharedFunctor& fn)
+{
+    assert(m_started);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EventLoop*> loops = openLoopsLocked();
+    if(loops.empty()) loops.push_back(m_baseloop);
+    auto latch = std::make_shared<CountDownLatch>(static_cast<int>(loops.size()));
+    for(EventLoop* loop : loops)
+    {
+        loop->queueInLoop([fn, latch]() {
+            fn();
+            latch->countDown();
+        });
+    }
+    return latch;
+}
+
+PoolMetricsSnapshot EventLoopThreadPool::metricsSnapshot() const
+{
+    assert(m_started);
+    PoolMetricsSnapshot result;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<EventLoop*> loops = openLoopsLocked();
+        if(loops.empty())
+        {
+            result.loops.push_back(m_baseloop->metricsSnapshot());
+        }
+        else
+        {
+            result.loops.reserve(loops.size());
+            for(const EventLoop* loop : loops)
+            {
+                result.loops.push_back(loop->metricsSnapshot());
+            }
+        }
+    }
+    for(const LoopMetricsSnapshot& snap : result.loops)
+    {
+        result.total.merge(snap);
+    }
+    return result;
+}
+
+}//reactor
@@ -0,0 +1,101 @@
+#include "reactor/framepool.h"
+#include "reactor/eventloop.h"
+#include <new>
+
+namespace reactor
+{
+
+FramePool::FramePool(size_t maxIdlePerClass)
+    : m_maxIdlePerClass(maxIdlePerClass), m_hits(0), m_misses(0)
+{
+    for(size_t i = 0; i < kNumClasses; ++i)
+    {
+        m_free[i] = nullptr;
+        m_idle[i] = 0;
+    }
+}
+
+FramePool::~FramePool()
+{
+    for(size_t i = 0; i < kNumClasses; ++i)
+    {
+        while(m_free[i])
+        {
+            FreeBlock* next = m_free[i]->next;
+            ::operator delete(m_free[i]);
+            m_free[i] = next;
+        }
+    }
+}
+
+size_t FramePool::classOf(size_t size)
+{
+    if(size == 0 || size > kMaxPooledSize) return kNumClasses;
+    return (size - 1) / kGranularity;
+}
+
+size_t FramePool::roundUp(size_t size)
+{
+    size_t cls = classOf(size);
+    return cls == kNumClasses ? size : (cls + 1) * kGranularity;
+}
+
+void* FramePool::allocate(size_t size)
+{
+    size_t cls = classOf(size);
+    if(cls < kNumClasses && m_free[cls])
+    {
+        FreeBlock* block = m_free[cls];
+        m_free[cls] = block->next;
+        --m_idle[cls];
+        ++m_hits;
+        return block;
+    }
+    ++m_misses;
+    return ::operator new(roundUp(size));
+}
+
+void FramePool::deallocate(void* p, size_t size)
+{
+    size_t cls = classOf(size);
+    if(cls < kNumClasses && m_idle[cls] < m_maxIdlePerClass)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = m_free[cls];
+        m_free[cls] = block;
+        ++m_idle[cls];
+        return;
+    }
+    ::operator delete(p);
+}
+
+size_t FramePool::idle() const
+{
+    size_t n = 0;
+    for(size_t i = 0; i < kNumClasses; ++i)
+    {
+        n += m_idle[i];
+    }
+    return n;
+}
+
+void* FramePool::allocateFrame(size_t size)
+{
+    EventLoop* loop = EventLoop::getEventLoopOfCurrentThread();
+    return loop ? loop->framePool()->allocate(size) : ::operator new(roundUp(size));
+}
+
+void FramePool::deallocateFrame(void* p, size_t size)
+{
+    EventLoop* loop = EventLoop::getEventLoopOfCurrentThread();
+    if(loop)
+    {
+        loop->framePool()->deallocate(p, size);
+    }
+    else
+    {
+        ::operator delete(p);
+    }
+}
+
+}// namespace reactor
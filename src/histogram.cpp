@@ -0,0 +1,95 @@
+#include "reactor/histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace reactor
+{
+
+Histogram::Histogram()
+    : m_count(0),
+      m_sum(0),
+      m_min(std::numeric_limits<uint64_t>::max()),
+      m_max(0)
+{
+    for(auto& c : m_counts)
+    {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Histogram::bucketUpperBound(int bucket)
+{
+    if(bucket < kSubBuckets)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    int exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+    uint64_t sub = static_cast<uint64_t>(bucket % kSubBuckets);
+    uint64_t width = uint64_t(1) << (exponent - kSubBucketBits);
+    uint64_t lower = (uint64_t(1) << exponent) + sub * width;
+    return lower + (width - 1);
+}
+
+HistogramSnapshot Histogram::snapshot() const
+{
+    HistogramSnapshot snap;
+    snap.count = m_count.load(std::memory_order_relaxed);
+    if(snap.count == 0)
+    {
+        return snap;
+    }
+    snap.counts.resize(kNumBuckets);
+    for(int i = 0; i < kNumBuckets; ++i)
+    {
+        snap.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    snap.sum = m_sum.load(std::memory_order_relaxed);
+    snap.min = m_min.load(std::memory_order_relaxed);
+    snap.max = m_max.load(std::memory_order_relaxed);
+    return snap;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const
+{
+    if(counts.empty()) return 0;
+
+    // 用桶计数之和而不是 count：并发读取时两者可能略有出入
+    uint64_t total = 0;
+    for(uint64_t c : counts) total += c;
+    if(total == 0) return 0;
+
+    p = std::min(std::max(p, 0.0), 1.0);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(total)));
+    if(rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for(size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i];
+        if(seen >= rank)
+        {
+            return std::min(Histogram::bucketUpperBound(static_cast<int>(i)), max);
+        }
+    }
+    return max;
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other)
+{
+    if(other.counts.empty()) return;
+    if(counts.empty())
+    {
+        *this = other;
+        return;
+    }
+    for(size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+}// namespace reactor
@@ -0,0 +1,81 @@
+#include "reactor/inetaddress.h"
+#include "reactor/logging.h"
+#include <arpa/inet.h>
+#include <cstring>
+
+namespace reactor
+{
+
+static_assert(sizeof(InetAddress) == sizeof(struct sockaddr_in6), "InetAddress must be a plain sockaddr_in6");
+
+InetAddress::InetAddress(uint16_t port, bool loopbackOnly, bool ipv6)
+{
+    if(ipv6)
+    {
+        std::memset(&m_addr6, 0, sizeof m_addr6);
+        m_addr6.sin6_family = AF_INET6;
+        m_addr6.sin6_addr = loopbackOnly ? in6addr_loopback : in6addr_any;
+        m_addr6.sin6_port = htons(port);
+    }
+    else
+    {
+        std::memset(&m_addr6, 0, sizeof m_addr6);
+        m_addr.sin_family = AF_INET;
+        m_addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+        m_addr.sin_port = htons(port);
+    }
+}
+
+InetAddress::InetAddress(const std::string& ip, uint16_t port, bool ipv6)
+{
+    std::memset(&m_addr6, 0, sizeof m_addr6);
+    int ret;
+    if(ipv6 || ip.find(':') != std::string::npos)
+    {
+        m_addr6.sin6_family = AF_INET6;
+        m_addr6.sin6_port = htons(port);
+        ret = ::inet_pton(AF_INET6, ip.c_str(), &m_addr6.sin6_addr);
+    }
+    else
+    {
+        m_addr.sin_family = AF_INET;
+        m_addr.sin_port = htons(port);
+        ret = ::inet_pton(AF_INET, ip.c_str(), &m_addr.sin_addr);
+    }
+    if(ret <= 0)
+    {
+        LOG_ERROR << "InetAddress invalid ip: " << ip;
+    }
+}
+
+std::string InetAddress::toIp() const
+{
+    char buf[INET6_ADDRSTRLEN] = "";
+    if(family() == AF_INET6)
+    {
+        ::inet_ntop(AF_INET6, &m_addr6.sin6_addr, buf, sizeof buf);
+    }
+    else
+    {
+        ::inet_ntop(AF_INET, &m_addr.sin_addr, buf, sizeof buf);
+    }
+    return buf;
+}
+
+std::string InetAddress::toIpPort() const
+{
+    std::string ip = toIp();
+    std::string portStr = std::to_string(port());
+    if(family() == AF_INET6)
+    {
+        return "[" + ip + "]:" + portStr;
+    }
+    return ip + ":" + portStr;
+}
+
+uint16_t InetAddress::port() const
+{
+    return ntohs(m_addr.sin_port); // sin_port 和 sin6_port 偏移相同
+}
+
+}// namespace reactor
@@ -0,0 +1,484 @@
+#include "reactor/iouringpoller.h"
+#include "reactor/channel.h"
+#include "reactor/logging.h"
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+namespace reactor
+{
+
+namespace details
+{
+
+int ioUringSetup(unsigned entries, struct io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, size_t argSize)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+// user_data 布局：[类型:2][代数:30][下标:32]
+constexpr uint64_t kTagIgnore = 0; // POLL_REMOVE 等不关心结果的请求
+constexpr uint64_t kTagPoll = 1;
+constexpr uint64_t kTagOp = 2;
+constexpr uint32_t kGenerationMask = (1u << 30) - 1;
+
+uint64_t encode(uint64_t tag, uint32_t generation, uint32_t index)
+{
+    return (tag << 62) | (static_cast<uint64_t>(generation & kGenerationMask) << 32) | index;
+}
+
+uint64_t tagOf(uint64_t userData) { return userData >> 62; }
+uint32_t generationOf(uint64_t userData) { return static_cast<uint32_t>(userData >> 32) & kGenerationMask; }
+uint32_t indexOf(uint64_t userData) { return static_cast<uint32_t>(userData); }
+
+// io_uring 的 POLL_ADD 本身就是单次的，去掉 epoll 专有的模式位
+uint32_t pollMask(const Channel* channel)
+{
+    uint32_t events = channel->events() | (channel->pollEvents() & EPOLLRDHUP);
+    return events;
+}
+
+constexpr uint32_t kNoOp = UINT32_MAX;
+
+}// namespace details
+
+std::unique_ptr<IoUringPoller> IoUringPoller::create(unsigned entries)
+{
+    std::unique_ptr<IoUringPoller> poller(new IoUringPoller);
+    if(!poller->setup(entries))
+    {
+        return nullptr;
+    }
+    return poller;
+}
+
+IoUringPoller::IoUringPoller()
+    : m_ringfd(-1),
+      m_ringMem(MAP_FAILED),
+      m_ringMemSize(0),
+      m_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+      m_sqesSize(0),
+      m_sqHead(nullptr),
+      m_sqTail(nullptr),
+      m_sqMask(0),
+      m_sqEntries(0),
+      m_sqLocalTail(0),
+      m_toSubmit(0),
+      m_cqHead(nullptr),
+      m_cqTail(nullptr),
+      m_cqMask(0),
+      m_cqes(nullptr),
+      m_freeOp(details::kNoOp),
+      m_buffersRegistered(false)
+{
+}
+
+IoUringPoller::~IoUringPoller()
+{
+    if(m_sqes != MAP_FAILED) ::munmap(m_sqes, m_sqesSize);
+    if(m_ringMem != MAP_FAILED) ::munmap(m_ringMem, m_ringMemSize);
+    if(m_ringfd >= 0 && ::close(m_ringfd) < 0)
+    {
+        LOG_SYSERR << "Failed to close io_uring file descriptor";
+    }
+}
+
+bool IoUringPoller::setup(unsigned entries)
+{
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof params);
+    m_ringfd = details::ioUringSetup(entries, &params);
+    if(m_ringfd < 0)
+    {
+        LOG_WARN << "io_uring_setup failed: " << strerror_tl(errno);
+        return false;
+    }
+
+    const uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if((params.features & required) != required)
+    {
+        LOG_WARN << "io_uring lacks required features, features=" << params.features;
+        return false;
+    }
+
+    // SQ 和 CQ 环共用一次 mmap
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    m_ringMemSize = sqSize > cqSize ? sqSize : cqSize;
+    m_ringMem = ::mmap(nullptr, m_ringMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       m_ringfd, IORING_OFF_SQ_RING);
+    if(m_ringMem == MAP_FAILED)
+    {
+        LOG_SYSERR << "io_uring ring mmap failed";
+        return false;
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        m_ringfd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED)
+    {
+        LOG_SYSERR << "io_uring sqes mmap failed";
+        return false;
+    }
+    m_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+    char* ring = static_cast<char*>(m_ringMem);
+    m_sqHead = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+    m_sqEntries = params.sq_entries;
+    m_sqLocalTail = *m_sqTail;
+
+    // SQE 下标与环位置一一对应，只需填写一次
+    unsigned* array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+    for(unsigned i = 0; i < m_sqEntries; ++i) array[i] = i;
+
+    m_cqHead = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<struct io_uring_cqe*>(ring + params.cq_off.cqes);
+
+    LOG_INFO << "io_uring poller created, sq_entries=" << params.sq_entries
+             << " cq_entries=" << params.cq_entries;
+    return true;
+}
+
+struct io_uring_sqe* IoUringPoller::getSqe()
+{
+    unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+    if(m_sqLocalTail - head >= m_sqEntries)
+    {
+        // 提交队列满了，先提交已填写的请求
+        enter(m_toSubmit, 0, 0);
+        head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+        if(m_sqLocalTail - head >= m_sqEntries)
+        {
+            LOG_FATAL << "IoUringPoller::getSqe() submission queue full";
+        }
+    }
+    struct io_uring_sqe* sqe = &m_sqes[m_sqLocalTail & m_sqMask];
+    std::memset(sqe, 0, sizeof *sqe);
+    ++m_sqLocalTail;
+    ++m_toSubmit;
+    return sqe;
+}
+
+int IoUringPoller::enter(unsigned toSubmit, unsigned minComplete, int timeoutMs)
+{
+    // 发布本地填写的 SQE
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof arg);
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if(minComplete > 0)
+    {
+        flags |= IORING_ENTER_GETEVENTS;
+        if(timeoutMs >= 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000 * 1000;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+    }
+
+    ++m_syscalls;
+    int ret = details::ioUringEnter(m_ringfd, toSubmit, minComplete, flags, &arg, sizeof arg);
+    if(ret >= 0)
+    {
+        m_toSubmit -= static_cast<unsigned>(ret) < m_toSubmit ? static_cast<unsigned>(ret) : m_toSubmit;
+    }
+    else if(errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+    {
+        LOG_SYSERR << "io_uring_enter error";
+    }
+    return ret;
+}
+
+void IoUringPoller::poll(int timeoutMs, ChannelList* activeChannels)
+{
+    // 把累积的关心事件变化写入提交队列
+    for(int fd : m_dirty)
+    {
+        syncEntry(fd);
+    }
+    m_dirty.clear();
+
+    // 提交和等待合并为一次系统调用；超时为0时只提交
+    unsigned minComplete = timeoutMs == 0 ? 0 : 1;
+    if(m_toSubmit > 0 || minComplete > 0)
+    {
+        enter(m_toSubmit, minComplete, timeoutMs);
+    }
+
+    unsigned head = *m_cqHead;
+    unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    int numEvents = 0;
+    while(head != tail)
+    {
+        const struct io_uring_cqe* cqe = &m_cqes[head & m_cqMask];
+        uint64_t userData = cqe->user_data;
+        int res = cqe->res;
+        // 先归还 CQE 再回调，回调中可以继续提交请求
+        __atomic_store_n(m_cqHead, ++head, __ATOMIC_RELEASE);
+        handleCompletion(userData, res, activeChannels);
+        ++numEvents;
+        tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    }
+
+    if(numEvents > 0)
+    {
+        LOG_TRACE << numEvents << " completions happened";
+    }
+}
+
+void IoUringPoller::handleCompletion(uint64_t userData, int res, ChannelList* activeChannels)
+{
+    uint64_t tag = details::tagOf(userData);
+    uint32_t index = details::indexOf(userData);
+    uint32_t generation = details::generationOf(userData);
+
+    if(tag == details::kTagPoll)
+    {
+        if(index >= m_entries.size()) return;
+        PollEntry& entry = m_entries[index];
+        if((entry.generation & details::kGenerationMask) != generation || entry.channel == nullptr)
+        {
+            return; // 已取消或已移除的请求
+        }
+
+        entry.armedEvents = 0;
+        if(res < 0)
+        {
+            if(res != -ECANCELED)
+            {
+                errno = -res;
+                LOG_SYSERR << "IoUringPoller POLL_ADD failed, fd=" << static_cast<int>(index);
+            }
+            markDirty(static_cast<int>(index));
+            return;
+        }
+
+        Channel* channel = entry.channel;
+        channel->setRevents(static_cast<uint32_t>(res));
+        activeChannels->push_back(channel);
+        if(channel->isOneShot())
+        {
+            entry.fired = true;
+            channel->setRegisteredEvents(0);
+        }
+        else
+        {
+            markDirty(static_cast<int>(index)); // 下一次 poll() 重新提交，保持水平触发
+        }
+    }
+    else if(tag == details::kTagOp)
+    {
+        if(index >= m_ops.size() || (m_ops[index].generation & details::kGenerationMask) != generation)
+        {
+            return;
+        }
+        // 先取出回调并归还槽位，回调中提交新请求可能使 m_ops 扩容
+        IoCompletionCallback callback = std::move(m_ops[index].callback);
+        m_ops[index].callback = nullptr;
+        ++m_ops[index].generation;
+        m_ops[index].nextFree = m_freeOp;
+        m_freeOp = index;
+        if(callback) callback(res);
+    }
+}
+
+void IoUringPoller::markDirty(int fd)
+{
+    PollEntry& entry = m_entries[fd];
+    if(!entry.dirty)
+    {
+        entry.dirty = true;
+        m_dirty.push_back(fd);
+    }
+}
+
+void IoUringPoller::syncEntry(int fd)
+{
+    PollEntry& entry = m_entries[fd];
+    entry.dirty = false;
+
+    uint32_t wanted = 0;
+    if(entry.channel != nullptr && !entry.channel->isNoneEvent() && !entry.fired)
+    {
+        wanted = details::pollMask(entry.channel);
+    }
+    if(entry.armedEvents == wanted) return;
+
+    // 关心的事件变了：取消旧请求
+    cancelPoll(fd);
+
+    if(wanted != 0)
+    {
+        struct io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = fd;
+        sqe->poll32_events = wanted; // 小端序，与 IORING_FEAT_POLL_32BITS 一致
+        sqe->user_data = details::encode(details::kTagPoll, entry.generation, static_cast<uint32_t>(fd));
+        entry.armedEvents = wanted;
+    }
+}
+
+void IoUringPoller::cancelPoll(int fd)
+{
+    PollEntry& entry = m_entries[fd];
+    if(entry.armedEvents == 0) return;
+
+    // 旧请求迟到的完成事件（-ECANCELED 或就绪）按代数丢弃
+    struct io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = details::encode(details::kTagPoll, entry.generation, static_cast<uint32_t>(fd));
+    sqe->user_data = details::encode(details::kTagIgnore, 0, 0);
+    ++entry.generation;
+    entry.armedEvents = 0;
+}
+
+void IoUringPoller::updateChannel(Channel* channel)
+{
+    const int fd = channel->fd();
+    const int index = channel->index();
+    LOG_TRACE << "fd=" << fd << " events=" << channel->events();
+
+    if(static_cast<size_t>(fd) >= m_entries.size())
+    {
+        m_entries.resize(static_cast<size_t>(fd) + 1);
+    }
+    PollEntry& entry = m_entries[fd];
+
+    if(index == kNew)
+    {
+        assert(entry.channel == nullptr);
+        entry.channel = channel;
+    }
+    else
+    {
+        assert(entry.channel == channel);
+    }
+
+    channel->setIndex(channel->isNoneEvent() ? kDeleted : kAdded);
+    channel->setRegisteredEvents(channel->pollEvents());
+    entry.fired = false; // 任何更新（包括 rearm）都重新启用单次触发
+    markDirty(fd);
+}
+
+void IoUringPoller::removeChannel(Channel* channel)
+{
+    const int fd = channel->fd();
+    LOG_TRACE << "fd = " << fd;
+
+    assert(static_cast<size_t>(fd) < m_entries.size());
+    assert(m_entries[fd].channel == channel);
+    assert(channel->isNoneEvent());
+    assert(channel->index() == kAdded || channel->index() == kDeleted);
+
+    // 立即取消还在等待的请求：POLL_ADD 持有的是旧文件，
+    // fd 关闭后被复用时必须为新文件重新提交
+    cancelPoll(fd);
+    m_entries[fd].channel = nullptr;
+    m_entries[fd].fired = false;
+    channel->setIndex(kNew);
+    channel->setRegisteredEvents(0);
+}
+
+bool IoUringPoller::registerBuffers(const struct iovec* iovecs, unsigned count)
+{
+    if(m_buffersRegistered)
+    {
+        LOG_ERROR << "IoUringPoller::registerBuffers() buffers already registered";
+        return false;
+    }
+    ++m_syscalls;
+    if(details::ioUringRegister(m_ringfd, IORING_REGISTER_BUFFERS, iovecs, count) < 0)
+    {
+        LOG_SYSERR << "IoUringPoller::registerBuffers() failed";
+        return false;
+    }
+    m_buffersRegistered = true;
+    return true;
+}
+
+void IoUringPoller::unregisterBuffers()
+{
+    if(!m_buffersRegistered) return;
+    ++m_syscalls;
+    if(details::ioUringRegister(m_ringfd, IORING_UNREGISTER_BUFFERS, nullptr, 0) < 0)
+    {
+        LOG_SYSERR << "IoUringPoller::unregisterBuffers() failed";
+    }
+    m_buffersRegistered = false;
+}
+
+uint32_t IoUringPoller::allocOp()
+{
+    if(m_freeOp == details::kNoOp)
+    {
+        m_ops.emplace_back();
+        return static_cast<uint32_t>(m_ops.size() - 1);
+    }
+    uint32_t index = m_freeOp;
+    m_freeOp = m_ops[index].nextFree;
+    return index;
+}
+
+void IoUringPoller::submitOp(uint8_t opcode, int fd, const void* buf, size_t len, int bufIndex,
+                             IoCompletionCallback cb)
+{
+    uint32_t index = allocOp();
+    IoOp& op = m_ops[index];
+    op.callback = std::move(cb);
+
+    struct io_uring_sqe* sqe = getSqe();
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = static_cast<uint64_t>(-1); // 使用文件当前位置，对 socket/pipe 无意义
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(len);
+    if(bufIndex >= 0) sqe->buf_index = static_cast<uint16_t>(bufIndex);
+    sqe->user_data = details::encode(details::kTagOp, op.generation, index);
+}
+
+void IoUringPoller::submitRead(int fd, void* buf, size_t len, IoCompletionCallback cb)
+{
+    submitOp(IORING_OP_READ, fd, buf, len, -1, std::move(cb));
+}
+
+void IoUringPoller::submitWrite(int fd, const void* buf, size_t len, IoCompletionCallback cb)
+{
+    submitOp(IORING_OP_WRITE, fd, buf, len, -1, std::move(cb));
+}
+
+void IoUringPoller::submitReadFixed(int fd, void* buf, size_t len, int bufIndex, IoCompletionCallback cb)
+{
+    assert(m_buffersRegistered && bufIndex >= 0);
+    submitOp(IORING_OP_READ_FIXED, fd, buf, len, bufIndex, std::move(cb));
+}
+
+void IoUringPoller::submitWriteFixed(int fd, const void* buf, size_t len, int bufIndex, IoCompletionCallback cb)
+{
+    assert(m_buffersRegistered && bufIndex >= 0);
+    submitOp(IORING_OP_WRITE_FIXED, fd, buf, len, bufIndex, std::move(cb));
+}
+
+}// namespace reactor
@@ -0,0 +1,479 @@
+#include "reactor/logging.h"
+#include "reactor/currentthread.h"
+#include "reactor/timestamp.h"
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reactor
+{
+namespace details
+{
+
+// 每个线程独占的 SPSC 环形缓冲区
+// 生产者：拥有该缓冲区的线程（写日志）
+// 消费者：持有 m_drainMutex 的线程（后台线程或 Logger::flush()）
+//
+// 缓冲区里只存放完整的日志行，消费者可以直接把 [tail, head) 交给 writev
+struct ThreadBuffer
+{
+    static constexpr size_t kCapacity = 64 * 1024; // 必须是2的幂
+
+    bool push(const char* line, size_t len)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        if (len > kCapacity - (h - t))
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        size_t offset = static_cast<size_t>(h & (kCapacity - 1));
+        size_t first = std::min(len, kCapacity - offset);
+        std::memcpy(data + offset, line, first);
+        std::memcpy(data, line + first, len - first);
+        head.store(h + len, std::memory_order_release);
+        return true;
+    }
+
+    // 已使用空间是否超过一半（用于提前唤醒后台线程）
+    bool overHalf() const
+    {
+        return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed) > kCapacity / 2;
+    }
+
+    alignas(64) std::atomic<uint64_t> head{0}; // 生产者写入位置（单调递增）
+    alignas(64) std::atomic<uint64_t> tail{0}; // 消费者读取位置（单调递增）
+    std::atomic<uint64_t> dropped{0};          // 因缓冲区满而丢弃的行数
+    std::atomic<bool> retired{false};          // 所属线程已退出
+    char data[kCapacity];
+};
+
+// 日志后端：管理所有线程的缓冲区，并由后台线程负责写出
+// 单例故意不析构（进程退出时其他线程可能仍在写日志），退出前通过 atexit 刷一次
+class LogBackend : private NonCopyable
+{
+public:
+    static LogBackend& instance()
+    {
+        static LogBackend* backend = new LogBackend();
+        return *backend;
+    }
+
+    void registerBuffer(const std::shared_ptr<ThreadBuffer>& buffer)
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        m_buffers.push_back(buffer);
+    }
+
+    void notify() { m_cond.notify_one(); }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        while (drainAll() > 0)
+        {
+        }
+    }
+
+    void setOutputFd(int fd) { m_fd.store(fd, std::memory_order_relaxed); }
+
+private:
+    LogBackend()
+        : m_fd(STDOUT_FILENO)
+    {
+        std::thread(&LogBackend::threadFunc, this).detach();
+        std::atexit([]() { LogBackend::instance().flush(); });
+    }
+
+    void threadFunc()
+    {
+        while (true)
+        {
+            size_t n = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_drainMutex);
+                n = drainAll();
+            }
+            if (n == 0)
+            {
+                std::unique_lock<std::mutex> lock(m_condMutex);
+                m_cond.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs));
+            }
+        }
+    }
+
+    // 调用者必须持有 m_drainMutex
+    // 返回本次写出的字节数
+    size_t drainAll()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_registryMutex);
+            m_snapshot = m_buffers;
+            // 线程已退出且数据已写完的缓冲区可以回收
+            m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                                           [](const std::shared_ptr<ThreadBuffer>& buf) {
+                                               return buf->retired.load(std::memory_order_acquire) &&
+                                                      buf->tail.load(std::memory_order_relaxed) ==
+                                                          buf->head.load(std::memory_order_acquire);
+                                           }),
+                            m_buffers.end());
+        }
+
+        uint64_t dropped = 0;
+        m_iov.clear();
+        m_heads.clear();
+        for (const auto& buf : m_snapshot)
+        {
+            dropped += buf->dropped.exchange(0, std::memory_order_relaxed);
+
+            uint64_t t = buf->tail.load(std::memory_order_relaxed);
+            uint64_t h = buf->head.load(std::memory_order_acquire);
+            m_heads.push_back(h);
+            if (h == t)
+                continue;
+
+            size_t offset = static_cast<size_t>(t & (ThreadBuffer::kCapacity - 1));
+            size_t len = static_cast<size_t>(h - t);
+            size_t first = std::min(len, ThreadBuffer::kCapacity - offset);
+            m_iov.push_back({buf->data + offset, first});
+            if (len > first)
+                m_iov.push_back({buf->data, len - first});
+        }
+
+        size_t total = writeAll();
+        for (size_t i = 0; i < m_snapshot.size(); ++i)
+        {
+            m_snapshot[i]->tail.store(m_heads[i], std::memory_order_release);
+        }
+        m_snapshot.clear();
+
+        if (dropped > 0)
+        {
+            char msg[64];
+            int n = std::snprintf(msg, sizeof msg, "%llu log lines dropped\n",
+                                  static_cast<unsigned long long>(dropped));
+            ssize_t ignored = ::write(m_fd.load(std::memory_order_relaxed), msg, static_cast<size_t>(n));
+            (void)ignored;
+        }
+        return total;
+    }
+
+    // 把 m_iov 全部写出，处理部分写和 EINTR
+    size_t writeAll()
+    {
+        size_t total = 0;
+        int fd = m_fd.load(std::memory_order_relaxed);
+        size_t idx = 0;
+        while (idx < m_iov.size())
+        {
+            int cnt = static_cast<int>(std::min<size_t>(m_iov.size() - idx, IOV_MAX));
+            ssize_t n = ::writev(fd, &m_iov[idx], cnt);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break; // 输出失败时丢弃本批数据
+            }
+            total += static_cast<size_t>(n);
+            size_t written = static_cast<size_t>(n);
+            while (idx < m_iov.size() && written >= m_iov[idx].iov_len)
+            {
+                written -= m_iov[idx].iov_len;
+                ++idx;
+            }
+            if (written > 0)
+            {
+                m_iov[idx].iov_base = static_cast<char*>(m_iov[idx].iov_base) + written;
+                m_iov[idx].iov_len -= written;
+            }
+        }
+        return total;
+    }
+
+    static constexpr int kFlushIntervalMs = 50;
+
+    std::mutex m_registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    std::mutex m_drainMutex; // 保证同一时刻只有一个消费者
+    std::vector<std::shared_ptr<ThreadBuffer>> m_snapshot;
+    std::vector<struct iovec> m_iov;
+    std::vector<uint64_t> m_heads;
+
+    std::mutex m_condMutex;
+    std::condition_variable m_cond;
+    std::atomic<int> m_fd;
+};
+
+struct ThreadBufferHolder
+{
+    ~ThreadBufferHolder()
+    {
+        if (buffer)
+            buffer->retired.store(true, std::memory_order_release);
+    }
+
+    ThreadBuffer* get()
+    {
+        if (!buffer)
+        {
+            buffer = std::make_shared<ThreadBuffer>();
+            LogBackend::instance().registerBuffer(buffer);
+        }
+        return buffer.get();
+    }
+
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+thread_local ThreadBufferHolder t_buffer;
+
+// 时间前缀按秒缓存，同一秒内只需要拼接微秒部分
+thread_local int64_t t_lastSecond = -1;
+thread_local char t_time[32];
+thread_local size_t t_timeLen = 0;
+
+// 线程ID前缀
+thread_local char t_tidString[16];
+thread_local size_t t_tidStringLen = 0;
+
+const char* const kLevelNames[Logger::NUM_LOG_LEVELS] = {
+    "TRACE ",
+    "DEBUG ",
+    "INFO  ",
+    "WARN  ",
+    "ERROR ",
+    "FATAL ",
+};
+
+const char* basename(const char* file)
+{
+    const char* slash = std::strrchr(file, '/');
+    return slash ? slash + 1 : file;
+}
+
+}// namespace details
+
+std::atomic<int> Logger::s_logLevel(Logger::INFO);
+
+const char* strerror_tl(int savedErrno)
+{
+    thread_local char t_errnoBuf[512];
+    return strerror_r(savedErrno, t_errnoBuf, sizeof t_errnoBuf);
+}
+
+template<typename T>
+void LogStream::formatInteger(T v)
+{
+    // 整数最长20位加符号，空间不足时整体丢弃
+    if (avail() >= 32)
+    {
+        auto result = std::to_chars(m_buf + m_len, m_buf + m_len + 32, v);
+        m_len = static_cast<size_t>(result.ptr - m_buf);
+    }
+}
+
+void LogStream::append(const char* data, size_t len)
+{
+    size_t n = std::min(len, avail());
+    std::memcpy(m_buf + m_len, data, n);
+    m_len += n;
+}
+
+LogStream& LogStream::operator<<(bool v)
+{
+    append(v ? "1" : "0", 1);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(char v)
+{
+    append(&v, 1);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(short v)
+{
+    formatInteger(static_cast<int>(v));
+    return *this;
+}
+
+LogStream& LogStream::operator<<(unsigned short v)
+{
+    formatInteger(static_cast<unsigned int>(v));
+    return *this;
+}
+
+LogStream& LogStream::operator<<(int v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(unsigned int v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(long v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(unsigned long v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(long long v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(unsigned long long v)
+{
+    formatInteger(v);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(double v)
+{
+    if (avail() >= 32)
+    {
+        int n = std::snprintf(m_buf + m_len, 32, "%.12g", v);
+        m_len += static_cast<size_t>(n);
+    }
+    return *this;
+}
+
+LogStream& LogStream::operator<<(const void* p)
+{
+    if (avail() >= 32)
+    {
+        m_buf[m_len++] = '0';
+        m_buf[m_len++] = 'x';
+        auto result = std::to_chars(m_buf + m_len, m_buf + m_len + 30, reinterpret_cast<uintptr_t>(p), 16);
+        m_len = static_cast<size_t>(result.ptr - m_buf);
+    }
+    return *this;
+}
+
+LogStream& LogStream::operator<<(const char* str)
+{
+    if (str)
+        append(str, std::strlen(str));
+    else
+        append("(null)", 6);
+    return *this;
+}
+
+LogStream& LogStream::operator<<(const std::string& str)
+{
+    append(str.data(), str.size());
+    return *this;
+}
+
+Logger::Logger(const char* file, int line, LogLevel level, const char* func)
+    : m_level(level), m_file(file), m_line(line), m_savedErrno(0)
+{
+    formatPrefix(level);
+    if (level <= DEBUG)
+    {
+        m_stream << func << ' ';
+    }
+}
+
+Logger::Logger(const char* file, int line, bool toAbort)
+    : m_level(toAbort ? FATAL : ERROR), m_file(file), m_line(line), m_savedErrno(errno)
+{
+    formatPrefix(m_level);
+}
+
+Logger::~Logger()
+{
+    if (m_savedErrno != 0)
+    {
+        m_stream << ": " << strerror_tl(m_savedErrno) << " (errno=" << m_savedErrno << ')';
+    }
+    m_stream << " - " << details::basename(m_file) << ':' << m_line;
+    m_stream.finishLine();
+
+    details::ThreadBuffer* buffer = details::t_buffer.get();
+    bool pushed = buffer->push(m_stream.data(), m_stream.length());
+    if (!pushed || m_level >= WARN || buffer->overHalf())
+    {
+        details::LogBackend::instance().notify();
+    }
+
+    if (m_level == FATAL)
+    {
+        flush();
+        abort();
+    }
+}
+
+void Logger::formatPrefix(LogLevel level)
+{
+    int64_t microSeconds = Timestamp::now().microSecondsSinceEpoch();
+    int64_t seconds = microSeconds / Timestamp::kMicroSecondsPerSecond;
+    int micros = static_cast<int>(microSeconds % Timestamp::kMicroSecondsPerSecond);
+
+    if (seconds != details::t_lastSecond)
+    {
+        details::t_lastSecond = seconds;
+        time_t t = static_cast<time_t>(seconds);
+        struct tm tmTime;
+        gmtime_r(&t, &tmTime);
+        details::t_timeLen = std::strftime(details::t_time, sizeof details::t_time, "%Y-%m-%d %H:%M:%S", &tmTime);
+    }
+    m_stream.append(details::t_time, details::t_timeLen);
+
+    char frac[8];
+    frac[0] = '.';
+    for (int i = 6; i >= 1; --i)
+    {
+        frac[i] = static_cast<char>('0' + micros % 10);
+        micros /= 10;
+    }
+    frac[7] = ' ';
+    m_stream.append(frac, sizeof frac);
+
+    if (details::t_tidStringLen == 0)
+    {
+        details::t_tidStringLen = static_cast<size_t>(
+            std::snprintf(details::t_tidString, sizeof details::t_tidString, "%5d ", tid()));
+    }
+    m_stream.append(details::t_tidString, details::t_tidStringLen);
+    m_stream.append(details::kLevelNames[level], 6);
+}
+
+void Logger::setOutputFd(int fd)
+{
+    details::LogBackend::instance().setOutputFd(fd);
+}
+
+void Logger::flush()
+{
+    details::LogBackend::instance().flush();
+}
+
+}// namespace reactor
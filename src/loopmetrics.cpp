@@ -0,0 +1,66 @@
+#include "reactor/loopmetrics.h"
+#include <cstdio>
+
+namespace reactor
+{
+
+LoopMetricsSnapshot LoopMetrics::snapshot(pid_t threadId) const
+{
+    LoopMetricsSnapshot snap;
+    snap.threadId = threadId;
+    snap.iterationNs = iterationNs.snapshot();
+    snap.pollWaitNs = pollWaitNs.snapshot();
+    snap.callbackNs = callbackNs.snapshot();
+    snap.eventsPerPoll = eventsPerPoll.snapshot();
+    snap.pendingDepth = pendingDepth.snapshot();
+    snap.taskLatencyNs = taskLatencyNs.snapshot();
+    snap.timerLatenessNs = timerLatenessNs.snapshot();
+    return snap;
+}
+
+void LoopMetricsSnapshot::merge(const LoopMetricsSnapshot& other)
+{
+    threadId = 0;
+    iterationNs.merge(other.iterationNs);
+    pollWaitNs.merge(other.pollWaitNs);
+    callbackNs.merge(other.callbackNs);
+    eventsPerPoll.merge(other.eventsPerPoll);
+    pendingDepth.merge(other.pendingDepth);
+    taskLatencyNs.merge(other.taskLatencyNs);
+    timerLatenessNs.merge(other.timerLatenessNs);
+}
+
+std::string LoopMetricsSnapshot::toString() const
+{
+    struct Row
+    {
+        const char* name;
+        const HistogramSnapshot* hist;
+    };
+    const Row rows[] = {
+        {"iteration_ns", &iterationNs},
+        {"poll_wait_ns", &pollWaitNs},
+        {"callback_ns", &callbackNs},
+        {"events_per_poll", &eventsPerPoll},
+        {"pending_depth", &pendingDepth},
+        {"task_latency_ns", &taskLatencyNs},
+        {"timer_lateness_ns", &timerLatenessNs},
+    };
+
+    std::string result;
+    char line[256];
+    for(const Row& row : rows)
+    {
+        const HistogramSnapshot& h = *row.hist;
+        std::snprintf(line, sizeof line, "tid=%d %s count=%llu mean=%.1f p50=%llu p99=%llu max=%llu\n",
+                      static_cast<int>(threadId), row.name,
+                      static_cast<unsigned long long>(h.count), h.mean(),
+                      static_cast<unsigned long long>(h.percentile(0.50)),
+                      static_cast<unsigned long long>(h.percentile(0.99)),
+                      static_cast<unsigned long long>(h.max));
+        result += line;
+    }
+    return result;
+}
+
+}// namespace reactor
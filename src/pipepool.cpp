@@ -0,0 +1,58 @@
+#include "reactor/pipepool.h"
+#include "reactor/logging.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace reactor
+{
+
+PipePool::~PipePool()
+{
+    for(Pipe pipe : m_idle)
+    {
+        closePipe(pipe);
+    }
+}
+
+Pipe PipePool::acquire()
+{
+    if(!m_idle.empty())
+    {
+        Pipe pipe = m_idle.back();
+        m_idle.pop_back();
+        return pipe;
+    }
+
+    int fds[2];
+    if(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0)
+    {
+        LOG_SYSERR << "PipePool::acquire() pipe2";
+        return Pipe();
+    }
+    ++m_created;
+    Pipe pipe;
+    pipe.readFd = fds[0];
+    pipe.writeFd = fds[1];
+    return pipe;
+}
+
+void PipePool::release(Pipe pipe, bool empty)
+{
+    if(!pipe.valid()) return;
+    if(empty && m_idle.size() < m_maxIdle)
+    {
+        m_idle.push_back(pipe);
+    }
+    else
+    {
+        closePipe(pipe);
+    }
+}
+
+void PipePool::closePipe(Pipe pipe)
+{
+    ::close(pipe.readFd);
+    ::close(pipe.writeFd);
+}
+
+}// namespace reactor
@@ -0,0 +1,131 @@
+#include "reactor/socket.h"
+#include "reactor/inetaddress.h"
+#include "reactor/logging.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace reactor
+{
+
+Socket::~Socket()
+{
+    if(::close(m_sockfd) < 0)
+    {
+        LOG_SYSERR << "Socket::~Socket() close failed, fd=" << m_sockfd;
+    }
+}
+
+void Socket::bindAddress(const InetAddress& localAddr)
+{
+    if(::bind(m_sockfd, localAddr.getSockAddr(), localAddr.getSockAddrLen()) < 0)
+    {
+        LOG_SYSFATAL << "Socket::bindAddress() failed, addr=" << localAddr.toIpPort();
+    }
+}
+
+void Socket::listen()
+{
+    if(::listen(m_sockfd, SOMAXCONN) < 0)
+    {
+        LOG_SYSFATAL << "Socket::listen() failed, fd=" << m_sockfd;
+    }
+}
+
+int Socket::accept(InetAddress* peerAddr)
+{
+    struct sockaddr_in6 addr;
+    std::memset(&addr, 0, sizeof addr);
+    socklen_t addrlen = sizeof addr;
+    int connfd = ::accept4(m_sockfd, reinterpret_cast<struct sockaddr*>(&addr), &addrlen,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(connfd >= 0)
+    {
+        peerAddr->setSockAddrInet6(addr);
+    }
+    return connfd;
+}
+
+void Socket::shutdownWrite()
+{
+    if(::shutdown(m_sockfd, SHUT_WR) < 0)
+    {
+        LOG_SYSERR << "Socket::shutdownWrite() failed, fd=" << m_sockfd;
+    }
+}
+
+void Socket::setTcpNoDelay(bool on)
+{
+    int optval = on ? 1 : 0;
+    ::setsockopt(m_sockfd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof optval);
+}
+
+void Socket::setReuseAddr(bool on)
+{
+    int optval = on ? 1 : 0;
+    ::setsockopt(m_sockfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof optval);
+}
+
+void Socket::setReusePort(bool on)
+{
+    int optval = on ? 1 : 0;
+    if(::setsockopt(m_sockfd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof optval) < 0 && on)
+    {
+        LOG_SYSERR << "SO_REUSEPORT failed, fd=" << m_sockfd;
+    }
+}
+
+void Socket::setKeepAlive(bool on)
+{
+    int optval = on ? 1 : 0;
+    ::setsockopt(m_sockfd, SOL_SOCKET, SO_KEEPALIVE, &optval, sizeof optval);
+}
+
+int Socket::createNonblockingOrDie(sa_family_t family)
+{
+    int sockfd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if(sockfd < 0)
+    {
+        LOG_SYSFATAL << "Socket::createNonblockingOrDie() failed";
+    }
+    return sockfd;
+}
+
+int Socket::getSocketError(int sockfd)
+{
+    int optval;
+    socklen_t optlen = sizeof optval;
+    if(::getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0)
+    {
+        return errno;
+    }
+    return optval;
+}
+
+InetAddress Socket::getLocalAddr(int sockfd)
+{
+    struct sockaddr_in6 addr;
+    std::memset(&addr, 0, sizeof addr);
+    socklen_t addrlen = sizeof addr;
+    if(::getsockname(sockfd, reinterpret_cast<struct sockaddr*>(&addr), &addrlen) < 0)
+    {
+        LOG_SYSERR << "Socket::getLocalAddr() failed, fd=" << sockfd;
+    }
+    return InetAddress(addr);
+}
+
+InetAddress Socket::getPeerAddr(int sockfd)
+{
+    struct sockaddr_in6 addr;
+    std::memset(&addr, 0, sizeof addr);
+    socklen_t addrlen = sizeof addr;
+    if(::getpeername(sockfd, reinterpret_cast<struct sockaddr*>(&addr), &addrlen) < 0)
+    {
+        LOG_SYSERR << "Socket::getPeerAddr() failed, fd=" << sockfd;
+    }
+    return InetAddress(addr);
+}
+
+}// namespace reactor
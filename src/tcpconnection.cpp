@@ -0,0 +1,639 @@
+#include "reactor/tcpconnection.h"
+#include "reactor/channel.h"
+#include "reactor/eventloop.h"
+#include "reactor/logging.h"
+#include "reactor/socket.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cassert>
+#include <cerrno>
+
+namespace reactor
+{
+
+// 默认高水位 64MB
+constexpr size_t kDefaultHighWaterMark = 64 * 1024 * 1024;
+
+// 每次从源 socket splice 到中转管道的最大字节数（默认管道容量）
+constexpr size_t kSpliceChunk = 64 * 1024;
+
+namespace details
+{
+
+// 用 send + MSG_NOSIGNAL 代替 write：对端已关闭时返回 EPIPE 而不是触发 SIGPIPE
+ssize_t sendNoSignal(int fd, const void* data, size_t len)
+{
+    return ::send(fd, data, len, MSG_NOSIGNAL);
+}
+
+// sendfile/splice 没有 MSG_NOSIGNAL：第一次使用时在当前 Loop 线程屏蔽 SIGPIPE，
+// 对端已关闭时信号挂起在线程上而不是终止进程，返回 EPIPE 后由 consumeSigPipe() 取走
+void blockSigPipe()
+{
+    thread_local bool blocked = false;
+    if(blocked) return;
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+    blocked = true;
+}
+
+void consumeSigPipe()
+{
+    int savedErrno = errno;
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    struct timespec zero = {0, 0};
+    while(::sigtimedwait(&set, nullptr, &zero) == SIGPIPE)
+    {
+    }
+    errno = savedErrno;
+}
+
+ssize_t sendFileNoSignal(int sockfd, int fileFd, off_t* offset, size_t len)
+{
+    blockSigPipe();
+    ssize_t n = ::sendfile(sockfd, fileFd, offset, len);
+    if(n < 0 && errno == EPIPE) consumeSigPipe();
+    return n;
+}
+
+ssize_t spliceNoSignal(int in, int out, size_t len)
+{
+    blockSigPipe();
+    ssize_t n = ::splice(in, nullptr, out, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if(n < 0 && errno == EPIPE) consumeSigPipe();
+    return n;
+}
+
+}// namespace details
+
+TcpConnection::TcpConnection(EventLoop* loop, std::string name, int sockfd,
+                             const InetAddress& localAddr, const InetAddress& peerAddr)
+    : m_loop(loop),
+      m_name(std::move(name)),
+      m_state(kConnecting),
+      m_socket(std::make_unique<Socket>(sockfd)),
+      m_channel(std::make_unique<Channel>(loop, sockfd)),
+      m_localAddr(localAddr),
+      m_peerAddr(peerAddr),
+      m_highWaterMark(kDefaultHighWaterMark),
+      m_deferredSend(true),
+      m_flushScheduled(false),
+      m_writeSyscalls(0),
+      m_pipeBytes(0)
+{
+    m_channel->setReadCallback([this]() { handleRead(); });
+    m_channel->setWriteCallback([this]() { handleWrite(); });
+    m_channel->setCloseCallback([this]() { handleClose(); });
+    m_channel->setErrorCallback([this]() { handleError(); });
+    m_socket->setKeepAlive(true);
+    LOG_DEBUG << "TcpConnection::ctor[" << m_name << "] fd=" << sockfd;
+}
+
+TcpConnection::~TcpConnection()
+{
+    LOG_DEBUG << "TcpConnection::dtor[" << m_name << "] fd=" << m_channel->fd()
+              << " state=" << stateToString();
+    for(const PendingFile& file : m_pendingFiles)
+    {
+        ::close(file.fd);
+    }
+    // 中转管道在 ioLoop 中归还（connectDestroyed）；析构在其他线程时直接关闭
+    if(m_splicePipe.valid())
+    {
+        ::close(m_splicePipe.readFd);
+        ::close(m_splicePipe.writeFd);
+    }
+}
+
+void TcpConnection::send(const void* data, size_t len)
+{
+    if(m_state != kConnected) return;
+
+    if(m_loop->isInLoopThread())
+    {
+        sendInLoop(data, len);
+    }
+    else
+    {
+        // 跨线程：数据必须复制一份，调用者的缓冲区在返回后可能失效
+        std::string message(static_cast<const char*>(data), len);
+        m_loop->runInLoop([self = shared_from_this(), message = std::move(message)]() {
+            self->sendInLoop(message.data(), message.size());
+        });
+    }
+}
+
+void TcpConnection::send(const std::string& message)
+{
+    send(message.data(), message.size());
+}
+
+void TcpConnection::send(Buffer* buf)
+{
+    if(m_state != kConnected) return;
+
+    if(m_loop->isInLoopThread())
+    {
+        sendInLoop(buf->peek(), buf->readableBytes());
+        buf->retrieveAll();
+    }
+    else
+    {
+        m_loop->runInLoop([self = shared_from_this(), message = buf->retrieveAllAsString()]() {
+            self->sendInLoop(message.data(), message.size());
+        });
+    }
+}
+
+void TcpConnection::sendInLoop(const void* data, size_t len)
+{
+    m_loop->assertInLoopThread();
+    if(m_state == kDisconnected)
+    {
+        LOG_WARN << "TcpConnection::sendInLoop() disconnected, give up writing";
+        return;
+    }
+
+    ssize_t nwrote = 0;
+    size_t remaining = len;
+    bool faultError = false;
+
+    // 有排队的文件或转发数据时一定在关注可写事件
+    const bool outputIdle = !m_channel->isWriting() && m_outputBuffer.readableBytes() == 0 && !m_flushScheduled;
+    if(outputIdle && m_deferredSend && m_loop->dispatching())
+    {
+        // 正在处理本轮事件：先放进输出缓冲区，本轮结束时和之后的 send() 一起写出
+        m_flushScheduled = true;
+        m_loop->runAfterDispatch([self = shared_from_this()]() { self->flushDeferred(); });
+    }
+    else if(outputIdle)
+    {
+        // 没有排队的数据时先尝试直接写
+        ++m_writeSyscalls;
+        nwrote = details::sendNoSignal(m_channel->fd(), data, len);
+        if(nwrote >= 0)
+        {
+            remaining = len - static_cast<size_t>(nwrote);
+            if(remaining == 0 && m_writeCompleteCallback)
+            {
+                m_loop->queueInLoop([self = shared_from_this()]() { self->m_writeCompleteCallback(self); });
+            }
+        }
+        else
+        {
+            nwrote = 0;
+            if(errno != EWOULDBLOCK)
+            {
+                LOG_SYSERR << "TcpConnection::sendInLoop() [" << m_name << "]";
+                if(errno == EPIPE || errno == ECONNRESET)
+                {
+                    faultError = true;
+                }
+            }
+        }
+    }
+
+    if(!faultError && remaining > 0)
+    {
+        size_t oldLen = outputBytes();
+        if(oldLen + remaining >= m_highWaterMark && oldLen < m_highWaterMark && m_highWaterMarkCallback)
+        {
+            m_loop->queueInLoop([self = shared_from_this(), size = oldLen + remaining]() {
+                self->m_highWaterMarkCallback(self, size);
+            });
+        }
+        // 有排队的文件时追加在最后一个文件之后
+        Buffer* tail = m_pendingFiles.empty() ? &m_outputBuffer : &m_pendingFiles.back().after;
+        tail->append(static_cast<const char*>(data) + nwrote, remaining);
+        if(!m_channel->isWriting() && !m_flushScheduled)
+        {
+            m_channel->enableWriting();
+        }
+    }
+}
+
+void TcpConnection::sendFile(int fd, off_t offset, size_t length)
+{
+    if(m_state != kConnected || length == 0) return;
+
+    int dupFd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if(dupFd < 0)
+    {
+        LOG_SYSERR << "TcpConnection::sendFile() [" << m_name << "] dup";
+        return;
+    }
+    if(m_loop->isInLoopThread())
+    {
+        sendFileInLoop(dupFd, offset, length);
+    }
+    else
+    {
+        m_loop->runInLoop([self = shared_from_this(), dupFd, offset, length]() {
+            self->sendFileInLoop(dupFd, offset, length);
+        });
+    }
+}
+
+void TcpConnection::sendFileInLoop(int fd, off_t offset, size_t length)
+{
+    m_loop->assertInLoopThread();
+    if(m_state == kDisconnected)
+    {
+        LOG_WARN << "TcpConnection::sendFileInLoop() disconnected, give up sending file";
+        ::close(fd);
+        return;
+    }
+
+    size_t oldLen = outputBytes();
+    if(oldLen + length >= m_highWaterMark && oldLen < m_highWaterMark && m_highWaterMarkCallback)
+    {
+        m_loop->queueInLoop([self = shared_from_this(), size = oldLen + length]() {
+            self->m_highWaterMarkCallback(self, size);
+        });
+    }
+    m_pendingFiles.push_back(PendingFile{fd, offset, length, Buffer(0)});
+
+    // 前面没有排队的数据时直接开始发送，发不完的等可写事件
+    // 已经安排了本轮结束的 flushDeferred() 时由它一起发送
+    if(!m_channel->isWriting() && !m_flushScheduled)
+    {
+        if(drainOutput())
+        {
+            if(m_writeCompleteCallback)
+            {
+                m_loop->queueInLoop([self = shared_from_this()]() { self->m_writeCompleteCallback(self); });
+            }
+        }
+        else
+        {
+            m_channel->enableWriting();
+        }
+    }
+}
+
+void TcpConnection::forwardTo(const TcpConnectionPtr& dst)
+{
+    m_loop->assertInLoopThread();
+    assert(dst->getLoop() == m_loop);
+    assert(dst.get() != this);
+    if(m_state != kConnected || !dst->connected()) return;
+
+    if(!dst->m_splicePipe.valid())
+    {
+        dst->m_splicePipe = m_loop->pipePool()->acquire();
+        if(!dst->m_splicePipe.valid()) return;
+    }
+    m_forwardTarget = dst;
+    dst->m_forwardSource = shared_from_this();
+
+    // 转发开始前已经读到用户态的数据先按普通数据发给 dst
+    if(m_inputBuffer.readableBytes() > 0)
+    {
+        dst->send(&m_inputBuffer);
+    }
+    if(!m_channel->isReading()) m_channel->enableReading();
+}
+
+void TcpConnection::stopForwarding()
+{
+    m_loop->assertInLoopThread();
+    if(TcpConnectionPtr dst = m_forwardTarget.lock())
+    {
+        dst->m_forwardSource.reset();
+    }
+    m_forwardTarget.reset();
+    if(m_state == kConnected && !m_channel->isReading()) m_channel->enableReading();
+}
+
+size_t TcpConnection::outputBytes() const
+{
+    size_t bytes = m_outputBuffer.readableBytes() + m_pipeBytes;
+    for(const PendingFile& file : m_pendingFiles)
+    {
+        bytes += file.remaining + file.after.readableBytes();
+    }
+    return bytes;
+}
+
+void TcpConnection::shutdown()
+{
+    State expected = kConnected;
+    if(m_state.compare_exchange_strong(expected, kDisconnecting))
+    {
+        m_loop->runInLoop([self = shared_from_this()]() { self->shutdownInLoop(); });
+    }
+}
+
+void TcpConnection::shutdownInLoop()
+{
+    m_loop->assertInLoopThread();
+    // 还有数据没写完时等 handleWrite（或本轮结束的 flushDeferred）写空后再关闭
+    if(!m_channel->isWriting() && !m_flushScheduled)
+    {
+        m_socket->shutdownWrite();
+    }
+}
+
+void TcpConnection::forceClose()
+{
+    State state = m_state;
+    if(state == kConnected || state == kDisconnecting)
+    {
+        m_state = kDisconnecting;
+        m_loop->queueInLoop([self = shared_from_this()]() { self->forceCloseInLoop(); });
+    }
+}
+
+void TcpConnection::forceCloseInLoop()
+{
+    m_loop->assertInLoopThread();
+    if(m_state == kConnected || m_state == kDisconnecting)
+    {
+        handleClose();
+    }
+}
+
+void TcpConnection::setTcpNoDelay(bool on)
+{
+    m_socket->setTcpNoDelay(on);
+}
+
+void TcpConnection::connectEstablished()
+{
+    m_loop->assertInLoopThread();
+    assert(m_state == kConnecting);
+    m_state = kConnected;
+    m_channel->tie(shared_from_this());
+    m_channel->enableReading();
+
+    if(m_connectionCallback) m_connectionCallback(shared_from_this());
+}
+
+void TcpConnection::connectDestroyed()
+{
+    m_loop->assertInLoopThread();
+    if(m_state == kConnected || m_state == kDisconnecting)
+    {
+        // 没有经过 handleClose（例如 TcpServer 析构，或 shutdown() 后对端还没关闭）
+        m_state = kDisconnected;
+        m_channel->disableAll();
+        if(m_connectionCallback) m_connectionCallback(shared_from_this());
+    }
+    m_channel->remove();
+    releaseSplicePipe();
+}
+
+void TcpConnection::handleRead()
+{
+    m_loop->assertInLoopThread();
+    if(TcpConnectionPtr dst = m_forwardTarget.lock())
+    {
+        handleForwardRead(dst);
+        return;
+    }
+
+    int savedErrno = 0;
+    ssize_t n = m_inputBuffer.readFd(m_channel->fd(), &savedErrno);
+    if(n > 0)
+    {
+        if(m_messageCallback)
+        {
+            m_messageCallback(shared_from_this(), &m_inputBuffer);
+        }
+        else
+        {
+            m_inputBuffer.retrieveAll();
+        }
+    }
+    else if(n == 0)
+    {
+        handleClose();
+    }
+    else if(savedErrno != EAGAIN && savedErrno != EINTR)
+    {
+        errno = savedErrno;
+        LOG_SYSERR << "TcpConnection::handleRead() [" << m_name << "]";
+        handleError();
+    }
+}
+
+void TcpConnection::handleForwardRead(const TcpConnectionPtr& dst)
+{
+    if(!dst->connected())
+    {
+        // 转发目标已断开，源连接也没有继续存在的意义
+        stopForwarding();
+        handleClose();
+        return;
+    }
+    if(dst->m_channel->isWriting() || dst->m_flushScheduled)
+    {
+        // 背压：dst 还有排队的输出，暂停读，dst 写空后 resumeForwardSource()
+        // （管道中的数据先于 dst 的输出缓冲区发送，dst 有排队的数据时不能再转发）
+        m_channel->disableReading();
+        return;
+    }
+
+    ssize_t n = details::spliceNoSignal(m_channel->fd(), dst->m_splicePipe.writeFd, kSpliceChunk);
+    if(n > 0)
+    {
+        dst->m_pipeBytes += static_cast<size_t>(n);
+        if(!dst->drainOutput())
+        {
+            dst->m_channel->enableWriting();
+            m_channel->disableReading();
+        }
+    }
+    else if(n == 0)
+    {
+        // 源读到 EOF：把半关闭传给 dst，管道中剩余的数据写完后才会真正关闭写端
+        stopForwarding();
+        dst->shutdown();
+        handleClose();
+    }
+    else if(errno != EAGAIN && errno != EINTR)
+    {
+        LOG_SYSERR << "TcpConnection::handleForwardRead() [" << m_name << "]";
+        handleError();
+    }
+}
+
+void TcpConnection::resumeForwardSource()
+{
+    TcpConnectionPtr source = m_forwardSource.lock();
+    if(source && source->connected() && !source->m_channel->isReading())
+    {
+        source->m_channel->enableReading();
+    }
+}
+
+void TcpConnection::releaseSplicePipe()
+{
+    if(m_splicePipe.valid())
+    {
+        m_loop->pipePool()->release(m_splicePipe, m_pipeBytes == 0);
+        m_splicePipe = Pipe();
+        m_pipeBytes = 0;
+    }
+}
+
+bool TcpConnection::drainOutput()
+{
+    const int fd = m_channel->fd();
+
+    // 中转管道中的数据先发送；一次写不完说明发送缓冲区满了，等下一次可写事件
+    if(m_pipeBytes > 0)
+    {
+        ++m_writeSyscalls;
+        ssize_t n = details::spliceNoSignal(m_splicePipe.readFd, fd, m_pipeBytes);
+        if(n > 0) m_pipeBytes -= static_cast<size_t>(n);
+        if(m_pipeBytes > 0)
+        {
+            if(n < 0 && errno != EAGAIN) LOG_SYSERR << "TcpConnection::drainOutput() [" << m_name << "] splice";
+            return false;
+        }
+    }
+
+    for(;;)
+    {
+        if(m_outputBuffer.readableBytes() > 0)
+        {
+            ++m_writeSyscalls;
+            ssize_t n = details::sendNoSignal(fd, m_outputBuffer.peek(), m_outputBuffer.readableBytes());
+            if(n > 0) m_outputBuffer.retrieve(static_cast<size_t>(n));
+            if(m_outputBuffer.readableBytes() > 0)
+            {
+                if(n < 0 && errno != EWOULDBLOCK) LOG_SYSERR << "TcpConnection::handleWrite() [" << m_name << "]";
+                return false;
+            }
+        }
+        if(m_pendingFiles.empty()) return true;
+
+        PendingFile& file = m_pendingFiles.front();
+        if(file.remaining > 0)
+        {
+            ++m_writeSyscalls;
+            ssize_t n = details::sendFileNoSignal(fd, file.fd, &file.offset, file.remaining);
+            if(n > 0)
+            {
+                file.remaining -= static_cast<size_t>(n);
+                if(file.remaining > 0) return false;
+            }
+            else if(n == 0)
+            {
+                LOG_WARN << "TcpConnection::drainOutput() [" << m_name << "] file ended "
+                         << file.remaining << " bytes early";
+            }
+            else if(errno == EAGAIN)
+            {
+                return false;
+            }
+            else
+            {
+                // 文件读错误或连接已出错：丢弃这个文件剩余的部分
+                LOG_SYSERR << "TcpConnection::drainOutput() [" << m_name << "] sendfile";
+            }
+        }
+        ::close(file.fd);
+        m_outputBuffer.swap(file.after);
+        m_pendingFiles.pop_front();
+    }
+}
+
+void TcpConnection::flushDeferred()
+{
+    m_flushScheduled = false;
+    // 已断开，或者期间因为 sendFile/转发开始关注可写事件（由 handleWrite 继续）
+    if(m_state == kDisconnected || m_channel->isWriting()) return;
+
+    if(drainOutput())
+    {
+        resumeForwardSource();
+        if(m_writeCompleteCallback)
+        {
+            m_loop->queueInLoop([self = shared_from_this()]() { self->m_writeCompleteCallback(self); });
+        }
+        if(m_state == kDisconnecting)
+        {
+            shutdownInLoop();
+        }
+    }
+    else
+    {
+        // 内核发送缓冲区满了，剩余的等可写事件
+        m_channel->enableWriting();
+    }
+}
+
+void TcpConnection::handleWrite()
+{
+    m_loop->assertInLoopThread();
+    if(!m_channel->isWriting())
+    {
+        LOG_TRACE << "TcpConnection fd=" << m_channel->fd() << " is down, no more writing";
+        return;
+    }
+
+    if(drainOutput())
+    {
+        m_channel->disableWriting();
+        resumeForwardSource();
+        if(m_writeCompleteCallback)
+        {
+            m_loop->queueInLoop([self = shared_from_this()]() { self->m_writeCompleteCallback(self); });
+        }
+        if(m_state == kDisconnecting)
+        {
+            shutdownInLoop();
+        }
+    }
+}
+
+void TcpConnection::handleClose()
+{
+    m_loop->assertInLoopThread();
+    LOG_TRACE << "TcpConnection fd=" << m_channel->fd() << " state=" << stateToString();
+    assert(m_state == kConnected || m_state == kDisconnecting);
+    m_state = kDisconnected;
+    m_channel->disableAll();
+    if(TcpConnectionPtr source = m_forwardSource.lock())
+    {
+        // 转发目标断开，源连接随之关闭
+        source->forceClose();
+    }
+    releaseSplicePipe();
+
+    // 回调期间保活，CloseCallback 会让 TcpServer 释放它持有的引用
+    TcpConnectionPtr guardThis(shared_from_this());
+    if(m_connectionCallback) m_connectionCallback(guardThis);
+    if(m_closeCallback) m_closeCallback(guardThis);
+}
+
+void TcpConnection::handleError()
+{
+    int err = Socket::getSocketError(m_channel->fd());
+    LOG_ERROR << "TcpConnection::handleError() [" << m_name << "] SO_ERROR = " << err
+              << " " << strerror_tl(err);
+}
+
+const char* TcpConnection::stateToString() const
+{
+    switch(m_state.load())
+    {
+        case kDisconnected: return "kDisconnected";
+        case kConnecting: return "kConnecting";
+        case kConnected: return "kConnected";
+        case kDisconnecting: return "kDisconnecting";
+    }
+    return "unknown state";
+}
+
+}// namespace reactor
@@ -0,0 +1,105 @@
+#include "reactor/tcpserver.h"
+#include "reactor/acceptor.h"
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthreadpool.h"
+#include "reactor/logging.h"
+#include "reactor/socket.h"
+#include "reactor/tcpconnection.h"
+#include <cassert>
+
+namespace reactor
+{
+
+TcpServer::TcpServer(EventLoop* loop, const InetAddress& listenAddr, std::string name, bool reusePort)
+    : m_loop(loop),
+      m_ipPort(listenAddr.toIpPort()),
+      m_name(std::move(name)),
+      m_acceptor(std::make_unique<Acceptor>(loop, listenAddr, reusePort)),
+      m_threadPool(std::make_unique<EventLoopThreadPool>(loop)),
+      m_started(false),
+      m_nextConnId(1)
+{
+    assert(loop != nullptr);
+    m_acceptor->setNewConnectionCallback([this](int sockfd, const InetAddress& peerAddr) {
+        newConnection(sockfd, peerAddr);
+    });
+}
+
+TcpServer::~TcpServer()
+{
+    m_loop->assertInLoopThread();
+    LOG_TRACE << "TcpServer::~TcpServer [" << m_name << "] destructing";
+
+    for(auto& item : m_connections)
+    {
+        TcpConnectionPtr conn(item.second);
+        item.second.reset();
+        conn->getLoop()->runInLoop([conn]() { conn->connectDestroyed(); });
+    }
+}
+
+InetAddress TcpServer::listenAddress() const
+{
+    return m_acceptor->listenAddress();
+}
+
+void TcpServer::setThreadNum(int numThreads)
+{
+    assert(numThreads >= 0 || numThreads == EventLoopThreadPool::kAutoThreadNum);
+    m_threadPool->setThreadNum(numThreads);
+}
+
+void TcpServer::setLoopOptions(const EventLoopOptions& options)
+{
+    m_threadPool->setLoopOptions(options);
+}
+
+void TcpServer::start()
+{
+    if(m_started.exchange(true)) return;
+
+    m_threadPool->start();
+    assert(!m_acceptor->listening());
+    m_loop->runInLoop([this]() { m_acceptor->listen(); });
+    LOG_INFO << "TcpServer [" << m_name << "] listening on " << m_ipPort;
+}
+
+void TcpServer::newConnection(int sockfd, const InetAddress& peerAddr)
+{
+    m_loop->assertInLoopThread();
+    EventLoop* ioLoop = m_threadPool->getNextLoop();
+    std::string connName = m_name + "-" + m_ipPort + "#" + std::to_string(m_nextConnId);
+    ++m_nextConnId;
+
+    LOG_DEBUG << "TcpServer::newConnection [" << m_name << "] - new connection [" << connName
+              << "] from " << peerAddr.toIpPort();
+
+    InetAddress localAddr(Socket::getLocalAddr(sockfd));
+    auto conn = std::make_shared<TcpConnection>(ioLoop, connName, sockfd, localAddr, peerAddr);
+    m_connections[connName] = conn;
+    conn->setConnectionCallback(m_connectionCallback);
+    conn->setMessageCallback(m_messageCallback);
+    conn->setWriteCompleteCallback(m_writeCompleteCallback);
+    conn->setCloseCallback([this](const TcpConnectionPtr& c) { removeConnection(c); });
+    ioLoop->runInLoop([conn]() { conn->connectEstablished(); });
+}
+
+void TcpServer::removeConnection(const TcpConnectionPtr& conn)
+{
+    m_loop->runInLoop([this, conn]() { removeConnectionInLoop(conn); });
+}
+
+void TcpServer::removeConnectionInLoop(const TcpConnectionPtr& conn)
+{
+    m_loop->assertInLoopThread();
+    LOG_DEBUG << "TcpServer::removeConnectionInLoop [" << m_name << "] - connection " << conn->name();
+    size_t n = m_connections.erase(conn->name());
+    assert(n == 1);
+    (void)n;
+
+    // connectDestroyed 必须排队执行：当前可能还在 conn 的 Channel::handleEvent 中
+    EventLoop* ioLoop = conn->getLoop();
+    ioLoop->queueInLoop([conn]() { conn->connectDestroyed(); });
+}
+
+}// namespace reactor
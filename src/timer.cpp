@@ -2,21 +2,20 @@
 
 namespace reactor
 {
-std::atomic<int64_t> Timer::s_sequence(0);
 
-void Timer::restart(Timestamp now)
+void Timer::restart(MonoTime now)
 {
     if (m_repeat)
     {
         // 计算下一个到期时间
-        m_expiration = addTime(now, m_interval);
+        m_expiration = now + m_interval;
     }
     else
     {
-        // 单次定时器，设置为无效时间
-        m_expiration = Timestamp::invalid();
+        // 单次定时器，不再到期
+        m_expiration = kNoExpiration;
     }
 }
 
 
-}
\ No newline at end of file
+}
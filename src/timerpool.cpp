@@ -0,0 +1,111 @@
+#include "reactor/timerpool.h"
+#include "reactor/timer.h"
+#include "reactor/logging.h"
+#include <cassert>
+
+namespace reactor
+{
+
+TimerPool::TimerPool()
+    : m_numChunks(0),
+      m_freeHead(kNoIndex),
+      m_size(0)
+{
+    for (auto& chunk : m_chunks)
+    {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+TimerPool::~TimerPool()
+{
+    for (uint32_t i = 0; i < m_numChunks; ++i)
+    {
+        delete[] m_chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+Timer* TimerPool::slot(uint32_t index) const
+{
+    return m_chunks[index >> kChunkBits].load(std::memory_order_acquire) + (index & (kChunkSize - 1));
+}
+
+void TimerPool::grow()
+{
+    if (m_numChunks == kMaxChunks)
+    {
+        LOG_FATAL << "TimerPool::grow() too many timers: " << static_cast<unsigned long>(kMaxChunks) * kChunkSize;
+    }
+
+    Timer* chunk = new Timer[kChunkSize];
+    uint32_t base = m_numChunks << kChunkBits;
+    // 新块按下标顺序挂到空闲链表头部
+    for (uint32_t i = 0; i < kChunkSize; ++i)
+    {
+        chunk[i].m_index = base + i;
+        chunk[i].m_nextFree = i + 1 < kChunkSize ? base + i + 1 : m_freeHead;
+    }
+    m_freeHead = base;
+    m_chunks[m_numChunks].store(chunk, std::memory_order_release);
+    ++m_numChunks;
+}
+
+Timer* TimerPool::alloc(TimerCallback cb, MonoTime when, Nanoseconds interval, Nanoseconds slack)
+{
+    Timer* timer;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_freeHead == kNoIndex)
+        {
+            grow();
+        }
+        timer = slot(m_freeHead);
+        m_freeHead = timer->m_nextFree;
+    }
+    m_size.fetch_add(1, std::memory_order_relaxed);
+
+    assert(timer->m_state == Timer::kFree);
+    timer->m_callback = std::move(cb);
+    timer->m_expiration = when;
+    timer->m_interval = interval;
+    timer->m_slack = slack > Nanoseconds::zero() ? slack : Nanoseconds::zero();
+    timer->m_repeat = interval > Nanoseconds::zero();
+    timer->m_state = Timer::kPending;
+    return timer;
+}
+
+void TimerPool::free(Timer* timer)
+{
+    assert(timer->m_state != Timer::kFree);
+    assert(!timer->inWheel());
+
+    // 先在锁外销毁回调（可能释放用户捕获的资源）
+    timer->m_callback = nullptr;
+    timer->m_state = Timer::kFree;
+    ++timer->m_generation;
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    timer->m_nextFree = m_freeHead;
+    m_freeHead = timer->m_index;
+}
+
+Timer* TimerPool::get(TimerId timerId) const
+{
+    uint32_t index = timerId.index();
+    if (!timerId.valid() || (index >> kChunkBits) >= kMaxChunks)
+        return nullptr;
+
+    Timer* chunk = m_chunks[index >> kChunkBits].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+        return nullptr;
+
+    // 只比较代数：过期句柄的槽位可能正被其他线程的 alloc() 重新初始化，不能读 m_state；
+    // 代数只在 free() 中递增，相同就说明是当前这次分配，槽位不会是 kFree
+    Timer* timer = chunk + (index & (kChunkSize - 1));
+    if (timer->m_generation != timerId.generation())
+        return nullptr;
+    return timer;
+}
+
+}// namespace reactor
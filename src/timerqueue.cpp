@@ -3,11 +3,12 @@
 #include "reactor/timer.h"
 #include "reactor/timerid.h"
 #include "reactor/channel.h"
+#include "reactor/timingwheel.h"
+#include "reactor/logging.h"
 #include <sys/timerfd.h>
 #include <unistd.h>
 #include <cstring>
 #include <cassert>
-#include <iostream>
 
 namespace reactor
 {
@@ -19,37 +20,22 @@ int createTimerfd()
     int timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
     if (timerfd < 0)
     {
-        std::cerr << "Failed to create timerfd: " << strerror(errno) << std::endl;
-        abort();
+        LOG_SYSFATAL << "Failed to create timerfd";
     }
     return timerfd;
 }
 
-// 计算超时时间（从现在到when）
-struct timespec howMuchTimeFromNow(Timestamp when)
-{
-    int64_t microSeconds = when.microSecondsSinceEpoch() - Timestamp::now().microSecondsSinceEpoch();
-    if(microSeconds < 100)
-        microSeconds = 100; // 最小超时时间为100微秒
-    
-    struct timespec ts;
-    ts.tv_sec = static_cast<time_t>(microSeconds / Timestamp::kMicroSecondsPerSecond);
-    ts.tv_nsec = static_cast<long>((microSeconds % Timestamp::kMicroSecondsPerSecond) * 1000); // 转换为纳秒
-    return ts;
-}
-
-void readTimerfd(int timerfd, Timestamp now)
+void readTimerfd(int timerfd, MonoTime now)
 {
     uint64_t howmany;
     ssize_t n = ::read(timerfd, &howmany, sizeof howmany);
-    std::cout << "TimerQueue::handleRead() " << howmany << " at "
-              << now.toString() << std::endl;
+    LOG_TRACE << "TimerQueue::handleRead() " << howmany << " at " << toNanoseconds(now);
     if (n != sizeof howmany) {
-        std::cerr << "TimerQueue::handleRead() reads " << n << " bytes instead of 8" << std::endl;
+        LOG_ERROR << "TimerQueue::handleRead() reads " << n << " bytes instead of 8";
     }
 }
 
-void resetTimerfd(int timerfd, Timestamp expiration)
+void resetTimerfd(int timerfd, MonoTime expiration)
 {
     struct itimerspec newValue;
     struct itimerspec oldValue;
@@ -57,22 +43,42 @@ void resetTimerfd(int timerfd, Timestamp expiration)
     std::memset(&oldValue, 0, sizeof oldValue);
     // 注意：我们只设置 it_value，不设置 it_interval
     // 因为 TimerQueue 自己管理重复逻辑，不依赖 timerfd 的重复功能
-    newValue.it_value = howMuchTimeFromNow(expiration);
-    
-    timerfd_settime(timerfd, 0, &newValue, &oldValue);
+    // 绝对时间：已经过去的时间点会立即触发；全0表示停止，所以至少为1纳秒
+    newValue.it_value = toTimespec(expiration);
+    if(newValue.it_value.tv_sec == 0 && newValue.it_value.tv_nsec == 0) newValue.it_value.tv_nsec = 1;
+
+    if(::timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &newValue, &oldValue) < 0)
+    {
+        LOG_SYSERR << "timerfd_settime()";
+    }
 
 }
 
 
 }// namespace details
 
-TimerQueue::TimerQueue(EventLoop* loop)
+TimerQueue::TimerQueue(EventLoop* loop, TimerBackend backend, int64_t wheelTickMicroseconds)
     : m_loop(loop),
+      m_backend(backend),
       m_timerfd(details::createTimerfd()),
+      m_pool(),
       m_timers(),
-      m_timerfdChannel(std::make_unique<Channel>(loop, m_timerfd)),
-      m_cancellingTimers()
+      m_expired(),
+      m_spareNodes(),
+      m_wheel(),
+      m_armed(kNoExpiration),
+      m_syscalls(0),
+      m_wakeups(0),
+      m_timerfdChannel(std::make_unique<Channel>(loop, m_timerfd))
 {
+    if(m_backend == TimerBackend::kTimingWheel)
+    {
+        m_wheel = std::make_unique<TimingWheel>(std::chrono::microseconds(wheelTickMicroseconds), MonoClock::now());
+    }
+
+    m_expired.reserve(kInitialListCapacity);
+    m_spareNodes.reserve(kInitialListCapacity);
+
     m_timerfdChannel->setReadCallback(std::bind(&TimerQueue::handleRead, this));
     m_timerfdChannel->enableReading();
 }
@@ -83,121 +89,222 @@ TimerQueue::~TimerQueue()
     m_timerfdChannel->remove();
     close(m_timerfd);
 
-    for(const Entry& entry : m_timers)
+    // 定时器对象由 m_pool 统一释放，这里只需要清空时间轮的链表
+    if(m_wheel)
     {
-        delete entry.second; // 删除定时器对象
+        std::vector<Timer*> timers;
+        m_wheel->takeAll(&timers);
     }
 }
 
-TimerId TimerQueue::addTimer(TimerCallback cb, Timestamp when, double interval)
+TimerId TimerQueue::addTimer(TimerCallback cb, MonoTime when, Nanoseconds interval, Nanoseconds slack)
 {
-    Timer* timer = new Timer(std::move(cb), when, interval);
-    m_loop->runInLoop(std::bind(&TimerQueue::addTimerInLoop, this, timer));
-    return TimerId(timer, timer->sequence());
+    Timer* timer = m_pool.alloc(std::move(cb), when, interval, slack);
+    TimerId timerId(timer->index(), timer->generation());
+    // lambda 只捕获两个指针，放在 Functor 的内部缓冲区中，不需要堆分配
+    m_loop->runInLoop([this, timer]() { addTimerInLoop(timer); });
+    return timerId;
 }
 
 void TimerQueue::cancel(TimerId timerId)
 {
-    m_loop->runInLoop(std::bind(&TimerQueue::cancelInLoop, this, timerId));
+    m_loop->runInLoop([this, timerId]() { cancelInLoop(timerId); });
 }
 
 void TimerQueue::cancelInLoop(TimerId timerId)
 {
     m_loop->assertInLoopThread();
-    Entry entry(timerId.timer()->expiration(), timerId.timer());
-    
-    auto it = m_timers.find(entry);
-    if(it != m_timers.end())
+
+    // 代数不匹配说明定时器已经到期或被取消，句柄失效，什么都不用做
+    Timer* timer = m_pool.get(timerId);
+    if(timer == nullptr) return;
+
+    if(timer->state() == Timer::kExpired)
     {
-        m_timers.erase(it);
-        delete timerId.timer();
+        // 定时器在本轮到期列表中（例如在回调中取消同时到期的定时器）
+        // 交给 reset() 释放，防止重复定时器被重新插入
+        timer->setState(Timer::kCancelled);
+        return;
+    }
+    if(timer->state() != Timer::kPending) return;
+
+    bool removed = false;
+    if(m_wheel)
+    {
+        if(timer->inWheel())
+        {
+            m_wheel->remove(timer);
+            removed = true;
+        }
     }
     else
     {
-        //如果当前线程定时器的回调函数是取消其他定时器，需要m_cancellingTimers解决冲突
-        m_cancellingTimers.insert(timerId.timer());
+        TimerSet::node_type node = m_timers.extract(Entry(timer->expiration(), timer));
+        if(!node.empty())
+        {
+            recycleNode(std::move(node));
+            removed = true;
+        }
     }
 
+    if(removed)
+        m_pool.free(timer);
+    else
+        timer->setState(Timer::kCancelled); // addTimerInLoop 尚未执行，由它负责释放
 }
 
 void TimerQueue::handleRead()
 {
     m_loop->assertInLoopThread();
-    Timestamp now(Timestamp::now());
+    // 本轮 poll 返回时缓存的时间，不再读时钟
+    // 之后才到期的定时器留到下一轮：timerfd 会以已经过去的绝对时间重新设置，立即再次触发
+    MonoTime now = m_loop->now();
     details::readTimerfd(m_timerfd, now);
+    ++m_wakeups;
+    m_armed = kNoExpiration; // timerfd 已经触发，不再处于设置状态
 
-    std::vector<Entry> expired = getExpired(now);
-    for(const Entry& it : expired)
+    getExpired(now);
+    if(LoopMetrics* metrics = m_loop->metrics())
     {
-        if(m_cancellingTimers.find(it.second) == m_cancellingTimers.end())
+        for(Timer* timer : m_expired)
         {
-            it.second->run();
+            int64_t lateNs = (now - timer->expiration()).count();
+            metrics->timerLatenessNs.record(lateNs > 0 ? static_cast<uint64_t>(lateNs) : 0);
         }
     }
+    for(Timer* timer : m_expired)
+    {
+        // 回调中可能取消了同一批中的其他定时器
+        if(timer->state() == Timer::kExpired) timer->run();
+    }
 
-    reset(expired, now);
+    reset(now);
 }
 
-void TimerQueue::reset(const std::vector<Entry>& expired, Timestamp now)
+void TimerQueue::reset(MonoTime now)
 {
-    for(const Entry& it : expired)
+    for(Timer* timer : m_expired)
     {
-        if(it.second->repeat() && m_cancellingTimers.find(it.second) == m_cancellingTimers.end())
+        if(timer->repeat() && timer->state() == Timer::kExpired)
         {
-            it.second->restart(now);
-            insert(it.second);
+            timer->restart(now);
+            timer->setState(Timer::kPending);
+            if(m_wheel)
+                m_wheel->add(timer);
+            else
+                insert(timer);
         }
         else
-            delete it.second;
+            m_pool.free(timer);
+    }
+    m_expired.clear();
+
+    if(m_wheel)
+    {
+        rearmWheel();
+        return;
     }
 
-    m_cancellingTimers.clear();
-    // 如果还有定时器，重置timerfd
-    if(!m_timers.empty())
+    // 如果还有定时器，按最晚触发时间的最小值重置 timerfd
+    // 集合按到期时间排序，到期时间不早于当前结果的定时器不会让结果更早，扫描到此为止；
+    // 扫描过的定时器都会在这次唤醒中到期，均摊开销是每个定时器 O(1)
+    MonoTime deadline = kNoExpiration;
+    for(auto it = m_timers.begin(); it != m_timers.end() && it->first < deadline; ++it)
     {
-        Timestamp nextExpire = m_timers.begin()->first;
-        if(nextExpire.valid()) details::resetTimerfd(m_timerfd, nextExpire);
+        MonoTime latest = it->second->latest();
+        if(latest < deadline) deadline = latest;
     }
+    if(deadline < m_armed) arm(deadline);
 
 }
 
-std::vector<TimerQueue::Entry> TimerQueue::getExpired(Timestamp now)
+void TimerQueue::getExpired(MonoTime now)
 {
-    std::vector<TimerQueue::Entry> expired;
-
-    Entry entry(now, reinterpret_cast<Timer*>(UINTPTR_MAX));
-    // lower_bound: 返回第一个 >= entry 的迭代器
-    //所有 < now 的定时器都在 [begin, end) 区间
-    auto end = m_timers.lower_bound(entry);
-    assert(end == m_timers.end() || now < end->first);
+    assert(m_expired.empty());
 
-    std::copy(m_timers.begin(), end, back_inserter(expired));
-    m_timers.erase(m_timers.begin(), end);
+    if(m_wheel)
+    {
+        m_wheel->advance(now, &m_expired);
+    }
+    else
+    {
+        // 所有到期时间 <= now 的定时器都在集合头部
+        // 用 extract 摘下节点而不是 erase，节点留给后续插入复用
+        while(!m_timers.empty() && !(now < m_timers.begin()->first))
+        {
+            TimerSet::node_type node = m_timers.extract(m_timers.begin());
+            m_expired.push_back(node.value().second);
+            recycleNode(std::move(node));
+        }
+    }
 
-    return expired;
+    for(Timer* timer : m_expired) timer->setState(Timer::kExpired);
 }
 
 void TimerQueue::addTimerInLoop(Timer* timer)
 {
     m_loop->assertInLoopThread();
 
-    bool isEarliestTimer = insert(timer);
-    if(isEarliestTimer) details::resetTimerfd(m_timerfd, timer->expiration());
+    if(timer->state() == Timer::kCancelled)
+    {
+        // 加入之前就被取消了
+        m_pool.free(timer);
+        return;
+    }
+
+    if(m_wheel)
+    {
+        m_wheel->add(timer);
+        rearmWheel();
+        return;
+    }
+
+    // 只有最晚触发时间早于已设置的时间才需要 timerfd_settime；
+    // 没有容差时等价于“成为最早的定时器”
+    insert(timer);
+    if(timer->latest() < m_armed) arm(timer->latest());
+}
+
+void TimerQueue::arm(MonoTime deadline)
+{
+    m_armed = deadline;
+    ++m_syscalls;
+    details::resetTimerfd(m_timerfd, deadline);
 }
 
-bool TimerQueue::insert(Timer* timer)
+void TimerQueue::rearmWheel()
 {
-    assert(m_timers.size() < 100000);
-    
-    bool isEarliestTimer = false;   //是否是最早的定时器
-    Timestamp when = timer->expiration();
-    auto it = m_timers.begin();
-    if(it == m_timers.end() || when < it->first)
-        isEarliestTimer = true;
+    // 只有下一次推进时间比已设置的更早时才需要 timerfd_settime
+    MonoTime next = m_wheel->nextExpiration();
+    if(next < m_armed) arm(next);
+}
 
-    auto result = m_timers.insert(Entry(when, timer));
-    assert(result.second);
-    return isEarliestTimer;
+void TimerQueue::insert(Timer* timer)
+{
+    MonoTime when = timer->expiration();
+
+    if(!m_spareNodes.empty())
+    {
+        // 复用之前释放的节点，避免 set 节点的 malloc/free
+        TimerSet::node_type node = std::move(m_spareNodes.back());
+        m_spareNodes.pop_back();
+        node.value() = Entry(when, timer);
+        auto result = m_timers.insert(std::move(node));
+        assert(result.inserted);
+        (void)result;
+    }
+    else
+    {
+        auto result = m_timers.insert(Entry(when, timer));
+        assert(result.second);
+        (void)result;
+    }
+}
+
+void TimerQueue::recycleNode(TimerSet::node_type node)
+{
+    if(m_spareNodes.size() < kMaxSpareNodes)
+        m_spareNodes.push_back(std::move(node));
 }
 
-}// namespace reactor
\ No newline at end of file
+}// namespace reactor
@@ -0,0 +1,260 @@
+#include "reactor/timingwheel.h"
+#include "reactor/timer.h"
+#include <cassert>
+#include <cstring>
+
+namespace reactor
+{
+
+TimingWheel::TimingWheel(Nanoseconds tick, MonoTime start)
+    : m_tickNs(tick.count()),
+      m_start(start),
+      m_currentTick(0),
+      m_size(0)
+{
+    assert(m_tickNs > 0);
+    std::memset(m_levelSize, 0, sizeof m_levelSize);
+    std::memset(m_slots, 0, sizeof m_slots);
+    std::memset(m_occupied, 0, sizeof m_occupied);
+}
+
+TimingWheel::~TimingWheel()
+{
+    assert(m_size == 0); // 定时器由 TimerQueue 负责释放
+}
+
+int64_t TimingWheel::tickOf(MonoTime when) const
+{
+    int64_t delta = (when - m_start).count();
+    if (delta <= 0)
+        return 0;
+    return (delta + m_tickNs - 1) / m_tickNs;
+}
+
+MonoTime TimingWheel::timeOf(int64_t tick) const
+{
+    return m_start + Nanoseconds(tick * m_tickNs);
+}
+
+void TimingWheel::add(Timer* timer)
+{
+    assert(timer->m_wheelSlot < 0);
+
+    // 当前 tick 的槽已经处理过，已到期的定时器放到下一个 tick
+    int64_t expireTick = tickOf(timer->expiration());
+    if (expireTick <= m_currentTick)
+        expireTick = m_currentTick + 1;
+
+    place(timer, expireTick);
+    ++m_size;
+}
+
+void TimingWheel::remove(Timer* timer)
+{
+    assert(timer->m_wheelSlot >= 0);
+    unlink(timer);
+    --m_size;
+}
+
+void TimingWheel::place(Timer* timer, int64_t expireTick)
+{
+    assert(expireTick >= m_currentTick);
+    int64_t delta = expireTick - m_currentTick;
+
+    int slot;
+    if (delta < kLevel0Slots)
+    {
+        slot = static_cast<int>(expireTick & (kLevel0Slots - 1));
+    }
+    else
+    {
+        if (delta >= kMaxTicks)
+        {
+            // 超出时间轮范围，先放在最高层最远的位置，级联时重新计算
+            expireTick = m_currentTick + kMaxTicks - 1;
+            delta = kMaxTicks - 1;
+        }
+
+        int level = 1;
+        int shift = kLevel0Bits;
+        while (delta >= (int64_t(1) << (shift + kLevelBits)))
+        {
+            ++level;
+            shift += kLevelBits;
+        }
+        slot = kLevel0Slots + (level - 1) * kLevelSlots +
+               static_cast<int>((expireTick >> shift) & (kLevelSlots - 1));
+    }
+
+    link(slot, timer);
+}
+
+void TimingWheel::link(int slot, Timer* timer)
+{
+    Timer* head = m_slots[slot];
+    timer->m_wheelPrev = nullptr;
+    timer->m_wheelNext = head;
+    timer->m_wheelSlot = slot;
+    if (head)
+        head->m_wheelPrev = timer;
+    m_slots[slot] = timer;
+    m_occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+
+    int level = slot < kLevel0Slots ? 0 : 1 + (slot - kLevel0Slots) / kLevelSlots;
+    ++m_levelSize[level];
+}
+
+void TimingWheel::unlink(Timer* timer)
+{
+    int slot = timer->m_wheelSlot;
+    if (timer->m_wheelPrev)
+        timer->m_wheelPrev->m_wheelNext = timer->m_wheelNext;
+    else
+        m_slots[slot] = timer->m_wheelNext;
+    if (timer->m_wheelNext)
+        timer->m_wheelNext->m_wheelPrev = timer->m_wheelPrev;
+
+    if (m_slots[slot] == nullptr)
+        m_occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+
+    timer->m_wheelPrev = nullptr;
+    timer->m_wheelNext = nullptr;
+    timer->m_wheelSlot = -1;
+
+    int level = slot < kLevel0Slots ? 0 : 1 + (slot - kLevel0Slots) / kLevelSlots;
+    --m_levelSize[level];
+}
+
+void TimingWheel::cascade(int level)
+{
+    int shift = kLevel0Bits + (level - 1) * kLevelBits;
+    int slot = kLevel0Slots + (level - 1) * kLevelSlots +
+               static_cast<int>((m_currentTick >> shift) & (kLevelSlots - 1));
+
+    Timer* timer = m_slots[slot];
+    while (timer)
+    {
+        Timer* next = timer->m_wheelNext;
+        unlink(timer);
+        // 级联时 m_currentTick 所在槽尚未处理，剩余0个 tick 的定时器可以直接放入
+        int64_t expireTick = tickOf(timer->expiration());
+        if (expireTick < m_currentTick)
+            expireTick = m_currentTick;
+        place(timer, expireTick);
+        timer = next;
+    }
+}
+
+void TimingWheel::advance(MonoTime now, std::vector<Timer*>* expired)
+{
+    // 只处理结束时间 <= now 的 tick（向下取整），保证定时器不会提前触发
+    int64_t elapsed = (now - m_start).count();
+    const int64_t target = elapsed > 0 ? elapsed / m_tickNs : 0;
+
+    while (m_currentTick < target)
+    {
+        if (m_size == 0)
+        {
+            m_currentTick = target;
+            break;
+        }
+
+        // 第0层为空时直接跳到下一次级联之前，避免空转
+        if (m_levelSize[0] == 0)
+        {
+            int64_t boundary = ((m_currentTick >> kLevel0Bits) + 1) << kLevel0Bits;
+            if (boundary - 1 > m_currentTick)
+            {
+                m_currentTick = boundary - 1 < target ? boundary - 1 : target;
+                continue;
+            }
+        }
+
+        ++m_currentTick;
+
+        // 低层转完一圈，依次级联更高层对应的槽
+        int64_t tick = m_currentTick;
+        int shift = kLevel0Bits;
+        for (int level = 1; level < kLevels; ++level)
+        {
+            if ((tick & ((int64_t(1) << shift) - 1)) != 0)
+                break;
+            cascade(level);
+            shift += kLevelBits;
+        }
+
+        int slot = static_cast<int>(m_currentTick & (kLevel0Slots - 1));
+        Timer* timer = m_slots[slot];
+        while (timer)
+        {
+            Timer* next = timer->m_wheelNext;
+            unlink(timer);
+            --m_size;
+            expired->push_back(timer);
+            timer = next;
+        }
+    }
+}
+
+int TimingWheel::findLevel0Slot(int start) const
+{
+    // 先查 [start, 256)，再查 [0, start)
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int begin = pass == 0 ? start : 0;
+        int end = pass == 0 ? kLevel0Slots : start;
+        for (int word = begin / 64; word * 64 < end; ++word)
+        {
+            uint64_t bits = m_occupied[word];
+            if (word == begin / 64)
+                bits &= ~uint64_t(0) << (begin % 64);
+            if (bits)
+            {
+                int idx = word * 64 + __builtin_ctzll(bits);
+                if (idx < end)
+                    return idx;
+                break;
+            }
+        }
+    }
+    return -1;
+}
+
+MonoTime TimingWheel::nextExpiration() const
+{
+    if (m_size == 0)
+        return kNoExpiration;
+
+    int64_t nextTick = INT64_MAX;
+    if (m_levelSize[0] > 0)
+    {
+        // 第0层的非空槽一定对应 (m_currentTick, m_currentTick + 256] 中的某个 tick
+        int start = static_cast<int>((m_currentTick + 1) & (kLevel0Slots - 1));
+        int slot = findLevel0Slot(start);
+        assert(slot >= 0);
+        nextTick = m_currentTick + 1 + ((slot - start + kLevel0Slots) & (kLevel0Slots - 1));
+    }
+    if (m_size > m_levelSize[0])
+    {
+        // 高层有定时器，至少要在下一次级联时醒来
+        int64_t boundary = ((m_currentTick >> kLevel0Bits) + 1) << kLevel0Bits;
+        if (boundary < nextTick)
+            nextTick = boundary;
+    }
+    return timeOf(nextTick);
+}
+
+void TimingWheel::takeAll(std::vector<Timer*>* timers)
+{
+    for (int slot = 0; slot < kTotalSlots; ++slot)
+    {
+        while (Timer* timer = m_slots[slot])
+        {
+            unlink(timer);
+            timers->push_back(timer);
+        }
+    }
+    m_size = 0;
+}
+
+}// namespace reactor
@@ -0,0 +1,391 @@
+#include "reactor/udpendpoint.h"
+#include "reactor/channel.h"
+#include "reactor/eventloop.h"
+#include "reactor/logging.h"
+#include "reactor/socket.h"
+#include <netinet/udp.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace reactor
+{
+
+// 一次可读事件最多接收的数据报数，持续到达的流量不会饿死同一 Loop 上的其他 Channel
+constexpr size_t kMaxDatagramsPerRead = 1024;
+
+// GRO 合并后上交的缓冲区最大 64KB
+constexpr size_t kGroBufferSize = 65536;
+
+// 单个 UDP 数据报的最大负载（IPv4）
+constexpr size_t kMaxUdpPayload = 65507;
+
+// GSO：每条消息最多的分段数（内核 UDP_MAX_SEGMENTS）和总字节数
+constexpr size_t kMaxGsoSegments = 64;
+constexpr size_t kMaxGsoBytes = 65000;
+
+constexpr size_t kRecvControlSize = CMSG_SPACE(sizeof(int));
+constexpr size_t kSendControlSize = CMSG_SPACE(sizeof(uint16_t));
+
+namespace details
+{
+
+int createUdpSocketOrDie(sa_family_t family)
+{
+    int sockfd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+    if(sockfd < 0)
+    {
+        LOG_SYSFATAL << "createUdpSocketOrDie";
+    }
+    return sockfd;
+}
+
+}// namespace details
+
+UdpEndpoint::UdpEndpoint(EventLoop* loop, const InetAddress& bindAddr, std::string name, const UdpOptions& options)
+    : m_loop(loop),
+      m_name(std::move(name)),
+      m_options(options),
+      m_socket(std::make_unique<Socket>(details::createUdpSocketOrDie(bindAddr.family()))),
+      m_channel(std::make_unique<Channel>(loop, m_socket->fd())),
+      m_gro(false),
+      m_gso(false),
+      m_recvSlotSize(0),
+      m_sendHead(0),
+      m_flushScheduled(false),
+      m_lifeToken(std::make_shared<UdpEndpoint*>(this)),
+      m_datagramsReceived(0),
+      m_datagramsSent(0),
+      m_datagramsDropped(0),
+      m_recvSyscalls(0),
+      m_sendSyscalls(0)
+{
+    const int fd = m_socket->fd();
+    m_socket->setReuseAddr(true);
+    if(options.reusePort) m_socket->setReusePort(true);
+    if(options.socketBufferBytes > 0)
+    {
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &options.socketBufferBytes, sizeof options.socketBufferBytes);
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &options.socketBufferBytes, sizeof options.socketBufferBytes);
+    }
+    m_socket->bindAddress(bindAddr);
+
+    if(options.enableGro)
+    {
+        int on = 1;
+        m_gro = ::setsockopt(fd, SOL_UDP, UDP_GRO, &on, sizeof on) == 0;
+        if(!m_gro) LOG_WARN << "UdpEndpoint[" << m_name << "] UDP_GRO unavailable, falling back to plain batches";
+    }
+    if(options.enableGso)
+    {
+        // 能读取 UDP_SEGMENT 说明内核支持 GSO，分段大小随每条消息的控制消息给出
+        int size = 0;
+        socklen_t len = sizeof size;
+        m_gso = ::getsockopt(fd, SOL_UDP, UDP_SEGMENT, &size, &len) == 0;
+        if(!m_gso) LOG_WARN << "UdpEndpoint[" << m_name << "] UDP_SEGMENT unavailable, falling back to plain batches";
+    }
+
+    // 接收批次：每个消息一个固定大小的缓冲区、一个地址和一个控制消息缓冲区
+    const size_t batch = static_cast<size_t>(std::max(1, options.batchSize));
+    m_recvSlotSize = m_gro ? kGroBufferSize : options.maxDatagramSize;
+    m_recvBuffers.resize(batch * m_recvSlotSize);
+    m_recvMsgs.resize(batch);
+    m_recvIovecs.resize(batch);
+    m_recvAddrs.resize(batch);
+    m_recvControl.resize(m_gro ? batch * kRecvControlSize : 0);
+    for(size_t i = 0; i < batch; ++i)
+    {
+        m_recvIovecs[i].iov_base = &m_recvBuffers[i * m_recvSlotSize];
+        m_recvIovecs[i].iov_len = m_recvSlotSize;
+        struct msghdr& hdr = m_recvMsgs[i].msg_hdr;
+        std::memset(&hdr, 0, sizeof hdr);
+        hdr.msg_name = &m_recvAddrs[i];
+        hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        hdr.msg_iov = &m_recvIovecs[i];
+        hdr.msg_iovlen = 1;
+        if(m_gro)
+        {
+            hdr.msg_control = &m_recvControl[i * kRecvControlSize];
+            hdr.msg_controllen = kRecvControlSize;
+        }
+    }
+
+    m_sendMsgs.resize(batch);
+    m_sendIovecs.resize(batch);
+    m_sendMsgDatagrams.resize(batch);
+    m_sendControl.resize(batch * kSendControlSize);
+
+    m_channel->setReadCallback([this]() { handleRead(); });
+    m_channel->setWriteCallback([this]() { handleWrite(); });
+}
+
+UdpEndpoint::~UdpEndpoint()
+{
+    m_channel->disableAll();
+    m_channel->remove();
+}
+
+InetAddress UdpEndpoint::localAddress() const
+{
+    return Socket::getLocalAddr(m_socket->fd());
+}
+
+void UdpEndpoint::start()
+{
+    m_loop->assertInLoopThread();
+    if(!m_channel->isReading()) m_channel->enableReading();
+}
+
+void UdpEndpoint::handleRead()
+{
+    const int fd = m_socket->fd();
+    const unsigned int batch = static_cast<unsigned int>(m_recvMsgs.size());
+    for(size_t total = 0; total < kMaxDatagramsPerRead; total += batch)
+    {
+        ++m_recvSyscalls;
+        int n = ::recvmmsg(fd, m_recvMsgs.data(), batch, MSG_DONTWAIT, nullptr);
+        if(n < 0)
+        {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                LOG_SYSERR << "UdpEndpoint::handleRead() [" << m_name << "]";
+            }
+            return;
+        }
+
+        for(int i = 0; i < n; ++i)
+        {
+            struct msghdr& hdr = m_recvMsgs[i].msg_hdr;
+            if(hdr.msg_flags & MSG_TRUNC)
+            {
+                // 数据报比接收缓冲区大，内容不完整
+                ++m_datagramsDropped;
+            }
+            else
+            {
+                int segmentSize = 0;
+                if(m_gro)
+                {
+                    for(struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+                    {
+                        if(cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+                        {
+                            std::memcpy(&segmentSize, CMSG_DATA(cmsg), sizeof segmentSize);
+                        }
+                    }
+                }
+                deliver(static_cast<const char*>(m_recvIovecs[i].iov_base), m_recvMsgs[i].msg_len, segmentSize,
+                        InetAddress(m_recvAddrs[i]));
+            }
+
+            // 内核会改写这些字段，下次接收前恢复
+            hdr.msg_namelen = sizeof(struct sockaddr_in6);
+            hdr.msg_controllen = m_gro ? kRecvControlSize : 0;
+            hdr.msg_flags = 0;
+        }
+        if(static_cast<unsigned int>(n) < batch) return;
+    }
+}
+
+void UdpEndpoint::deliver(const char* data, size_t len, int segmentSize, const InetAddress& peer)
+{
+    if(segmentSize <= 0 || len <= static_cast<size_t>(segmentSize))
+    {
+        ++m_datagramsReceived;
+        if(m_datagramCallback) m_datagramCallback(data, len, peer);
+        return;
+    }
+
+    // GRO 合并的缓冲区按分段大小拆回原来的数据报，最后一段可以更短
+    const size_t segment = static_cast<size_t>(segmentSize);
+    for(size_t offset = 0; offset < len; offset += segment)
+    {
+        ++m_datagramsReceived;
+        if(m_datagramCallback) m_datagramCallback(data + offset, std::min(segment, len - offset), peer);
+    }
+}
+
+bool UdpEndpoint::sendTo(const void* data, size_t len, const InetAddress& peer)
+{
+    m_loop->assertInLoopThread();
+    if(m_sendQueue.size() - m_sendHead >= m_options.maxQueuedDatagrams || len > kMaxUdpPayload)
+    {
+        ++m_datagramsDropped;
+        return false;
+    }
+
+    OutgoingDatagram datagram;
+    datagram.offset = m_sendBuffer.size();
+    datagram.len = len;
+    std::memset(&datagram.peer, 0, sizeof datagram.peer);
+    datagram.peerLen = peer.getSockAddrLen();
+    std::memcpy(&datagram.peer, peer.getSockAddr(), datagram.peerLen);
+    const char* bytes = static_cast<const char*>(data);
+    m_sendBuffer.insert(m_sendBuffer.end(), bytes, bytes + len);
+    m_sendQueue.push_back(datagram);
+
+    if(m_channel->isWriting())
+    {
+        // 等可写事件
+    }
+    else if(m_loop->dispatching())
+    {
+        // 本轮结束时和同一轮的其他数据报一起发出
+        if(!m_flushScheduled)
+        {
+            m_flushScheduled = true;
+            m_loop->runAfterDispatch([token = std::weak_ptr<UdpEndpoint*>(m_lifeToken)]() {
+                if(auto self = token.lock())
+                {
+                    (*self)->m_flushScheduled = false;
+                    (*self)->flush();
+                }
+            });
+        }
+    }
+    else
+    {
+        flush();
+    }
+    return true;
+}
+
+void UdpEndpoint::flush()
+{
+    m_loop->assertInLoopThread();
+    if(sendQueued())
+    {
+        if(m_channel->isWriting()) m_channel->disableWriting();
+    }
+    else if(!m_channel->isWriting())
+    {
+        m_channel->enableWriting();
+    }
+}
+
+void UdpEndpoint::handleWrite()
+{
+    flush();
+}
+
+bool UdpEndpoint::sendQueued()
+{
+    const int fd = m_socket->fd();
+    while(m_sendHead < m_sendQueue.size())
+    {
+        const int count = buildSendBatch(m_sendHead);
+        ++m_sendSyscalls;
+        int n = ::sendmmsg(fd, m_sendMsgs.data(), static_cast<unsigned int>(count), MSG_DONTWAIT);
+        if(n < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                compactSendQueue();
+                return false;
+            }
+            if(errno == EINTR) continue;
+            if(m_gso && (errno == EIO || errno == EINVAL) && m_sendMsgDatagrams[0] > 1)
+            {
+                // 出口设备不支持分段卸载，之后按单个数据报发送
+                LOG_WARN << "UdpEndpoint[" << m_name << "] UDP_SEGMENT rejected, disabling GSO";
+                m_gso = false;
+                continue;
+            }
+            // 其他错误（例如之前的 ICMP 不可达留下的 ECONNREFUSED）只丢弃第一条消息，其余继续发送
+            LOG_SYSERR << "UdpEndpoint::sendQueued() [" << m_name << "]";
+            m_datagramsDropped += m_sendMsgDatagrams[0];
+            m_sendHead += m_sendMsgDatagrams[0];
+            continue;
+        }
+        for(int i = 0; i < n; ++i)
+        {
+            m_datagramsSent += m_sendMsgDatagrams[i];
+            m_sendHead += m_sendMsgDatagrams[i];
+        }
+    }
+
+    // 全部发出，复用缓冲区容量
+    m_sendQueue.clear();
+    m_sendBuffer.clear();
+    m_sendHead = 0;
+    return true;
+}
+
+void UdpEndpoint::compactSendQueue()
+{
+    // 已发出的部分超过一半时才搬移，剩余部分不多于已发出部分，均摊 O(1)；
+    // 否则持续部分发送时两个 vector 会一直增长（maxQueuedDatagrams 只限制未发出的数量）
+    if(m_sendHead == 0 || m_sendHead < m_sendQueue.size() / 2) return;
+
+    const size_t sentBytes = m_sendQueue[m_sendHead].offset;
+    m_sendBuffer.erase(m_sendBuffer.begin(), m_sendBuffer.begin() + static_cast<std::ptrdiff_t>(sentBytes));
+    m_sendQueue.erase(m_sendQueue.begin(), m_sendQueue.begin() + static_cast<std::ptrdiff_t>(m_sendHead));
+    for(OutgoingDatagram& datagram : m_sendQueue)
+    {
+        datagram.offset -= sentBytes;
+    }
+    m_sendHead = 0;
+}
+
+int UdpEndpoint::buildSendBatch(size_t first)
+{
+    int count = 0;
+    size_t index = first;
+    while(index < m_sendQueue.size() && static_cast<size_t>(count) < m_sendMsgs.size())
+    {
+        const OutgoingDatagram& datagram = m_sendQueue[index];
+        size_t segments = 1;
+        size_t bytes = datagram.len;
+        if(m_gso)
+        {
+            // 合并发往同一地址的后续数据报：长度相同，只有最后一个可以更短
+            while(index + segments < m_sendQueue.size() && segments < kMaxGsoSegments)
+            {
+                const OutgoingDatagram& next = m_sendQueue[index + segments];
+                if(next.len > datagram.len || next.len == 0 || bytes + next.len > kMaxGsoBytes ||
+                   next.peerLen != datagram.peerLen || std::memcmp(&next.peer, &datagram.peer, datagram.peerLen) != 0)
+                {
+                    break;
+                }
+                bytes += next.len;
+                ++segments;
+                if(next.len < datagram.len) break;
+            }
+        }
+
+        struct iovec& iov = m_sendIovecs[static_cast<size_t>(count)];
+        iov.iov_base = m_sendBuffer.data() + datagram.offset; // 末尾的空数据报 offset == size()
+        iov.iov_len = bytes;
+        struct msghdr& hdr = m_sendMsgs[static_cast<size_t>(count)].msg_hdr;
+        std::memset(&hdr, 0, sizeof hdr);
+        hdr.msg_name = const_cast<struct sockaddr_in6*>(&datagram.peer);
+        hdr.msg_namelen = datagram.peerLen;
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        if(segments > 1)
+        {
+            hdr.msg_control = &m_sendControl[static_cast<size_t>(count) * kSendControlSize];
+            hdr.msg_controllen = kSendControlSize;
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segmentSize = static_cast<uint16_t>(datagram.len);
+            std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof segmentSize);
+        }
+        m_sendMsgDatagrams[static_cast<size_t>(count)] = segments;
+        ++count;
+        index += segments;
+    }
+    return count;
+}
+
+}// namespace reactor
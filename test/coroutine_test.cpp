@@ -0,0 +1,224 @@
+#include "reactor/coroutine.h"
+#include "reactor/eventloop.h"
+#include "reactor/eventloopthread.h"
+#include "reactor/framepool.h"
+#include "reactor/currentthread.h"
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+using namespace reactor;
+
+// 协程接口需要 C++20，与 C++17 的 reactor_test 分开编译
+
+#define CHECK(cond)                                                              \
+    do                                                                           \
+    {                                                                            \
+        if (!(cond))                                                             \
+        {                                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                                        \
+        }                                                                        \
+    } while (0)
+
+static Task<int> addLater(int a, int b)
+{
+    co_await sleepFor(std::chrono::milliseconds(1));
+    co_return a + b;
+}
+
+static Task<int> failLater()
+{
+    co_await sleepFor(std::chrono::milliseconds(1));
+    throw std::runtime_error("boom");
+}
+
+// 协程参数按值保存在帧中；不要用带捕获的 lambda 协程，闭包对象在 spawn 返回后就销毁了
+
+struct SumResult
+{
+    int sum = 0;
+    bool caught = false;
+};
+
+static Task<> sumTask(EventLoop* loop, SumResult* result)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        result->sum += co_await addLater(i, 1);
+    }
+    try
+    {
+        co_await failLater();
+    }
+    catch (const std::runtime_error&)
+    {
+        result->caught = true;
+    }
+    loop->quit();
+}
+
+// Task 的返回值、异常传递，以及重复创建的协程帧来自 Loop 的 FramePool
+static void testTaskResultAndFramePool()
+{
+    EventLoop loop;
+    SumResult result;
+    spawn(&loop, sumTask(&loop, &result));
+    loop.loop();
+
+    CHECK(result.sum == 4950 + 100);
+    CHECK(result.caught);
+    // 外层帧加上每次 addLater 的帧；只有第一次需要从堆分配
+    FramePool* pool = loop.framePool();
+    CHECK(pool->hits() >= 100);
+    CHECK(pool->misses() <= 3);
+}
+
+static Task<> sleepTask(EventLoop* loop, MonoTime* resumed)
+{
+    co_await sleepFor(std::chrono::milliseconds(20), Nanoseconds::zero());
+    *resumed = MonoClock::now();
+    co_await sleepFor(Nanoseconds::zero()); // 已到期，不挂起
+    loop->quit();
+}
+
+// sleepFor 不早于指定时间恢复
+static void testSleepFor()
+{
+    EventLoop loop;
+    MonoTime begin = MonoClock::now();
+    MonoTime resumed;
+    spawn(&loop, sleepTask(&loop, &resumed));
+    loop.loop();
+    CHECK(resumed - begin >= std::chrono::milliseconds(20));
+}
+
+static Task<> readEventFd(EventLoop* loop, int efd, uint64_t* value)
+{
+    co_await readable(efd);
+    CHECK(::read(efd, value, sizeof *value) == sizeof *value);
+    loop->quit();
+}
+
+// readable(fd) 一次性等待：其他线程写 eventfd 后恢复，Channel 随后注销
+static void testReadableFd()
+{
+    EventLoop loop;
+    int efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    uint64_t value = 0;
+    spawn(&loop, readEventFd(&loop, efd, &value));
+    CHECK(loop.numChannels() == 3); // wakeupfd、timerfd 加上等待中的 eventfd
+
+    std::thread writer([efd] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t one = 7;
+        CHECK(::write(efd, &one, sizeof one) == sizeof one);
+    });
+    loop.loop();
+    writer.join();
+    CHECK(value == 7);
+    CHECK(loop.numChannels() == 2);
+    ::close(efd);
+}
+
+static Task<> echoServer(EventLoop* loop, int fd, bool* sawEof)
+{
+    AsyncFd conn(loop, fd);
+    char c;
+    while (true)
+    {
+        co_await conn.readable();
+        ssize_t n = ::read(fd, &c, 1);
+        if (n == 0)
+        {
+            *sawEof = true;
+            break;
+        }
+        if (n < 0) continue;
+        co_await conn.writable();
+        CHECK(::write(fd, &c, 1) == 1);
+    }
+    loop->quit();
+}
+
+static Task<> pingClient(EventLoop* loop, int fd, int rounds, int* pongs)
+{
+    AsyncFd conn(loop, fd);
+    char c = 'x';
+    for (int i = 0; i < rounds; ++i)
+    {
+        CHECK(::write(fd, &c, 1) == 1);
+        do
+        {
+            co_await conn.readable();
+        } while (::read(fd, &c, 1) != 1);
+        ++*pongs;
+    }
+    ::shutdown(fd, SHUT_WR);
+}
+
+// AsyncFd 上反复等待：两个协程通过 socketpair 做 ping-pong，对端关闭后读到 EOF
+static void testAsyncFdPingPong()
+{
+    constexpr int kRounds = 1000;
+    EventLoop loop;
+    int fds[2];
+    CHECK(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) == 0);
+
+    int pongs = 0;
+    bool sawEof = false;
+    spawn(&loop, echoServer(&loop, fds[1], &sawEof));
+    spawn(&loop, pingClient(&loop, fds[0], kRounds, &pongs));
+    loop.loop();
+
+    CHECK(pongs == kRounds);
+    CHECK(sawEof);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+struct HopResult
+{
+    pid_t otherTid = 0;
+    pid_t backTid = 0;
+};
+
+static Task<> hopTask(EventLoop* loop, EventLoop* other, HopResult* result)
+{
+    co_await resumeOn(other);
+    result->otherTid = tid();
+    co_await sleepFor(std::chrono::milliseconds(1)); // 在 other 的 TimerQueue 上等待
+    co_await resumeOn(loop);
+    result->backTid = tid();
+    loop->quit();
+}
+
+// resumeOn 在两个 Loop 线程之间切换
+static void testResumeOn()
+{
+    EventLoop loop;
+    EventLoopThread thread;
+    EventLoop* other = thread.startLoop();
+
+    HopResult result;
+    spawn(&loop, hopTask(&loop, other, &result));
+    loop.loop();
+
+    CHECK(result.otherTid != 0 && result.otherTid != tid());
+    CHECK(result.backTid == tid());
+}
+
+int main()
+{
+    testTaskResultAndFramePool();
+    testSleepFor();
+    testReadableFd();
+    testAsyncFdPingPong();
+    testResumeOn();
+    std::printf("all coroutine tests passed\n");
+    return 0;
+}
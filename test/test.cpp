@@ -0,0 +1,1344 @@
+#include "reactor/eventloop.h"
+#include "reactor/timestamp.h"
+#include "reactor/channel.h"
+#include "reactor/buffer.h"
+#include "reactor/tcpserver.h"
+#include "reactor/tcpconnection.h"
+#include "reactor/socket.h"
+#include "reactor/eventloopthreadpool.h"
+#include "reactor/cputopology.h"
+#include "reactor/histogram.h"
+#include "reactor/timerqueue.h"
+#include "reactor/pipepool.h"
+#include "reactor/udpendpoint.h"
+#include "reactor/computepool.h"
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "reactor/iouringpoller.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+
+using namespace reactor;
+
+// 统计当前线程的堆分配次数
+// 只在被测的 Loop 线程上开启，避免其他线程（日志后端、生产者）干扰结果
+namespace
+{
+thread_local bool t_countAllocs = false;
+thread_local size_t t_allocCount = 0;
+}
+
+void* operator new(size_t size)
+{
+    if (t_countAllocs)
+        ++t_allocCount;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+// noinline：避免 GCC 内联后把 free 和 operator new 配对，误报 -Wmismatched-new-delete
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+#define CHECK(cond)                                                              \
+    do                                                                           \
+    {                                                                            \
+        if (!(cond))                                                             \
+        {                                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                                        \
+        }                                                                        \
+    } while (0)
+
+// 预热后的 EventLoop::loop() 在稳定状态下不应有任何堆分配
+// 覆盖路径：重复定时器到期、短时 runAfter 的添加/到期/取消、
+//           跨线程 queueInLoop 唤醒、Loop 线程内 queueInLoop
+// 跨线程投递的生产者一侧也不应分配（任务节点由 Loop 归还复用）
+static void testSteadyStateLoopDoesNotAllocate()
+{
+    constexpr int kWarmupTicks = 100;
+    constexpr int kMeasuredTicks = 200;
+
+    EventLoop loop;
+    std::atomic<int> phase(0); // 0 预热，1 测量中，2 测量结束
+    std::atomic<int> remoteRuns(0);
+    int ticks = 0;
+    int localRuns = 0;
+    int timeouts = 0;
+    size_t allocsBefore = 0;
+    size_t allocsAfter = 0;
+
+    loop.runEvery(0.001, [&]() {
+        ++ticks;
+        loop.queueInLoop([&localRuns]() { ++localRuns; });
+        loop.runAfter(0.0002, [&timeouts]() { ++timeouts; });
+        TimerId cancelled = loop.runAfter(0.5, [&timeouts]() { ++timeouts; });
+        loop.cancel(cancelled);
+        if (ticks == kWarmupTicks)
+        {
+            allocsBefore = t_allocCount;
+            phase = 1;
+        }
+        else if (ticks == kWarmupTicks + kMeasuredTicks)
+        {
+            allocsAfter = t_allocCount;
+            phase = 2;
+            loop.quit();
+        }
+    });
+
+    size_t producerBefore = 0;
+    size_t producerAfter = 0;
+    std::thread producer([&]() {
+        t_countAllocs = true;
+        // 先突发投递一批，让流通的节点数覆盖调度抖动造成的在途峰值
+        for (int i = 0; i < 64; ++i)
+        {
+            loop.queueInLoop([&remoteRuns]() { remoteRuns.fetch_add(1); });
+        }
+        bool measuring = false;
+        while (true)
+        {
+            int now = phase.load();
+            if (now == 1 && !measuring)
+            {
+                producerBefore = t_allocCount;
+                measuring = true;
+            }
+            else if (now == 2)
+            {
+                producerAfter = t_allocCount;
+                break;
+            }
+            loop.queueInLoop([&remoteRuns]() { remoteRuns.fetch_add(1); });
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+    });
+
+    t_countAllocs = true;
+    loop.loop();
+    t_countAllocs = false;
+    producer.join();
+
+    std::printf("steady state: %d ticks, %d local tasks, %d remote tasks, %d timeouts, %zu allocations, %zu producer allocations\n",
+                kMeasuredTicks, localRuns, remoteRuns.load(), timeouts, allocsAfter - allocsBefore,
+                producerAfter - producerBefore);
+    CHECK(localRuns >= kWarmupTicks + kMeasuredTicks - 1);
+    CHECK(allocsAfter - allocsBefore == 0);
+    CHECK(producerAfter - producerBefore == 0);
+}
+
+// 时间轮后端：定时器不会提前触发、取消后不会触发、跨层级联正确
+static void testTimingWheelBackend()
+{
+    EventLoopOptions options;
+    options.timerBackend = TimerBackend::kTimingWheel;
+    options.timingWheelTickMicroseconds = 1000;
+    EventLoop loop(options);
+
+    const double delays[] = {0.0, 0.002, 0.05, 0.255, 0.3, 0.4};
+    int fired = 0;
+    bool early = false;
+    for (double delay : delays)
+    {
+        MonoTime deadline = MonoClock::now() + secondsToDuration(delay);
+        loop.runAfter(delay, [&, deadline]() {
+            if (MonoClock::now() < deadline) early = true;
+            ++fired;
+        });
+    }
+
+    bool cancelledFired = false;
+    TimerId cancelled = loop.runAfter(0.1, [&]() { cancelledFired = true; });
+    loop.cancel(cancelled);
+
+    int repeats = 0;
+    TimerId repeating = loop.runEvery(0.01, [&]() { ++repeats; });
+    loop.runAfter(0.45, [&]() {
+        loop.cancel(repeating);
+        loop.quit();
+    });
+    loop.loop();
+
+    std::printf("timing wheel: %d fired, %d repeats\n", fired, repeats);
+    CHECK(fired == static_cast<int>(sizeof delays / sizeof delays[0]));
+    CHECK(!early);
+    CHECK(!cancelledFired);
+    CHECK(repeats >= 30);
+}
+
+// 已到期/已取消的 TimerId 失效：再次取消是空操作，不会影响复用同一槽位的新定时器
+// 默认后端：chrono 间隔、单调到期时间，回调中的 loop.now() 不早于到期时间
+static void testMonotonicTimers()
+{
+    EventLoop loop;
+    MonoTime deadline = MonoClock::now() + std::chrono::milliseconds(5);
+    bool early = false;
+    int repeats = 0;
+    loop.runAt(deadline, [&]() {
+        if (loop.now() < deadline) early = true;
+    });
+    TimerId repeating = loop.runEvery(std::chrono::milliseconds(2), [&]() { ++repeats; });
+    loop.runAfter(std::chrono::milliseconds(30), [&]() {
+        loop.cancel(repeating);
+        loop.quit();
+    });
+    loop.loop();
+
+    std::printf("monotonic timers: %d repeats\n", repeats);
+    CHECK(!early);
+    CHECK(repeats >= 5);
+}
+
+// 定时器容差：相近的定时器合并为一次唤醒，并且不会提前触发
+static void testTimerSlack()
+{
+    EventLoop loop;
+    const TimerQueue* timers = loop.timerQueue();
+    MonoTime base = MonoClock::now() + std::chrono::milliseconds(2);
+    int fired = 0;
+    bool early = false;
+    for (int i = 0; i < 50; ++i)
+    {
+        MonoTime deadline = base + std::chrono::microseconds(20 * i);
+        loop.runAt(deadline, [&, deadline]() {
+            if (loop.now() < deadline) early = true;
+            ++fired;
+        }, std::chrono::milliseconds(5));
+    }
+    uint64_t settime = timers->syscalls();
+    loop.runAfter(std::chrono::milliseconds(20), [&]() { loop.quit(); });
+    loop.loop();
+
+    std::printf("timer slack: %d fired, %llu settime while adding, %llu wakeups\n", fired,
+                static_cast<unsigned long long>(settime), static_cast<unsigned long long>(timers->wakeups()));
+    CHECK(fired == 50);
+    CHECK(!early);
+    CHECK(settime == 1);
+    CHECK(timers->wakeups() <= 3);
+}
+
+static void testStaleTimerIdCancel()
+{
+    EventLoop loop;
+    TimerId first = loop.runAfter(0.001, []() {});
+    TimerId cancelledTwice = loop.runAfter(1.0, []() {});
+    loop.cancel(cancelledTwice);
+
+    bool secondFired = false;
+    loop.runAfter(0.01, [&]() {
+        // first 已经到期，槽位会被下面的新定时器复用
+        TimerId second = loop.runAfter(0.01, [&]() {
+            secondFired = true;
+            loop.quit();
+        });
+        CHECK(second.index() == first.index() || second.index() == cancelledTwice.index());
+        loop.cancel(first);
+        loop.cancel(cancelledTwice);
+    });
+    loop.loop();
+
+    std::printf("stale timer id: second fired=%d\n", secondFired);
+    CHECK(secondFired);
+}
+
+static void testEdgeTriggeredAndOneShotChannel()
+{
+    EventLoop loop;
+    int etPipe[2];
+    int osPipe[2];
+    CHECK(::pipe2(etPipe, O_NONBLOCK | O_CLOEXEC) == 0);
+    CHECK(::pipe2(osPipe, O_NONBLOCK | O_CLOEXEC) == 0);
+
+    // 边沿触发：每次只读1字节不读空，剩下的数据不会再触发
+    int etReads = 0;
+    Channel etChannel(&loop, etPipe[0]);
+    etChannel.setEdgeTriggered(true);
+    etChannel.setReadCallback([&]() {
+        char c;
+        CHECK(::read(etPipe[0], &c, 1) == 1);
+        ++etReads;
+    });
+    etChannel.enableReading();
+    CHECK(etChannel.isEdgeTriggered() && etChannel.isReading() && !etChannel.isWriting());
+
+    // 单次触发：不读数据，rearm 之前不会再触发
+    int osReads = 0;
+    Channel osChannel(&loop, osPipe[0]);
+    osChannel.setOneShot(true);
+    osChannel.setReadCallback([&]() {
+        ++osReads;
+        if(osReads == 2) loop.quit();
+    });
+    osChannel.enableReading();
+
+    CHECK(::write(etPipe[1], "ab", 2) == 2);
+    CHECK(::write(osPipe[1], "x", 1) == 1);
+
+    int etReadsBeforeWrite = -1;
+    int osReadsBeforeRearm = -1;
+    loop.runAfter(0.03, [&]() {
+        etReadsBeforeWrite = etReads;
+        osReadsBeforeRearm = osReads;
+        // 边沿触发下开关写事件不修改注册的事件
+        uint32_t registered = etChannel.registeredEvents();
+        etChannel.enableWriting();
+        etChannel.disableWriting();
+        CHECK(etChannel.registeredEvents() == registered);
+        CHECK(::write(etPipe[1], "c", 1) == 1);
+        osChannel.rearm();
+    });
+    loop.loop();
+
+    // 边沿触发下关闭读期间到达的数据：重新开启读之后仍然会通知
+    int sv[2];
+    CHECK(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0);
+    int toggledReads = 0;
+    Channel toggled(&loop, sv[0]);
+    toggled.setEdgeTriggered(true);
+    toggled.setReadCallback([&]() {
+        char c;
+        while(::read(sv[0], &c, 1) == 1) {}
+        ++toggledReads;
+        loop.quit();
+    });
+    toggled.setWriteCallback([]() {});
+    toggled.enableReading();
+    toggled.enableWriting();
+    int toggledReadsWhileOff = -1;
+    loop.runAfter(0.01, [&]() {
+        toggled.disableReading();
+        CHECK(::write(sv[1], "z", 1) == 1); // 这个边沿在关闭读期间被丢弃
+    });
+    loop.runAfter(0.03, [&]() {
+        toggledReadsWhileOff = toggledReads;
+        toggled.enableReading();
+    });
+    TimerId timeout = loop.runAfter(1.0, [&]() { loop.quit(); });
+    loop.loop();
+    loop.cancel(timeout);
+
+    std::printf("edge triggered: %d reads, one shot: %d reads, re-enabled read: %d reads\n",
+                etReads, osReads, toggledReads);
+    CHECK(etReadsBeforeWrite == 1);
+    CHECK(osReadsBeforeRearm == 1);
+    CHECK(osReads == 2);
+    CHECK(toggledReadsWhileOff == 0);
+    CHECK(toggledReads == 1);
+
+    toggled.disableAll();
+    toggled.remove();
+    ::close(sv[0]);
+    ::close(sv[1]);
+
+    etChannel.disableAll();
+    etChannel.remove();
+    osChannel.disableAll();
+    osChannel.remove();
+    ::close(etPipe[0]);
+    ::close(etPipe[1]);
+    ::close(osPipe[0]);
+    ::close(osPipe[1]);
+}
+
+static void testHighFdChannel()
+{
+    // fd 远大于 Poller 登记表的初始容量：登记表扩容后事件仍然分发到正确的 Channel
+    EventLoop loop;
+    int lowFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int highFd = ::fcntl(lowFd, F_DUPFD_CLOEXEC, 5000);
+    CHECK(highFd >= 5000);
+    int otherFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    int highReads = 0;
+    int otherReads = 0;
+    Channel highChannel(&loop, highFd);
+    highChannel.setReadCallback([&]() {
+        uint64_t value;
+        CHECK(::read(highFd, &value, sizeof value) == sizeof value);
+        ++highReads;
+        loop.quit();
+    });
+    Channel otherChannel(&loop, otherFd);
+    otherChannel.setReadCallback([&]() { ++otherReads; });
+    highChannel.enableReading();
+    otherChannel.enableReading();
+
+    uint64_t one = 1;
+    CHECK(::write(lowFd, &one, sizeof one) == sizeof one);
+    loop.loop();
+    CHECK(highReads == 1 && otherReads == 0);
+
+    // 注销后同一个 fd 可以重新注册
+    highChannel.disableAll();
+    highChannel.remove();
+    highChannel.enableReading();
+    CHECK(::write(lowFd, &one, sizeof one) == sizeof one);
+    loop.loop();
+    CHECK(highReads == 2);
+
+    highChannel.disableAll();
+    highChannel.remove();
+    otherChannel.disableAll();
+    otherChannel.remove();
+    ::close(highFd);
+    ::close(lowFd);
+    ::close(otherFd);
+}
+
+static void testIoUringBackend()
+{
+    EventLoopOptions options;
+    options.pollerBackend = PollerBackend::kIoUring;
+    EventLoop loop(options);
+    IoUringPoller* ring = loop.ioUring();
+    if(ring == nullptr)
+    {
+        std::printf("io_uring: unavailable, skipped\n");
+        return;
+    }
+
+    int readyPipe[2];
+    int ioPipe[2];
+    CHECK(::pipe2(readyPipe, O_NONBLOCK | O_CLOEXEC) == 0);
+    CHECK(::pipe2(ioPipe, O_CLOEXEC) == 0);
+
+    // 就绪通知保持水平触发：每次只读1字节，两个字节触发两次
+    int reads = 0;
+    Channel channel(&loop, readyPipe[0]);
+    channel.setReadCallback([&]() {
+        char c;
+        CHECK(::read(readyPipe[0], &c, 1) == 1);
+        ++reads;
+    });
+    channel.enableReading();
+    CHECK(::write(readyPipe[1], "ab", 2) == 2);
+
+    // 完成式读，使用注册的固定缓冲区
+    char buffer[16] = {0};
+    struct iovec iov = {buffer, sizeof buffer};
+    CHECK(ring->registerBuffers(&iov, 1));
+    int fixedRead = -1;
+    ring->submitReadFixed(ioPipe[0], buffer, sizeof buffer, 0, [&](int res) { fixedRead = res; });
+    int written = -1;
+    ring->submitWrite(ioPipe[1], "hello", 5, [&](int res) { written = res; });
+
+    loop.runAfter(0.03, [&]() { loop.quit(); });
+    loop.loop();
+
+    std::printf("io_uring: %d reads, write=%d fixed read=%d, %llu syscalls\n", reads, written, fixedRead,
+                static_cast<unsigned long long>(loop.poller()->syscalls()));
+    CHECK(reads == 2);
+    CHECK(written == 5);
+    CHECK(fixedRead == 5);
+    CHECK(std::string(buffer, 5) == "hello");
+
+    ring->unregisterBuffers();
+    channel.disableAll();
+    channel.remove();
+    ::close(readyPipe[0]);
+    ::close(readyPipe[1]);
+    ::close(ioPipe[0]);
+    ::close(ioPipe[1]);
+}
+
+// UniqueFunction：常见捕获不分配、可以保存只能移动的捕获、移动后源对象为空
+static void testUniqueFunction()
+{
+    std::string text(20, 'x'); // 超过 SSO，复制会分配
+    auto owner = std::make_shared<int>(7);
+    Functor small([owner, text]() {});
+    CHECK(small.isInline());
+
+    char big[128] = {};
+    Functor large([big]() { (void)big; });
+    CHECK(large && !large.isInline());
+
+    EventLoop loop;
+    auto payload = std::make_unique<int>(42);
+    int seen = 0;
+    loop.queueInLoop([&seen, p = std::move(payload)]() { seen = *p; });
+    Functor moved([&loop]() { loop.quit(); });
+    Functor target(std::move(moved));
+    CHECK(!moved && target);
+    loop.queueInLoop(std::move(target));
+    loop.loop();
+
+    std::printf("unique function: sizeof=%zu, move-only capture saw %d\n", sizeof(Functor), seen);
+    CHECK(seen == 42);
+}
+
+static void testBuffer()
+{
+    Buffer buf;
+    CHECK(buf.readableBytes() == 0);
+    CHECK(buf.writableBytes() == Buffer::kInitialSize);
+    CHECK(buf.prependableBytes() == Buffer::kCheapPrepend);
+
+    // 先写消息体再补长度头，不搬移数据
+    buf.append(std::string("hello"));
+    buf.prependInt32(5);
+    CHECK(buf.readableBytes() == 9);
+    CHECK(buf.readInt32() == 5);
+    CHECK(buf.retrieveAsString(5) == "hello");
+    CHECK(buf.prependableBytes() == Buffer::kCheapPrepend);
+
+    // 读过的空间足够时整理而不是扩容
+    std::string chunk(800, 'x');
+    buf.append(chunk);
+    buf.retrieve(700);
+    size_t capacity = buf.internalCapacity();
+    buf.append(chunk);
+    CHECK(buf.internalCapacity() == capacity);
+    CHECK(buf.readableBytes() == 900);
+    CHECK(buf.prependableBytes() == Buffer::kCheapPrepend);
+    buf.retrieveAll();
+
+    // 一次 readv 读入超过写空间的数据
+    int fds[2];
+    CHECK(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+    std::string payload(60000, 'y');
+    CHECK(::write(fds[1], payload.data(), payload.size()) == static_cast<ssize_t>(payload.size()));
+    int savedErrno = 0;
+    ssize_t n = buf.readFd(fds[0], &savedErrno);
+    CHECK(n == static_cast<ssize_t>(payload.size()));
+    CHECK(buf.retrieveAllAsString() == payload);
+    CHECK(buf.readFd(fds[0], &savedErrno) < 0 && savedErrno == EAGAIN);
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    std::printf("buffer: readFd read %zd bytes in one call\n", n);
+}
+
+// 阻塞地读满 len 字节
+static std::string readExactly(int fd, size_t len)
+{
+    std::string result;
+    char buf[256];
+    while(result.size() < len)
+    {
+        ssize_t n = ::read(fd, buf, std::min(sizeof buf, len - result.size()));
+        if(n <= 0) break;
+        result.append(buf, static_cast<size_t>(n));
+    }
+    return result;
+}
+
+static void testTcpServerEcho()
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "echo");
+    server.setThreadNum(2);
+
+    std::mutex mtx;
+    std::vector<TcpConnectionPtr> serverConns;
+    std::atomic<int> connected(0);
+    std::atomic<int> disconnected(0);
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if(conn->connected())
+        {
+            CHECK(conn->getLoop()->isInLoopThread());
+            std::lock_guard<std::mutex> lock(mtx);
+            serverConns.push_back(conn);
+            ++connected;
+        }
+        else
+        {
+            ++disconnected;
+        }
+    });
+    server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf) { conn->send(buf); });
+    server.start();
+    const uint16_t port = server.listenAddress().port();
+    CHECK(port != 0);
+
+    constexpr int kClients = 4;
+    bool clientOk = true;
+    std::thread client([&]() {
+        InetAddress serverAddr("127.0.0.1", port);
+        for(int i = 0; i < kClients; ++i)
+        {
+            int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if(::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) < 0)
+            {
+                clientOk = false;
+                ::close(fd);
+                continue;
+            }
+            while(connected.load() <= i) std::this_thread::yield();
+
+            // 跨线程 send：在客户端线程调用服务端连接的 send()
+            TcpConnectionPtr serverConn;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                serverConn = serverConns[static_cast<size_t>(i)];
+            }
+            serverConn->send(std::string("hi"));
+            clientOk = clientOk && readExactly(fd, 2) == "hi";
+
+            std::string message = "echo " + std::to_string(i);
+            clientOk = clientOk && ::write(fd, message.data(), message.size()) == static_cast<ssize_t>(message.size());
+            clientOk = clientOk && readExactly(fd, message.size()) == message;
+            ::close(fd);
+        }
+        while(disconnected.load() < kClients) std::this_thread::yield();
+        loop.queueInLoop([&loop]() { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+    serverConns.clear();
+
+    std::printf("tcp server: %d connected, %d disconnected\n", connected.load(), disconnected.load());
+    CHECK(clientOk);
+    CHECK(connected.load() == kClients);
+    CHECK(disconnected.load() == kClients);
+}
+
+// shutdown() 后对端还没关闭（kDisconnecting）时析构 TcpServer：连接应正常注销并回调断开
+static void testDestroyServerWhileDisconnecting()
+{
+    EventLoop loop;
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int connected = 0;
+    int disconnected = 0;
+    {
+        TcpServer server(&loop, InetAddress(0, true), "shutdown");
+        server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+            if(conn->connected())
+            {
+                ++connected;
+                conn->shutdown();
+                loop.quit();
+            }
+            else
+            {
+                ++disconnected;
+            }
+        });
+        server.start();
+        InetAddress serverAddr("127.0.0.1", server.listenAddress().port());
+        CHECK(::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) == 0);
+        loop.loop();
+        CHECK(connected == 1);
+        CHECK(disconnected == 0);
+    }
+    CHECK(disconnected == 1);
+    ::close(fd);
+}
+
+static void testSendFileAndForward()
+{
+    // 1MB 临时文件，内容可以逐字节校验
+    constexpr size_t kFileBytes = 1 << 20;
+    char path[] = "/tmp/reactor_sendfile_XXXXXX";
+    int fileFd = ::mkstemp(path);
+    CHECK(fileFd >= 0);
+    ::unlink(path);
+    std::string content(kFileBytes, '\0');
+    for(size_t i = 0; i < kFileBytes; ++i) content[i] = static_cast<char>('a' + i % 26 + i / 4096 % 7);
+    CHECK(::write(fileFd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "zerocopy");
+    std::vector<TcpConnectionPtr> conns;
+    std::atomic<bool> forwarding(false);
+    std::atomic<int> disconnected(0);
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if(!conn->connected())
+        {
+            ++disconnected;
+            return;
+        }
+        conns.push_back(conn);
+        if(conns.size() == 1)
+        {
+            // 文件区间与前后 send() 的数据按调用顺序到达
+            conn->send("HEAD");
+            conn->sendFile(fileFd, 100, kFileBytes - 200);
+            conn->send("TAIL");
+            conn->shutdown();
+        }
+        else if(conns.size() == 3)
+        {
+            conns[1]->forwardTo(conns[2]);
+            forwarding = true;
+        }
+    });
+    server.start();
+
+    const uint16_t port = server.listenAddress().port();
+    bool fileOk = false;
+    bool forwardOk = false;
+    std::thread client([&]() {
+        InetAddress serverAddr("127.0.0.1", port);
+        auto connectServer = [&serverAddr]() {
+            int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            CHECK(::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) == 0);
+            return fd;
+        };
+
+        int fileConn = connectServer();
+        std::string expected = "HEAD" + content.substr(100, kFileBytes - 200) + "TAIL";
+        fileOk = readExactly(fileConn, expected.size() + 1) == expected;
+        ::close(fileConn);
+
+        // 代理：写入 source 的数据经 splice 原样从 sink 读出，source 关闭后 sink 收到 EOF
+        int source = connectServer();
+        int sink = connectServer();
+        while(!forwarding.load()) std::this_thread::yield();
+        std::thread writer([&]() {
+            size_t written = 0;
+            while(written < content.size())
+            {
+                ssize_t n = ::write(source, content.data() + written, content.size() - written);
+                if(n <= 0) break;
+                written += static_cast<size_t>(n);
+            }
+            ::close(source);
+        });
+        forwardOk = readExactly(sink, content.size() + 1) == content;
+        writer.join();
+        ::close(sink);
+
+        while(disconnected.load() < 3) std::this_thread::yield();
+        loop.queueInLoop([&loop]() { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+    conns.clear();
+    ::close(fileFd);
+
+    std::printf("zero copy: sendfile %s, splice forward %s, pipes created %zu\n",
+                fileOk ? "ok" : "FAILED", forwardOk ? "ok" : "FAILED", loop.pipePool()->created());
+    CHECK(fileOk);
+    CHECK(forwardOk);
+    CHECK(loop.pipePool()->created() == 1 && loop.pipePool()->idle() == 1);
+}
+
+static void testDeferredSend()
+{
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(0, true), "deferred");
+    TcpConnectionPtr serverConn;
+    int messages = 0;
+    bool deferredOk = true;
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if(conn->connected()) serverConn = conn;
+    });
+    server.setMessageCallback([&](const TcpConnectionPtr& conn, Buffer* buf) {
+        ++messages;
+        // 流水线请求：每个字节一个响应，本轮内只进输出缓冲区，没有写系统调用
+        uint64_t syscallsBefore = conn->writeSyscalls();
+        std::string request = buf->retrieveAllAsString();
+        for(char c : request)
+        {
+            if(c == '!')
+            {
+                conn->send("bye");
+                conn->shutdown(); // 延迟发送的数据写出后才关闭写端
+            }
+            else
+            {
+                conn->send(std::string(1, static_cast<char>(c - 'a' + 'A')));
+            }
+        }
+        deferredOk = deferredOk && conn->writeSyscalls() == syscallsBefore && conn->outputBytes() > 0;
+    });
+    server.start();
+    const uint16_t port = server.listenAddress().port();
+
+    bool clientOk = false;
+    std::thread client([&]() {
+        InetAddress serverAddr("127.0.0.1", port);
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        CHECK(::connect(fd, serverAddr.getSockAddr(), serverAddr.getSockAddrLen()) == 0);
+        CHECK(::write(fd, "abcdefghij", 10) == 10);
+        clientOk = readExactly(fd, 10) == "ABCDEFGHIJ";
+        CHECK(::write(fd, "!", 1) == 1);
+        clientOk = clientOk && readExactly(fd, 4) == "bye";
+        ::close(fd);
+        loop.queueInLoop([&loop]() { loop.quit(); });
+    });
+    loop.loop();
+    client.join();
+
+    std::printf("deferred send: %d messages, %llu write syscalls\n", messages,
+                static_cast<unsigned long long>(serverConn->writeSyscalls()));
+    CHECK(clientOk);
+    CHECK(deferredOk);
+    // 每次消息回调产生的全部响应一次写出
+    CHECK(serverConn->writeSyscalls() == static_cast<uint64_t>(messages));
+    serverConn.reset();
+}
+
+static void testUdpEndpoint()
+{
+    EventLoop loop;
+    UdpOptions receiverOptions;
+    receiverOptions.enableGro = true;
+    UdpEndpoint receiver(&loop, InetAddress(0, true), "udp-rx", receiverOptions);
+
+    UdpOptions batchOptions;
+    batchOptions.batchSize = 16;
+    UdpEndpoint batchSender(&loop, InetAddress(0, true), "udp-batch", batchOptions);
+    UdpOptions gsoOptions;
+    gsoOptions.enableGso = true;
+    UdpEndpoint gsoSender(&loop, InetAddress(0, true), "udp-gso", gsoOptions);
+
+    // 每个发送端发 kDatagrams 个 64 字节数据报，最后一个更短；内容带序号，按发送顺序到达
+    constexpr int kDatagrams = 100;
+    const InetAddress target("127.0.0.1", receiver.localAddress().port());
+    const uint16_t gsoPort = gsoSender.localAddress().port();
+    int received[2] = {0, 0};
+    bool inOrder = true;
+    receiver.setDatagramCallback([&](const char* data, size_t len, const InetAddress& peer) {
+        int& count = received[peer.port() == gsoPort ? 1 : 0];
+        char expected[64];
+        std::snprintf(expected, sizeof expected, "%063d", count);
+        size_t expectedLen = count == kDatagrams - 1 ? 10 : 64;
+        inOrder = inOrder && len == expectedLen && std::memcmp(data, expected, len) == 0;
+        ++count;
+        if(received[0] == kDatagrams && received[1] == kDatagrams) loop.quit();
+    });
+    receiver.start();
+
+    loop.queueInLoop([&]() {
+        for(int i = 0; i < kDatagrams; ++i)
+        {
+            char payload[64];
+            std::snprintf(payload, sizeof payload, "%063d", i);
+            size_t len = i == kDatagrams - 1 ? 10 : 64;
+            CHECK(batchSender.sendTo(payload, len, target));
+            CHECK(gsoSender.sendTo(payload, len, target));
+        }
+        // 本轮结束时才发出
+        CHECK(batchSender.sendSyscalls() == 0 && gsoSender.sendSyscalls() == 0);
+    });
+    loop.runAfter(2.0, [&loop]() { loop.quit(); });
+    loop.loop();
+
+    std::printf("udp: received %d/%d, batch sender %llu sendmmsg, gso(%d) sender %llu sendmmsg, "
+                "receiver %llu recvmmsg (gro %d)\n",
+                received[0], received[1], static_cast<unsigned long long>(batchSender.sendSyscalls()),
+                gsoSender.gsoEnabled(), static_cast<unsigned long long>(gsoSender.sendSyscalls()),
+                static_cast<unsigned long long>(receiver.recvSyscalls()), receiver.groEnabled());
+    CHECK(received[0] == kDatagrams && received[1] == kDatagrams);
+    CHECK(inOrder);
+    CHECK(batchSender.datagramsSent() == kDatagrams && batchSender.sendSyscalls() <= (kDatagrams + 15) / 16);
+    CHECK(gsoSender.datagramsSent() == kDatagrams && gsoSender.sendSyscalls() <= 4);
+    CHECK(receiver.datagramsReceived() == 2 * kDatagrams && receiver.datagramsDropped() == 0);
+}
+
+static void testLoadBalance()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(3);
+    pool.setLoadBalance(LoadBalance::kLeastChannels);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    // 在前两个 Loop 上各注册一个 Channel
+    std::vector<std::unique_ptr<Channel>> channels(2);
+    std::vector<int> fds(2);
+    for(size_t i = 0; i < 2; ++i)
+    {
+        fds[i] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        std::atomic<bool> done(false);
+        loops[i]->runInLoop([&, i]() {
+            channels[i] = std::make_unique<Channel>(loops[i], fds[i]);
+            channels[i]->enableReading();
+            done = true;
+        });
+        while(!done.load()) std::this_thread::yield();
+    }
+    CHECK(loops[0]->numChannels() == loops[2]->numChannels() + 1);
+
+    bool leastOk = pool.getNextLoop() == loops[2];
+
+    // 哈希选择与策略无关，同一个 key 总是同一个 Loop
+    bool hashOk = pool.getLoopForHash(42) == pool.getLoopForHash(42) &&
+                  pool.getLoopForHash(1) != pool.getLoopForHash(2);
+
+    for(size_t i = 0; i < 2; ++i)
+    {
+        std::atomic<bool> done(false);
+        loops[i]->runInLoop([&, i]() {
+            channels[i]->disableAll();
+            channels[i]->remove();
+            channels[i].reset();
+            done = true;
+        });
+        while(!done.load()) std::this_thread::yield();
+        ::close(fds[i]);
+    }
+
+    std::printf("load balance: least channels=%d hash=%d\n", leastOk, hashOk);
+    CHECK(leastOk);
+    CHECK(hashOk);
+}
+
+// 运行时增加和退役 Loop：退役中的 Loop 不再被选中，Channel 关闭后线程退出，空出的下标被复用
+static void testPoolResize()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(2);
+    pool.start();
+    EventLoop* added = pool.addLoop();
+    CHECK(pool.numLoops() == 3);
+
+    // 在新加入的 Loop 上注册一个 Channel，退役开始时由回调关闭它
+    int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    std::unique_ptr<Channel> channel;
+    std::atomic<bool> registered(false);
+    added->runInLoop([&]() {
+        channel = std::make_unique<Channel>(added, fd);
+        channel->enableReading();
+        registered = true;
+    });
+    while(!registered.load()) std::this_thread::yield();
+
+    std::atomic<bool> retiringInLoop(false);
+    EventLoop* retired = nullptr;
+    pool.setRetiringCallback([&](EventLoop* loop) {
+        retiringInLoop = loop->isInLoopThread();
+        // 模拟连接稍后才关闭
+        loop->runAfter(0.05, [&]() {
+            channel->disableAll();
+            channel->remove();
+            channel.reset();
+        });
+    });
+    pool.setRetiredCallback([&](EventLoop* loop) {
+        retired = loop;
+        baseLoop.quit();
+    });
+    CHECK(pool.retireLoop());
+    CHECK(!pool.retireLoop(added)); // 已经在退役
+    CHECK(pool.numLoops() == 2 && pool.numRetiring() == 1);
+
+    bool neverPicked = true;
+    for(int i = 0; i < 10; ++i)
+    {
+        neverPicked = neverPicked && pool.getNextLoop() != added && pool.getLoopForHash(i) != added;
+    }
+    baseLoop.runAfter(5.0, [&]() { baseLoop.quit(); });
+    baseLoop.loop();
+    ::close(fd);
+
+    std::printf("pool resize: retired=%d retiringInLoop=%d\n", retired == added, retiringInLoop.load());
+    CHECK(neverPicked);
+    CHECK(retiringInLoop.load());
+    CHECK(retired == added);
+    CHECK(pool.numRetiring() == 0);
+    CHECK(pool.getAllLoops().size() == 2);
+    CHECK(pool.addLoop() != nullptr && pool.numLoops() == 3);
+}
+
+// 自动扩缩容：空闲时缩到 minThreads，唯一的 Loop 持续忙碌时扩容
+static void testAutoscale()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(3);
+    AutoscaleOptions options;
+    options.minThreads = 1;
+    options.maxThreads = 2;
+    options.interval = std::chrono::milliseconds(20);
+    options.stableIntervals = 2;
+    pool.enableAutoscale(options);
+    pool.start();
+
+    auto runUntil = [&](const std::function<bool()>& done) {
+        TimerId check = baseLoop.runEvery(std::chrono::milliseconds(10), [&]() {
+            if(done()) baseLoop.quit();
+        });
+        TimerId timeout = baseLoop.runAfter(10.0, [&]() { baseLoop.quit(); });
+        baseLoop.loop();
+        baseLoop.cancel(check);
+        baseLoop.cancel(timeout);
+    };
+    runUntil([&]() { return pool.numLoops() == 1 && pool.numRetiring() == 0; });
+    const int shrunk = pool.numLoops();
+
+    // 让剩下的 Loop 忙碌：每个任务占用 5ms 后重新投递自己
+    EventLoop* busy = pool.getAllLoops()[0];
+    std::atomic<bool> stop(false);
+    std::function<void()> spin = [&]() {
+        MonoTime end = MonoClock::now() + std::chrono::milliseconds(5);
+        while(MonoClock::now() < end) {}
+        if(!stop.load()) busy->queueInLoop([&]() { spin(); });
+    };
+    busy->queueInLoop([&]() { spin(); });
+    runUntil([&]() { return pool.numLoops() == 2; });
+    const int grown = pool.numLoops();
+    stop = true;
+    pool.disableAutoscale();
+    // 等正在执行的 spin 结束，之后不会再重新投递
+    std::atomic<bool> drained(false);
+    busy->queueInLoop([&]() { drained = true; });
+    while(!drained.load()) std::this_thread::yield();
+
+    std::printf("autoscale: shrunk to %d, grew to %d\n", shrunk, grown);
+    CHECK(shrunk == 1);
+    CHECK(grown == 2);
+}
+
+// 批量投递保持顺序；broadcastWithBarrier 在所有 Loop 执行完后打开
+static void testBroadcast()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(3);
+    pool.start();
+
+    std::mutex mtx;
+    std::vector<std::pair<pid_t, int>> order;
+    std::vector<SharedFunctor> tasks;
+    for (int i = 0; i < 5; ++i)
+    {
+        tasks.push_back([&, i]() {
+            std::lock_guard<std::mutex> lock(mtx);
+            order.emplace_back(tid(), i);
+        });
+    }
+    pool.broadcastBatch(tasks);
+
+    std::atomic<int> visited(0);
+    std::shared_ptr<CountDownLatch> barrier = pool.broadcastWithBarrier([&visited]() { ++visited; });
+    bool opened = barrier->waitFor(std::chrono::seconds(5));
+
+    // 每个 Loop 内按 0..4 顺序执行
+    bool ordered = order.size() == 15;
+    for (size_t i = 0; ordered && i < order.size(); ++i)
+    {
+        int expected = 0;
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (order[j].first == order[i].first) ++expected;
+        }
+        ordered = order[i].second == expected;
+    }
+
+    std::printf("broadcast: %zu batch tasks ran, barrier=%d visited=%d\n", order.size(), opened, visited.load());
+    CHECK(opened);
+    CHECK(visited.load() == 3);
+    CHECK(ordered);
+}
+
+// 退役过程中另一个线程不停地 broadcast：屏障总能打开，Loop 退出前执行完所有投递到它的任务
+static void testRetireWhileBroadcasting()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(2);
+    pool.start();
+
+    std::atomic<bool> retired(false);
+    std::atomic<bool> stop(false);
+    std::atomic<long> ran(0);
+    long barriers = 0;
+    bool allOpened = true;
+    std::thread broadcaster([&]() {
+        while(!stop.load())
+        {
+            pool.broadcast([&ran]() { ++ran; });
+            (void)pool.metricsSnapshot();
+            std::shared_ptr<CountDownLatch> barrier = pool.broadcastWithBarrier([]() {});
+            allOpened = allOpened && barrier->waitFor(std::chrono::seconds(5));
+            ++barriers;
+        }
+    });
+
+    // 退役完成后再广播一会儿，覆盖 Loop 销毁之后的投递
+    pool.setRetiredCallback([&](EventLoop*) {
+        retired = true;
+        baseLoop.runAfter(0.02, [&]() { baseLoop.quit(); });
+    });
+    baseLoop.runAfter(0.02, [&]() { CHECK(pool.retireLoop()); });
+    TimerId timeout = baseLoop.runAfter(10.0, [&]() { baseLoop.quit(); });
+    baseLoop.loop();
+    baseLoop.cancel(timeout);
+    stop = true;
+    broadcaster.join();
+    // 剩下的 Loop 上可能还有最后一轮 broadcast 的任务
+    pool.broadcastWithBarrier([]() {})->wait();
+
+    std::printf("retire while broadcasting: retired=%d, %ld barriers, %ld broadcast tasks ran\n",
+                retired.load(), barriers, ran.load());
+    CHECK(retired.load());
+    CHECK(allOpened);
+    CHECK(barriers > 0);
+    CHECK(pool.numLoops() == 1 && pool.numRetiring() == 0);
+}
+
+// 退役时 Loop 上还有 offload 在计算：等 continuation 回到该 Loop 执行完之后才退出
+static void testRetireDuringOffload()
+{
+    ComputePool compute("retire");
+    compute.setThreadNum(1);
+    compute.start();
+
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(2);
+    pool.setComputePool(&compute);
+    pool.start();
+    EventLoop* victim = pool.getAllLoops().back();
+
+    std::atomic<bool> retired(false);
+    std::atomic<bool> continuationRan(false);
+    std::atomic<bool> ranBeforeRetired(false);
+    std::atomic<bool> ranInVictim(false);
+    pool.setRetiredCallback([&](EventLoop* loop) {
+        retired = loop == victim;
+        baseLoop.quit();
+    });
+    baseLoop.runInLoop([&]() {
+        victim->offload(
+            []() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                return 42;
+            },
+            [&](int value) {
+                ranInVictim = victim->isInLoopThread() && value == 42;
+                ranBeforeRetired = !retired.load();
+                continuationRan = true;
+            });
+        CHECK(pool.retireLoop(victim));
+    });
+    TimerId timeout = baseLoop.runAfter(10.0, [&]() { baseLoop.quit(); });
+    baseLoop.loop();
+    baseLoop.cancel(timeout);
+
+    std::printf("retire during offload: retired=%d continuation=%d\n", retired.load(), continuationRan.load());
+    CHECK(retired.load());
+    CHECK(continuationRan.load());
+    CHECK(ranInVictim.load());
+    CHECK(ranBeforeRetired.load());
+    CHECK(pool.numLoops() == 1 && pool.numRetiring() == 0);
+}
+
+// offload：计算在 ComputePool 线程执行，续延回到发起的 Loop 线程；
+// 工作线程中提交的子任务可以被其他线程窃取
+static void testComputeOffload()
+{
+    constexpr int kJobs = 200;
+    ComputePool compute("test");
+    compute.setThreadNum(3);
+    compute.start();
+
+    EventLoop loop;
+    loop.setComputePool(&compute);
+    const pid_t loopTid = tid();
+    std::atomic<int> offLoop(0);
+    int results = 0;
+    long sum = 0;
+    bool continuationsInLoop = true;
+    for (int i = 0; i < kJobs; ++i)
+    {
+        loop.offload(
+            [&offLoop, loopTid, i]() {
+                if (tid() != loopTid) ++offLoop;
+                return static_cast<long>(i) * i;
+            },
+            [&, i](long square) {
+                continuationsInLoop = continuationsInLoop && loop.isInLoopThread();
+                CHECK(square == static_cast<long>(i) * i);
+                sum += square;
+                if (++results == kJobs + 1) loop.quit();
+            });
+    }
+    bool voidRan = false;
+    loop.offload([&compute]() {
+        // 从工作线程提交到自己的队列，其他空闲线程窃取
+        for (int i = 0; i < 64; ++i)
+        {
+            compute.submit([]() { std::this_thread::sleep_for(std::chrono::microseconds(200)); });
+        }
+    }, [&]() {
+        voidRan = true;
+        if (++results == kJobs + 1) loop.quit();
+    });
+    loop.loop();
+    compute.stop(); // 执行完已提交的子任务
+
+    std::printf("offload: %d results, executed=%llu stolen=%llu\n", results,
+                static_cast<unsigned long long>(compute.executedTasks()),
+                static_cast<unsigned long long>(compute.stolenTasks()));
+    CHECK(offLoop.load() == kJobs);
+    CHECK(continuationsInLoop);
+    CHECK(voidRan);
+    CHECK(sum == static_cast<long>(kJobs - 1) * kJobs * (2 * kJobs - 1) / 6);
+    CHECK(compute.executedTasks() == kJobs + 1 + 64);
+    CHECK(compute.stolenTasks() > 0);
+    CHECK(compute.pendingTasks() == 0);
+}
+
+// 只让池中的第二个 Loop 忙轮询：它在阻塞之前会反复非阻塞 poll，任务和定时器照常执行
+static void testBusyPoll()
+{
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(2);
+    EventLoopOptions spinning;
+    spinning.busyPollMicroseconds = 2000;
+    pool.setLoopOptions(1, spinning);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    std::atomic<int> done(0);
+    for (EventLoop* loop : loops)
+    {
+        loop->runAfter(std::chrono::milliseconds(5), [&done]() { ++done; });
+        loop->queueInLoop([&done]() { ++done; });
+    }
+    while (done.load() < 4) std::this_thread::yield();
+
+    uint64_t syscalls[2] = {0, 0};
+    for (size_t i = 0; i < 2; ++i)
+    {
+        std::atomic<bool> read(false);
+        loops[i]->runInLoop([&, i]() {
+            syscalls[i] = loops[i]->poller()->syscalls();
+            read = true;
+        });
+        while (!read.load()) std::this_thread::yield();
+    }
+
+    std::printf("busy poll: blocking loop %llu polls, spinning loop %llu polls\n",
+                static_cast<unsigned long long>(syscalls[0]), static_cast<unsigned long long>(syscalls[1]));
+    CHECK(syscalls[1] > syscalls[0] + 10);
+}
+
+static void testCpuPlacement()
+{
+    CHECK((CpuTopology::parseCpuList("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    CHECK(CpuTopology::parseCpuList("").empty());
+
+    std::vector<int> allowed = CpuTopology::allowedCpus();
+    CHECK(!allowed.empty());
+    CHECK(CpuTopology::availableCpus() >= 1);
+    CHECK(!CpuTopology::physicalCores().empty());
+
+    // 显式绑定到最后一个允许的 CPU，在 Loop 线程中检查亲和性
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    CpuPlacementPolicy policy;
+    policy.mode = CpuPlacement::kExplicit;
+    policy.cpus = {allowed.back()};
+    pool.setCpuPlacement(policy);
+    pool.setThreadNum(EventLoopThreadPool::kAutoThreadNum);
+    pool.start();
+
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+    CHECK(static_cast<int>(loops.size()) == CpuTopology::availableCpus());
+    std::atomic<int> pinnedCpus(-1);
+    std::atomic<bool> done(false);
+    loops[0]->runInLoop([&]() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        ::sched_getaffinity(0, sizeof set, &set);
+        pinnedCpus = CPU_ISSET(allowed.back(), &set) ? CPU_COUNT(&set) : 0;
+        done = true;
+    });
+    while(!done.load()) std::this_thread::yield();
+
+    std::printf("cpu placement: %zu allowed, %d available, pinned to %d cpu(s)\n", allowed.size(),
+                CpuTopology::availableCpus(), pinnedCpus.load());
+    CHECK(pinnedCpus.load() == 1);
+}
+
+static void testLoopMetrics()
+{
+    // 分桶误差：任意值所在桶的上界不小于它，且相对误差不超过 1/16
+    Histogram hist;
+    for(uint64_t v = 1; v <= 10000; ++v) hist.record(v);
+    HistogramSnapshot snap = hist.snapshot();
+    CHECK(snap.count == 10000 && snap.min == 1 && snap.max == 10000);
+    uint64_t p50 = snap.percentile(0.50);
+    uint64_t p99 = snap.percentile(0.99);
+    CHECK(p50 >= 5000 && p50 <= 5000 + 5000 / 16);
+    CHECK(p99 >= 9900 && p99 <= 9900 + 9900 / 16);
+    CHECK(Histogram::bucketUpperBound(Histogram::bucketOf(UINT64_MAX)) == UINT64_MAX);
+
+    EventLoop baseLoop;
+    EventLoopThreadPool pool(&baseLoop);
+    pool.setThreadNum(2);
+    EventLoopOptions options;
+    options.enableMetrics = true;
+    pool.setLoopOptions(options);
+    pool.start();
+    std::vector<EventLoop*> loops = pool.getAllLoops();
+
+    std::atomic<int> fired(0);
+    for(EventLoop* loop : loops)
+    {
+        for(int i = 0; i < 10; ++i) loop->queueInLoop([&fired]() { ++fired; });
+        loop->runAfter(0.001, [&fired]() { ++fired; });
+    }
+    while(fired.load() < 22) std::this_thread::yield();
+
+    PoolMetricsSnapshot metrics = pool.metricsSnapshot();
+    CHECK(metrics.loops.size() == 2);
+    // 排队延迟按 1/16 采样：每个 Loop 至少有第一个任务被采样
+    CHECK(metrics.total.taskLatencyNs.count >= 2 && metrics.total.taskLatencyNs.count < 22);
+    CHECK(metrics.total.timerLatenessNs.count == 2);
+    CHECK(metrics.total.pollWaitNs.count > 0);
+    CHECK(metrics.total.eventsPerPoll.max >= 1);
+    CHECK(metrics.loops[0].threadId != metrics.loops[1].threadId);
+    std::printf("loop metrics:\n%s", metrics.total.toString().c_str());
+}
+
+int main()
+{
+    testSteadyStateLoopDoesNotAllocate();
+    testTimingWheelBackend();
+    testMonotonicTimers();
+    testTimerSlack();
+    testStaleTimerIdCancel();
+    testEdgeTriggeredAndOneShotChannel();
+    testHighFdChannel();
+    testIoUringBackend();
+    testUniqueFunction();
+    testBuffer();
+    testTcpServerEcho();
+    testDestroyServerWhileDisconnecting();
+    testSendFileAndForward();
+    testDeferredSend();
+    testUdpEndpoint();
+    testLoadBalance();
+    testBroadcast();
+    testComputeOffload();
+    testPoolResize();
+    testRetireWhileBroadcasting();
+    testRetireDuringOffload();
+    testAutoscale();
+    testBusyPoll();
+    testCpuPlacement();
+    testLoopMetrics();
+    std::printf("all tests passed\n");
+    return 0;
+}